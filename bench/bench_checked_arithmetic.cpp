@@ -0,0 +1,309 @@
+/***********************************************************
+//              copyright Qingfeng Xia, 2020
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+************************************************************/
+
+/**
+* micro-benchmark of the checked arithmetic, without external dependency
+*
+* For each integer type, `out[i] = a[i] op b[i]` is computed by the unchecked operator
+* (the baseline), `std::checked_add/sub/mul`, `+=` etc. of `std::checked<T>`, and
+* `boost::safe_numerics::safe<T>` as in
+* examples/demo_boost_safe_numerics.cpp if Boost is found and the standard is C++14.
+* The operands are small enough that no operation overflows.
+* The reductions `std::checked_reduce_sum` and `std::checked_dot` are compared with a plain loop
+* accumulating in T, which may wrap silently.
+* The best of several repetitions is reported as JSON, in ns and TSC cycles per element.
+*
+* usage: bench_checked_arithmetic [--quick] [--out result.json]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../checked_arithmetic.h"
+#include "../checked_arithmetic_bulk.h"
+
+#if USE_BOOST_SAFE_NUMERICS
+#include <boost/safe_numerics/safe_integer.hpp>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/// the time stamp counter, counting at the nominal frequency, 0 if there is none
+inline uint64_t read_cycles()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/// keep the output of the measured loop alive
+inline void do_not_optimize(const void* p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(p) : "memory");
+#else
+    static const void* volatile sink;
+    sink = p;
+#endif
+}
+
+template <typename T> struct bench_type_name;
+#define BENCH_TYPE_NAME(type)                    \
+    template <> struct bench_type_name<type>     \
+    {                                            \
+        static const char* name() { return #type; } \
+    };
+BENCH_TYPE_NAME(int32_t)
+BENCH_TYPE_NAME(uint32_t)
+BENCH_TYPE_NAME(int64_t)
+BENCH_TYPE_NAME(uint64_t)
+#undef BENCH_TYPE_NAME
+
+struct bench_config
+{
+    size_t elements;
+    size_t repeat;
+};
+
+struct bench_result
+{
+    std::string name;
+    std::string operation;
+    std::string type;
+    double ns_per_element;
+    double cycles_per_element;
+};
+
+/// operands below 2^(digits / 2 - 1), no sum, difference of a larger a, or product overflows
+template <typename T>
+void make_input(size_t n, std::vector<T>& a, std::vector<T>& b)
+{
+    const T limit = static_cast<T>(T(1) << (std::numeric_limits<T>::digits / 2 - 1));
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<T> uniform(0, limit);
+    a.resize(n);
+    b.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        b[i] = uniform(random);
+        a[i] = static_cast<T>(b[i] + uniform(random));
+    }
+}
+
+/// best of `repeat` runs of `out[i] = f(a[i], b[i])`
+template <typename T, typename F>
+void measure(const char* name, const char* operation, const std::vector<T>& a, const std::vector<T>& b,
+             std::vector<T>& out, const bench_config& config, F f, std::vector<bench_result>& results)
+{
+    double best_ns = 1e300;
+    double best_cycles = 1e300;
+    for (size_t r = 0; r <= config.repeat; r++)  // the first run warms up the cache
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t start_cycles = read_cycles();
+        for (size_t i = 0; i < a.size(); i++)
+            out[i] = f(a[i], b[i]);
+        do_not_optimize(out.data());
+        const uint64_t cycles = read_cycles() - start_cycles;
+        const auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0)
+            continue;
+        best_ns = std::min(best_ns, ns);
+        best_cycles = std::min(best_cycles, static_cast<double>(cycles));
+    }
+    const double n = static_cast<double>(a.size());
+    bench_result result = {name, operation, bench_type_name<T>::name(), best_ns / n, best_cycles / n};
+    results.push_back(result);
+}
+
+/// best of `repeat` runs of the reduction `f()` of the whole input
+template <typename T, typename F>
+void measure_reduction(const char* name, const char* operation, size_t n, const bench_config& config, F f,
+                       std::vector<bench_result>& results)
+{
+    double best_ns = 1e300;
+    double best_cycles = 1e300;
+    for (size_t r = 0; r <= config.repeat; r++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t start_cycles = read_cycles();
+        const T result = f();
+        do_not_optimize(&result);
+        const uint64_t cycles = read_cycles() - start_cycles;
+        const auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        if (r == 0)
+            continue;
+        best_ns = std::min(best_ns, ns);
+        best_cycles = std::min(best_cycles, static_cast<double>(cycles));
+    }
+    bench_result result = {name, operation, bench_type_name<T>::name(), best_ns / static_cast<double>(n),
+                           best_cycles / static_cast<double>(n)};
+    results.push_back(result);
+}
+
+template <typename T>
+struct plain_add { T operator()(const T a, const T b) const { return static_cast<T>(a + b); } };
+template <typename T>
+struct plain_sub { T operator()(const T a, const T b) const { return static_cast<T>(a - b); } };
+template <typename T>
+struct plain_mul { T operator()(const T a, const T b) const { return static_cast<T>(a * b); } };
+
+template <typename T>
+struct checked_add_op { T operator()(const T a, const T b) const { return std::checked_add(a, b); } };
+template <typename T>
+struct checked_sub_op { T operator()(const T a, const T b) const { return std::checked_sub(a, b); } };
+template <typename T>
+struct checked_mul_op { T operator()(const T a, const T b) const { return std::checked_mul(a, b); } };
+
+/// `+=` etc. of checked<T> as a counter, checked in T
+template <typename T>
+struct checked_type_add_op { T operator()(const T a, const T b) const { std::checked<T> c(a); c += b; return c.value(); } };
+template <typename T>
+struct checked_type_sub_op { T operator()(const T a, const T b) const { std::checked<T> c(a); c -= b; return c.value(); } };
+template <typename T>
+struct checked_type_mul_op { T operator()(const T a, const T b) const { std::checked<T> c(a); c *= b; return c.value(); } };
+
+#if USE_BOOST_SAFE_NUMERICS
+using boost::safe_numerics::safe;
+template <typename T>
+struct safe_add_op { T operator()(const T a, const T b) const { return safe<T>(a) + safe<T>(b); } };
+template <typename T>
+struct safe_sub_op { T operator()(const T a, const T b) const { return safe<T>(a) - safe<T>(b); } };
+template <typename T>
+struct safe_mul_op { T operator()(const T a, const T b) const { return safe<T>(a) * safe<T>(b); } };
+#endif
+
+template <typename T>
+void measure_type(const bench_config& config, std::vector<bench_result>& results)
+{
+    std::vector<T> a, b;
+    make_input<T>(config.elements, a, b);
+    std::vector<T> out(config.elements);
+    measure("operator", "add", a, b, out, config, plain_add<T>(), results);
+    measure("std::checked_add", "add", a, b, out, config, checked_add_op<T>(), results);
+    measure("operator", "sub", a, b, out, config, plain_sub<T>(), results);
+    measure("std::checked_sub", "sub", a, b, out, config, checked_sub_op<T>(), results);
+    measure("operator", "mul", a, b, out, config, plain_mul<T>(), results);
+    measure("std::checked_mul", "mul", a, b, out, config, checked_mul_op<T>(), results);
+    measure("std::checked", "add", a, b, out, config, checked_type_add_op<T>(), results);
+    measure("std::checked", "sub", a, b, out, config, checked_type_sub_op<T>(), results);
+    measure("std::checked", "mul", a, b, out, config, checked_type_mul_op<T>(), results);
+#if USE_BOOST_SAFE_NUMERICS
+    measure("boost::safe_numerics::safe", "add", a, b, out, config, safe_add_op<T>(), results);
+    measure("boost::safe_numerics::safe", "sub", a, b, out, config, safe_sub_op<T>(), results);
+    measure("boost::safe_numerics::safe", "mul", a, b, out, config, safe_mul_op<T>(), results);
+#endif
+}
+
+/// the reductions of the operands of measure_type(), the sums fit in int64_t
+template <typename T>
+void measure_reduction_type(const bench_config& config, std::vector<bench_result>& results)
+{
+    std::vector<T> a, b;
+    make_input<T>(config.elements, a, b);
+    const size_t n = a.size();
+    measure_reduction<T>("operator", "sum", n, config, [&] {
+        T sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum = static_cast<T>(sum + a[i]);
+        return sum;
+    }, results);
+    measure_reduction<T>("std::checked_reduce_sum", "sum", n, config, [&] {
+        return std::checked_reduce_sum(a.data(), n);
+    }, results);
+    // the products of int64_t operands up to 2^31 would overflow in the sum
+    if (std::numeric_limits<T>::digits > 32)
+        return;
+    measure_reduction<T>("operator", "dot", n, config, [&] {
+        T sum = 0;
+        for (size_t i = 0; i < n; i++)
+            sum = static_cast<T>(sum + a[i] * b[i]);
+        return sum;
+    }, results);
+    measure_reduction<int64_t>("std::checked_dot", "dot", n, config, [&] {
+        return std::checked_dot<int64_t>(a.data(), b.data(), n);
+    }, results);
+    results.back().type = bench_type_name<T>::name();
+}
+
+void write_json(std::FILE* file, const bench_config& config, const std::vector<bench_result>& results)
+{
+    std::fprintf(file, "{\n  \"context\": {\n");
+#if defined(__clang__)
+    std::fprintf(file, "    \"compiler\": \"clang %s\",\n", __clang_version__);
+#elif defined(__GNUC__)
+    std::fprintf(file, "    \"compiler\": \"gcc %s\",\n", __VERSION__);
+#elif defined(_MSC_VER)
+    std::fprintf(file, "    \"compiler\": \"msvc %d\",\n", _MSC_VER);
+#endif
+    std::fprintf(file, "    \"cplusplus\": %ld,\n", static_cast<long>(__cplusplus));
+#if NUMERIC_CAST_OVERFLOW_BUILTINS
+    std::fprintf(file, "    \"overflow_builtins\": true,\n");
+#else
+    std::fprintf(file, "    \"overflow_builtins\": false,\n");
+#endif
+    std::fprintf(file, "    \"elements\": %zu,\n    \"repeat\": %zu\n  },\n", config.elements, config.repeat);
+    std::fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const bench_result& r = results[i];
+        std::fprintf(file, "    {\"name\": \"%s\", \"operation\": \"%s\", \"type\": \"%s\", "
+                     "\"ns_per_element\": %.4f, \"cycles_per_element\": %.4f}%s\n",
+                     r.name.c_str(), r.operation.c_str(), r.type.c_str(),
+                     r.ns_per_element, r.cycles_per_element, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char* argv[])
+{
+    bench_config config = {4096, 100};
+    const char* out_path = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--quick") == 0)
+            config = bench_config{256, 2};
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--quick] [--out result.json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<bench_result> results;
+    measure_type<int32_t>(config, results);
+    measure_type<uint32_t>(config, results);
+    measure_type<int64_t>(config, results);
+    measure_type<uint64_t>(config, results);
+    measure_reduction_type<int32_t>(config, results);
+    measure_reduction_type<int64_t>(config, results);
+
+    std::FILE* file = out_path ? std::fopen(out_path, "w") : stdout;
+    if (!file)
+    {
+        std::fprintf(stderr, "can not open %s\n", out_path);
+        return 1;
+    }
+    write_json(file, config, results);
+    if (out_path)
+        std::fclose(file);
+    return 0;
+}
@@ -0,0 +1,393 @@
+/***********************************************************
+//              copyright Qingfeng Xia, 2020
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+************************************************************/
+
+/**
+* micro-benchmark of the conversions, without external dependency
+*
+* For each pair of source and target types, the same in-range input is converted by
+* `static_cast` (the baseline), `std::numeric_cast`, `std::try_numeric_cast`,
+* `std::saturate_cast`, a `gsl::narrow` style check, `boost::numeric_cast` if
+* Boost is found, and the bulk `std::numeric_cast_n` and `std::saturate_cast_n`.
+* The best of several repetitions is reported as JSON, in ns and TSC cycles per element.
+*
+* usage: bench_numeric_cast [--quick] [--out result.json]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../numeric_cast.h"
+#include "../numeric_cast_bulk.h"
+#include "../third-party/half.hpp"
+
+#if USE_BOOST
+#include <boost/numeric/conversion/cast.hpp>
+#endif
+#if USE_BOOST_MULTIPRECISION
+#include <boost/multiprecision/cpp_int.hpp>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using half_float::half;
+
+/// the time stamp counter, counting at the nominal frequency, 0 if there is none
+inline uint64_t read_cycles()
+{
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/// keep the output of the measured loop alive
+inline void do_not_optimize(const void* p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(p) : "memory");
+#else
+    static const void* volatile sink;
+    sink = p;
+#endif
+}
+
+/// the fixed width names, unlike numeric_type_name which gives "int" for int32_t
+template <typename T> struct bench_type_name;
+#define BENCH_TYPE_NAME(type)                    \
+    template <> struct bench_type_name<type>     \
+    {                                            \
+        static const char* name() { return #type; } \
+    };
+BENCH_TYPE_NAME(int8_t)
+BENCH_TYPE_NAME(uint8_t)
+BENCH_TYPE_NAME(int16_t)
+BENCH_TYPE_NAME(uint16_t)
+BENCH_TYPE_NAME(int32_t)
+BENCH_TYPE_NAME(uint32_t)
+BENCH_TYPE_NAME(int64_t)
+BENCH_TYPE_NAME(uint64_t)
+BENCH_TYPE_NAME(float)
+BENCH_TYPE_NAME(double)
+BENCH_TYPE_NAME(half)
+#if USE_BOOST_MULTIPRECISION
+using boost::multiprecision::int128_t;
+BENCH_TYPE_NAME(int128_t)
+#endif
+#undef BENCH_TYPE_NAME
+
+template <typename... Ts> struct type_list {};
+
+/// built-in arithmetic types, the bulk kernels and boost::numeric_cast are measured for them
+template <typename T>
+struct is_builtin : std::is_arithmetic<T> {};
+
+/// the failure of `narrow()`, as `gsl::narrowing_error`
+struct narrowing_error : std::exception
+{
+    const char* what() const noexcept override
+    {
+        return "narrowing_error";
+    }
+};
+
+/// `gsl::narrow`: convert, then check the round trip and the sign
+template <typename T, typename S>
+T narrow(const S value)
+{
+    const T t = static_cast<T>(value);
+    if (static_cast<S>(t) != value || ((t < T(0)) != (value < S(0))))
+        throw narrowing_error();
+    return t;
+}
+
+template <typename T>
+long double to_long_double(const T value)
+{
+    return static_cast<long double>(value);
+}
+
+inline long double to_long_double(const half value)
+{
+    return static_cast<float>(value);
+}
+
+template <typename S>
+S from_long_double(const long double value)
+{
+    return static_cast<S>(value);
+}
+
+template <>
+half from_long_double<half>(const long double value)
+{
+    return half(static_cast<float>(value));
+}
+
+#if USE_BOOST_MULTIPRECISION
+template <>
+int128_t from_long_double<int128_t>(const long double value)
+{
+    return int128_t(value);
+}
+#endif
+
+struct bench_config
+{
+    size_t elements;
+    size_t repeat;
+};
+
+struct bench_result
+{
+    std::string name;
+    std::string mode;
+    std::string source;
+    std::string target;
+    double ns_per_element;
+    double cycles_per_element;
+};
+
+/// input values of S inside the range of T, 90% of the common range
+/// so that the rounding of the limits to S does not give an out-of-range value,
+/// then round tripped through T to be exact in both types, as `narrow()` requires
+template <typename T, typename S>
+std::vector<S> make_input(size_t n)
+{
+    const long double lo = std::max(to_long_double(std::numeric_limits<T>::lowest()),
+                                    to_long_double(std::numeric_limits<S>::lowest())) * 0.9L;
+    const long double hi = std::min(to_long_double(std::numeric_limits<T>::max()),
+                                    to_long_double(std::numeric_limits<S>::max())) * 0.9L;
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<S> in(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const S value = from_long_double<S>(lo + (hi - lo) * static_cast<long double>(uniform(random)));
+        in[i] = static_cast<S>(static_cast<T>(value));
+    }
+    return in;
+}
+
+/// best of `repeat` runs of `convert(in, out)`
+template <typename T, typename S, typename Convert>
+void measure(const char* name, const char* mode, const std::vector<S>& in, std::vector<T>& out,
+             const bench_config& config, Convert convert, std::vector<bench_result>& results)
+{
+    double best_ns = 1e300;
+    double best_cycles = 1e300;
+    convert(in.data(), out.data(), in.size());  // warm up the cache and the dispatch
+    for (size_t r = 0; r < config.repeat; r++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t start_cycles = read_cycles();
+        convert(in.data(), out.data(), in.size());
+        do_not_optimize(out.data());
+        const uint64_t cycles = read_cycles() - start_cycles;
+        const auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        best_ns = std::min(best_ns, ns);
+        best_cycles = std::min(best_cycles, static_cast<double>(cycles));
+    }
+    const double n = static_cast<double>(in.size());
+    bench_result result = {name, mode, bench_type_name<S>::name(), bench_type_name<T>::name(),
+                           best_ns / n, best_cycles / n};
+    results.push_back(result);
+}
+
+/// converts element by element in a loop, as a call site in user code
+template <typename T, typename S, typename F>
+struct loop
+{
+    F f;
+
+    void operator()(const S* in, T* out, size_t n) const
+    {
+        for (size_t i = 0; i < n; i++)
+            out[i] = f(in[i]);
+    }
+};
+
+template <typename T, typename S, typename F>
+loop<T, S, F> make_loop(F f)
+{
+    return loop<T, S, F>{f};
+}
+
+template <typename T, typename S>
+struct static_cast_op
+{
+    T operator()(const S v) const { return static_cast<T>(v); }
+};
+
+template <typename T, typename S>
+struct numeric_cast_op
+{
+    T operator()(const S v) const { return std::numeric_cast<T>(v); }
+};
+
+template <typename T, typename S>
+struct try_numeric_cast_op
+{
+    T operator()(const S v) const { return std::try_numeric_cast<T>(v).value_or(T(0)); }
+};
+
+template <typename T, typename S>
+struct saturate_cast_op
+{
+    T operator()(const S v) const { return std::saturate_cast<T>(v); }
+};
+
+template <typename T, typename S>
+struct narrow_op
+{
+    T operator()(const S v) const { return narrow<T>(v); }
+};
+
+#if USE_BOOST
+template <typename T, typename S>
+struct boost_numeric_cast_op
+{
+    T operator()(const S v) const { return boost::numeric_cast<T>(v); }
+};
+#endif
+
+/// boost::numeric_cast and the bulk functions, for the built-in types and half
+template <typename T, typename S>
+void measure_builtin(const std::vector<S>& in, std::vector<T>& out, const bench_config& config,
+                     std::vector<bench_result>& results, std::true_type)
+{
+#if USE_BOOST
+    measure("boost::numeric_cast", "loop", in, out, config, make_loop<T, S>(boost_numeric_cast_op<T, S>()), results);
+#endif
+    measure("std::numeric_cast_n", "bulk", in, out, config,
+            [](const S* i, T* o, size_t n) { std::numeric_cast_n<T>(i, o, n); }, results);
+    measure("std::saturate_cast_n", "bulk", in, out, config,
+            [](const S* i, T* o, size_t n) { std::saturate_cast_n<T>(i, o, n); }, results);
+}
+
+template <typename T, typename S>
+void measure_builtin(const std::vector<S>&, std::vector<T>&, const bench_config&,
+                     std::vector<bench_result>&, std::false_type)
+{
+}
+
+template <typename T, typename S>
+void measure_pair(const bench_config& config, std::vector<bench_result>& results)
+{
+    const std::vector<S> in = make_input<T, S>(config.elements);
+    std::vector<T> out(config.elements);
+    measure("static_cast", "loop", in, out, config, make_loop<T, S>(static_cast_op<T, S>()), results);
+    measure("std::numeric_cast", "loop", in, out, config, make_loop<T, S>(numeric_cast_op<T, S>()), results);
+    measure("std::try_numeric_cast", "loop", in, out, config, make_loop<T, S>(try_numeric_cast_op<T, S>()), results);
+    measure("std::saturate_cast", "loop", in, out, config, make_loop<T, S>(saturate_cast_op<T, S>()), results);
+    measure("narrow", "loop", in, out, config, make_loop<T, S>(narrow_op<T, S>()), results);
+    measure_builtin<T, S>(in, out, config, results,
+                          std::integral_constant<bool, is_builtin<T>::value && is_builtin<S>::value>());
+}
+
+/// all targets of one source type, except the source type itself
+template <typename S, typename... Targets>
+void measure_source(const bench_config& config, std::vector<bench_result>& results, type_list<Targets...>)
+{
+    const int expand[] = {0, (std::is_same<S, Targets>::value ? 0 : (measure_pair<Targets, S>(config, results), 0))...};
+    static_cast<void>(expand);
+}
+
+template <typename... Sources, typename TargetList>
+void measure_matrix(const bench_config& config, std::vector<bench_result>& results,
+                    type_list<Sources...>, TargetList targets)
+{
+    const int expand[] = {0, (measure_source<Sources>(config, results, targets), 0)...};
+    static_cast<void>(expand);
+}
+
+typedef type_list<int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t,
+                  float, double, half> builtin_and_half;
+typedef type_list<int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t, int64_t, uint64_t> integers;
+
+const char* simd_level_name()
+{
+    switch (std::detail::cpu_simd_level())
+    {
+    case std::detail::simd_level::avx512: return "avx512";
+    case std::detail::simd_level::avx2: return "avx2";
+    case std::detail::simd_level::sse2: return "sse2";
+    default: return "none";
+    }
+}
+
+void write_json(std::FILE* file, const bench_config& config, const std::vector<bench_result>& results)
+{
+    std::fprintf(file, "{\n  \"context\": {\n");
+#if defined(__clang__)
+    std::fprintf(file, "    \"compiler\": \"clang %s\",\n", __clang_version__);
+#elif defined(__GNUC__)
+    std::fprintf(file, "    \"compiler\": \"gcc %s\",\n", __VERSION__);
+#elif defined(_MSC_VER)
+    std::fprintf(file, "    \"compiler\": \"msvc %d\",\n", _MSC_VER);
+#endif
+    std::fprintf(file, "    \"cplusplus\": %ld,\n", static_cast<long>(__cplusplus));
+    std::fprintf(file, "    \"simd_level\": \"%s\",\n", simd_level_name());
+    std::fprintf(file, "    \"elements\": %zu,\n    \"repeat\": %zu\n  },\n", config.elements, config.repeat);
+    std::fprintf(file, "  \"results\": [\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const bench_result& r = results[i];
+        std::fprintf(file, "    {\"name\": \"%s\", \"mode\": \"%s\", \"source\": \"%s\", \"target\": \"%s\", "
+                     "\"ns_per_element\": %.4f, \"cycles_per_element\": %.4f}%s\n",
+                     r.name.c_str(), r.mode.c_str(), r.source.c_str(), r.target.c_str(),
+                     r.ns_per_element, r.cycles_per_element, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char* argv[])
+{
+    bench_config config = {4096, 100};
+    const char* out_path = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--quick") == 0)
+            config = bench_config{256, 2};
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--quick] [--out result.json]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::vector<bench_result> results;
+    measure_matrix(config, results, builtin_and_half(), builtin_and_half());
+#if USE_BOOST_MULTIPRECISION
+    measure_matrix(config, results, type_list<int128_t>(), integers());
+    measure_matrix(config, results, integers(), type_list<int128_t>());
+#endif
+
+    std::FILE* file = out_path ? std::fopen(out_path, "w") : stdout;
+    if (!file)
+    {
+        std::fprintf(stderr, "can not open %s\n", out_path);
+        return 1;
+    }
+    write_json(file, config, results);
+    if (out_path)
+        std::fclose(file);
+    return 0;
+}
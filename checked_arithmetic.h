@@ -0,0 +1,1059 @@
+/***********************************************************
+//              copyright Qingfeng Xia, 2020
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+************************************************************/
+
+/**
+* checked integer arithmetic, this is a header-only library
+*
+* `std::checked_add<R>(a, b)`, `checked_sub`, `checked_mul`, `checked_shl<R>(a, n)` and
+* `checked_neg<R>(a)` compute the mathematical result of integer operands of any type and sign,
+* then give it as the result type R, by default the common type of the operands.
+* A result out of the range of R is handled by the same overflow policies as `numeric_cast<R>()`,
+* by default throwing `std::overflow_error` or `std::underflow_error`.
+* ```
+* int32_t total = std::checked_add<int32_t>(total, size);
+* uint8_t level = std::checked_sub<uint8_t, std::overflow_policy::saturate>(level, step);  // 0 below zero
+* ```
+* With GCC and clang, the check is `__builtin_add_overflow()` etc., i.e. the overflow or carry flag
+* of the instruction and a single `jo`/`jb`, the failure is out of line in a cold section.
+* Without the builtins, e.g. MSVC, the result is computed by sign and magnitude in `uintmax_t`,
+* define `NUMERIC_CAST_OVERFLOW_BUILTINS` to 0 to use these portable checks with GCC and clang too.
+*
+* `std::checked<T>` is an integer value type on top of them: its operators give a type wide enough
+* for every result, decided at compile time, so that there is no check at runtime, and fall back to
+* the checked functions only if the result may not fit in 64 bits.
+* ```
+* std::checked<int64_t> count;
+* count += size;                          // checked_add<int64_t>(), a single jo
+* auto area = std::checked<int32_t>(w) * h;  // checked<int64_t>, no check
+* ```
+*
+* `std::overflow_accumulator` defers the check of a loop to a sticky flag tested after it,
+* so that the checked loop is still vectorized.
+*
+* The exception and the failure handler get the operand types and values, e.g. the message
+* "numeric_cast: int 2147483647 + 1 overflows int", a negative shift count is a `std::range_error`.
+* The other overflow policies get the mathematical result as `long double`, except `overflow_policy::wrap`,
+* which gives the result modulo 2^N of R, as the unchecked operation of unsigned integers.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "numeric_cast.h"
+
+/// `__builtin_add_overflow()`, `__builtin_sub_overflow()` and `__builtin_mul_overflow()`
+/// of GCC 5 and clang 3.8, define it to 0 for the portable checks
+#ifndef NUMERIC_CAST_OVERFLOW_BUILTINS
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_add_overflow) && __has_builtin(__builtin_mul_overflow)
+#define NUMERIC_CAST_OVERFLOW_BUILTINS 1
+#endif
+#endif
+#endif
+#if !defined(NUMERIC_CAST_OVERFLOW_BUILTINS) && defined(__GNUC__) && __GNUC__ >= 5
+#define NUMERIC_CAST_OVERFLOW_BUILTINS 1
+#endif
+
+/// it is safe to inject into std namespace
+namespace std {
+
+namespace detail{
+
+    /// operand and result type of the checked arithmetic, integral but not bool
+    template <typename T>
+    struct is_checked_integer : std::integral_constant<bool, std::is_integral<T>::value
+        && !std::is_same<typename std::remove_cv<T>::type, bool>::value> {};
+
+    /// R, or the common type of the operands if R is void
+    template <typename R, typename A, typename B>
+    struct checked_result
+    {
+        typedef typename std::conditional<std::is_void<R>::value,
+            typename std::common_type<A, B>::type, R>::type type;
+    };
+
+    /// true if all of Policies are overflow policies
+    template <typename... Policies>
+    struct are_overflow_policies : std::true_type {};
+
+    template <typename P, typename... Policies>
+    struct are_overflow_policies<P, Policies...> : std::integral_constant<bool,
+        is_overflow_policy<P>::value && are_overflow_policies<Policies...>::value> {};
+
+    /// the unsigned type of R, at least `unsigned int`, in which the operations wrap without promotion
+    template <typename R>
+    struct wrapping_unsigned : std::common_type<typename std::make_unsigned<R>::type, unsigned> {};
+
+    /// the magnitude of an integer of any type and sign, e.g. 128 for `int8_t(-128)`
+    template <typename A>
+    constexpr std::uintmax_t magnitude(const A a) noexcept
+    {
+        return cmp_less(a, 0) ? std::uintmax_t(0) - static_cast<std::uintmax_t>(a)
+                              : static_cast<std::uintmax_t>(a);
+    }
+
+    /// true if the value of sign `negative` and magnitude `m` is out of the range of R
+    template <typename R>
+    constexpr bool magnitude_out_of_range(const bool negative, const std::uintmax_t m) noexcept
+    {
+        return negative ? m > magnitude(std::numeric_limits<R>::lowest())
+                        : m > static_cast<std::uintmax_t>(std::numeric_limits<R>::max());
+    }
+
+    /// `x + y` by sign and magnitude, a carry out of `uintmax_t` is out of the range of any R
+    template <typename R>
+    bool magnitude_add_overflow(const bool x_negative, const std::uintmax_t x,
+                                const bool y_negative, const std::uintmax_t y) noexcept
+    {
+        if (x_negative == y_negative)
+            return x + y < x || magnitude_out_of_range<R>(x_negative, x + y);
+        return x < y ? magnitude_out_of_range<R>(y_negative, y - x)
+                     : magnitude_out_of_range<R>(x_negative, x - y);
+    }
+
+    /// the portable checks: the mathematical result of the operand values is computed
+    /// by sign and magnitude in `uintmax_t`, then checked by the limits of R, e.g.
+    /// `uint8_t(300 + -100)` is in range. The result is computed modulo 2^N in the unsigned type,
+    /// also for the failure
+    template <typename R, typename A, typename B>
+    bool portable_add_overflow(const A a, const B b, R& result) noexcept
+    {
+        typedef typename wrapping_unsigned<R>::type U;
+        result = static_cast<R>(static_cast<U>(static_cast<U>(a) + static_cast<U>(b)));
+        return magnitude_add_overflow<R>(cmp_less(a, 0), magnitude(a), cmp_less(b, 0), magnitude(b));
+    }
+
+    template <typename R, typename A, typename B>
+    bool portable_sub_overflow(const A a, const B b, R& result) noexcept
+    {
+        typedef typename wrapping_unsigned<R>::type U;
+        result = static_cast<R>(static_cast<U>(static_cast<U>(a) - static_cast<U>(b)));
+        return magnitude_add_overflow<R>(cmp_less(a, 0), magnitude(a), !cmp_less(b, 0), magnitude(b));
+    }
+
+    /// a product not in `uintmax_t` is out of the range of any R
+    template <typename R, typename A, typename B>
+    bool portable_mul_overflow(const A a, const B b, R& result) noexcept
+    {
+        typedef typename wrapping_unsigned<R>::type U;
+        result = static_cast<R>(static_cast<U>(static_cast<U>(a) * static_cast<U>(b)));
+        const std::uintmax_t x = magnitude(a);
+        const std::uintmax_t y = magnitude(b);
+        return (x != 0 && x * y / x != y)
+            || magnitude_out_of_range<R>(cmp_less(a, 0) != cmp_less(b, 0), x * y);
+    }
+
+    /// true if `a + b` is out of the range of R, `result` is the mathematical result modulo 2^N
+    template <typename R, typename A, typename B>
+    NUMERIC_CAST_ALWAYS_INLINE bool add_overflow(const A a, const B b, R& result) noexcept
+    {
+#if NUMERIC_CAST_OVERFLOW_BUILTINS
+        return __builtin_add_overflow(a, b, &result);
+#else
+        return portable_add_overflow<R, A, B>(a, b, result);
+#endif
+    }
+
+    template <typename R, typename A, typename B>
+    NUMERIC_CAST_ALWAYS_INLINE bool sub_overflow(const A a, const B b, R& result) noexcept
+    {
+#if NUMERIC_CAST_OVERFLOW_BUILTINS
+        return __builtin_sub_overflow(a, b, &result);
+#else
+        return portable_sub_overflow<R, A, B>(a, b, result);
+#endif
+    }
+
+    template <typename R, typename A, typename B>
+    NUMERIC_CAST_ALWAYS_INLINE bool mul_overflow(const A a, const B b, R& result) noexcept
+    {
+#if NUMERIC_CAST_OVERFLOW_BUILTINS
+        return __builtin_mul_overflow(a, b, &result);
+#else
+        return portable_mul_overflow<R, A, B>(a, b, result);
+#endif
+    }
+
+    /// `a * 2^n`, a count not below the width of R shifts every bit out, a negative count fails
+    template <typename R, typename A, typename N>
+    NUMERIC_CAST_ALWAYS_INLINE bool shl_overflow(const A a, const N n, R& result) noexcept
+    {
+        typedef typename wrapping_unsigned<R>::type U;
+        if (cmp_less(n, 0) || !cmp_less(n, std::numeric_limits<R>::digits + std::is_signed<R>::value))
+        {
+            result = R(0);
+            return a != A(0) || cmp_less(n, 0);
+        }
+        return mul_overflow<R>(a, static_cast<U>(U(1) << n), result);
+    }
+
+    /// the character `i` of the strings a, sep and b joined, 0 after the end
+    constexpr char joined_char(const char* a, const char* sep, const char* b, const size_t i) noexcept
+    {
+        return *a != '\0' ? (i == 0 ? *a : joined_char(a + 1, sep, b, i - 1))
+            : *sep != '\0' ? (i == 0 ? *sep : joined_char(a, sep + 1, b, i - 1))
+            : *b != '\0' ? (i == 0 ? *b : joined_char(a, sep, b + 1, i - 1)) : '\0';
+    }
+
+    template <size_t... I>
+    struct char_indices {};
+
+    template <size_t N, size_t... I>
+    struct make_char_indices : make_char_indices<N - 1, N - 1, I...> {};
+
+    template <size_t... I>
+    struct make_char_indices<0, I...>
+    {
+        typedef char_indices<I...> type;
+    };
+
+    /// "unsigned int and int", joined at compile time, as the type names are kept as pointers
+    /// to static strings, and a function local static would need a guard
+    template <typename A, typename B, typename Indices = typename make_char_indices<47>::type>
+    struct joined_type_name;
+
+    template <typename A, typename B, size_t... I>
+    struct joined_type_name<A, B, char_indices<I...>>
+    {
+        static constexpr char text[48] = {
+            joined_char(numeric_type_name<A>::name(), " and ", numeric_type_name<B>::name(), I)...};
+    };
+
+#if __cplusplus < 201703L
+    template <typename A, typename B, size_t... I>
+    constexpr char joined_type_name<A, B, char_indices<I...>>::text[48];
+#endif
+
+    /// the names of the operand types in the message of a failure, e.g. "int" or "unsigned int and int"
+    template <typename A, typename B>
+    constexpr const char* operand_types_name() noexcept
+    {
+        return std::is_same<A, B>::value ? numeric_type_name<A>::name() : joined_type_name<A, B>::text;
+    }
+
+    /// `a op b` of two operands, their values are written as the text of the failure, e.g. "2147483647 + 1"
+    template <char Symbol>
+    struct binary_operation
+    {
+        static void format(char (&text)[72], const char* a, const char* b) noexcept
+        {
+            std::snprintf(text, sizeof(text), "%s %c %s", a, Symbol, b);
+        }
+
+        template <typename A, typename B>
+        static const char* type_name() noexcept
+        {
+            return operand_types_name<A, B>();
+        }
+    };
+
+    /// the mathematical result of the operations as `long double`, for the overflow policy
+    struct add_operation : binary_operation<'+'>
+    {
+        template <typename A, typename B>
+        static long double result(const A a, const B b) noexcept
+        {
+            return static_cast<long double>(a) + static_cast<long double>(b);
+        }
+    };
+
+    struct sub_operation : binary_operation<'-'>
+    {
+        template <typename A, typename B>
+        static long double result(const A a, const B b) noexcept
+        {
+            return static_cast<long double>(a) - static_cast<long double>(b);
+        }
+    };
+
+    struct mul_operation : binary_operation<'*'>
+    {
+        template <typename A, typename B>
+        static long double result(const A a, const B b) noexcept
+        {
+            return static_cast<long double>(a) * static_cast<long double>(b);
+        }
+    };
+
+    /// `-b`, the first operand is the 0 of `0 - b`
+    struct neg_operation
+    {
+        template <typename A, typename B>
+        static long double result(const A, const B b) noexcept
+        {
+            return -static_cast<long double>(b);
+        }
+
+        static void format(char (&text)[72], const char*, const char* b) noexcept
+        {
+            std::snprintf(text, sizeof(text), "-(%s)", b);
+        }
+
+        template <typename A, typename B>
+        static const char* type_name() noexcept
+        {
+            return numeric_type_name<B>::name();
+        }
+    };
+
+    /// infinity of the sign of `a` if the count is negative or beyond any exponent,
+    /// the type of the count is not in the message
+    struct shl_operation
+    {
+        template <typename A, typename N>
+        static long double result(const A a, const N n) noexcept
+        {
+            return cmp_less(n, 0) || cmp_greater(n, std::numeric_limits<long double>::max_exponent)
+                ? (a < A(0) ? -HUGE_VALL : HUGE_VALL)
+                : std::ldexp(static_cast<long double>(a), static_cast<int>(n));
+        }
+
+        static void format(char (&text)[72], const char* a, const char* n) noexcept
+        {
+            std::snprintf(text, sizeof(text), "%s << %s", a, n);
+        }
+
+        template <typename A, typename N>
+        static const char* type_name() noexcept
+        {
+            return numeric_type_name<A>::name();
+        }
+    };
+
+    /// the error of a failed operation, by the sign of the mathematical result
+    template <typename Operation, typename A, typename B>
+    numeric_cast_errc operation_error(Operation, const A a, const B b) noexcept
+    {
+        return Operation::result(a, b) > 0 ? numeric_cast_errc::overflow : numeric_cast_errc::underflow;
+    }
+
+    template <typename A, typename N>
+    numeric_cast_errc operation_error(shl_operation, const A a, const N n) noexcept
+    {
+        return cmp_less(n, 0) ? numeric_cast_errc::negative_shift
+            : (a < A(0) ? numeric_cast_errc::underflow : numeric_cast_errc::overflow);
+    }
+
+    /// the operation with the operand values as text, into the value of numeric_cast_error
+    template <typename Operation, typename A, typename B>
+    void format_operation(char (&text)[72], const A a, const B b) noexcept
+    {
+        char left[32], right[32];
+        format_value(left, a);
+        format_value(right, b);
+        Operation::format(text, left, right);
+    }
+
+    /// pass the failure to the failure handler with the operand types and values, as the failure
+    /// of `numeric_cast<R>()`, then give the nearest limit of R, zero for a negative shift count
+    template <typename Operation, typename R, typename A, typename B>
+    NUMERIC_CAST_COLD R report_arithmetic_failure(const A a, const B b)
+    {
+        const numeric_cast_errc error = operation_error(Operation(), a, b);
+        char text[72];
+        format_operation<Operation>(text, a, b);
+        report_numeric_cast_failure(numeric_cast_failure_info(error, Operation::template type_name<A, B>(),
+            numeric_type_name<R>::name(), text, "", 0, ""));
+        return failure_fallback<R, R>(error, R());
+    }
+
+    /// throw the exception of the failure with the operand types and values,
+    /// or pass it to the failure handler without exception support
+    template <typename Operation, typename R, typename A, typename B>
+    NUMERIC_CAST_COLD R throw_arithmetic_error(const A a, const B b)
+    {
+#if NUMERIC_CAST_NO_EXCEPTIONS
+        return report_arithmetic_failure<Operation, R>(a, b);
+#else
+        char text[72];
+        format_operation<Operation>(text, a, b);
+        throw_numeric_cast_error(operation_error(Operation(), a, b), Operation::template type_name<A, B>(),
+                                 numeric_type_name<R>::name(), text);
+#endif
+    }
+
+    /// a result out of the range of R, given to the overflow policy as `long double`,
+    /// or as the limit beyond max or lowest if it is rounded into the range of R
+    template <typename R, typename Policy>
+    struct arithmetic_overflow
+    {
+        template <typename Operation, typename A, typename B>
+        NUMERIC_CAST_COLD static R failure(const A a, const B b, const R)
+        {
+            const long double result = Operation::result(a, b);
+            return Policy::template cast<R, long double>(above_max<R>(result) || below_min<R>(result) ? result
+                : (result > 0 ? static_cast<long double>(std::numeric_limits<R>::max()) * 2 + 1
+                   : static_cast<long double>(std::numeric_limits<R>::lowest()) * 2 - 1));
+        }
+    };
+
+    /// the exception, whose message has the operands instead of the result, e.g.
+    /// "numeric_cast: int 2147483647 + 1 overflows int", and "int 1 << -1 has a negative shift count"
+    template <typename R>
+    struct arithmetic_overflow<R, overflow_policy::throw_on_overflow>
+    {
+        template <typename Operation, typename A, typename B>
+        NUMERIC_CAST_COLD static R failure(const A a, const B b, const R)
+        {
+            return throw_arithmetic_error<Operation, R>(a, b);
+        }
+    };
+
+    template <typename R>
+    struct arithmetic_overflow<R, overflow_policy::report>
+    {
+        template <typename Operation, typename A, typename B>
+        NUMERIC_CAST_COLD static R failure(const A a, const B b, const R)
+        {
+            return report_arithmetic_failure<Operation, R>(a, b);
+        }
+    };
+
+    /// the mathematical result modulo 2^N
+    template <typename R>
+    struct arithmetic_overflow<R, overflow_policy::wrap>
+    {
+        template <typename Operation, typename A, typename B>
+        static R failure(const A, const B, const R wrapped) noexcept
+        {
+            return wrapped;
+        }
+    };
+
+    /// the caller guarantees there is no overflow, the check is folded away
+    template <typename R>
+    struct arithmetic_overflow<R, overflow_policy::assume_in_range>
+    {
+        template <typename Operation, typename A, typename B>
+        [[noreturn]] NUMERIC_CAST_ALWAYS_INLINE static R failure(const A, const B, const R) noexcept
+        {
+            unreachable_value<R>();
+        }
+    };
+
+    /// the result of a checked operation, or the overflow policy of Policies on failure
+    template <typename Operation, typename... Policies, typename R, typename A, typename B>
+    NUMERIC_CAST_ALWAYS_INLINE R checked_operation(const bool overflow, const R result, const A a, const B b)
+    {
+        typedef typename select_policy<overflow_policy::policy_tag,
+            overflow_policy::throw_on_overflow, Policies...>::type policy;
+        static_assert(is_checked_integer<R>::value, "the result of checked arithmetic is an integral type");
+        return overflow ? arithmetic_overflow<R, policy>::template failure<Operation>(a, b, result) : result;
+    }
+}
+
+    /// usage `int32_t sum = checked_add<int32_t>(a, b);`, the mathematical `a + b` of integers
+    /// of any type and sign as R, by default the common type of A and B. A result out of the range
+    /// of R is handled by the overflow policy, by default throwing `std::overflow_error` or
+    /// `std::underflow_error`, e.g. `checked_add<int8_t, overflow_policy::saturate>(a, b)`
+    template <typename R = void, typename... Policies, typename A, typename B,
+        typename std::enable_if<detail::is_checked_integer<A>::value && detail::is_checked_integer<B>::value
+        && detail::are_overflow_policies<Policies...>::value, int>::type = 0>
+    NUMERIC_CAST_ALWAYS_INLINE typename detail::checked_result<R, A, B>::type checked_add(const A a, const B b)
+    {
+        typename detail::checked_result<R, A, B>::type result;
+        const bool overflow = detail::add_overflow(a, b, result);
+        return detail::checked_operation<detail::add_operation, Policies...>(overflow, result, a, b);
+    }
+
+    /// the mathematical `a - b` as R, e.g. `checked_sub<uint32_t>(1u, 2u)` throws `std::underflow_error`
+    template <typename R = void, typename... Policies, typename A, typename B,
+        typename std::enable_if<detail::is_checked_integer<A>::value && detail::is_checked_integer<B>::value
+        && detail::are_overflow_policies<Policies...>::value, int>::type = 0>
+    NUMERIC_CAST_ALWAYS_INLINE typename detail::checked_result<R, A, B>::type checked_sub(const A a, const B b)
+    {
+        typename detail::checked_result<R, A, B>::type result;
+        const bool overflow = detail::sub_overflow(a, b, result);
+        return detail::checked_operation<detail::sub_operation, Policies...>(overflow, result, a, b);
+    }
+
+    /// the mathematical `a * b` as R
+    template <typename R = void, typename... Policies, typename A, typename B,
+        typename std::enable_if<detail::is_checked_integer<A>::value && detail::is_checked_integer<B>::value
+        && detail::are_overflow_policies<Policies...>::value, int>::type = 0>
+    NUMERIC_CAST_ALWAYS_INLINE typename detail::checked_result<R, A, B>::type checked_mul(const A a, const B b)
+    {
+        typename detail::checked_result<R, A, B>::type result;
+        const bool overflow = detail::mul_overflow(a, b, result);
+        return detail::checked_operation<detail::mul_operation, Policies...>(overflow, result, a, b);
+    }
+
+    /// the mathematical `-a` as R, by default A, e.g. `checked_neg(INT_MIN)` and `checked_neg(1u)` fail,
+    /// but `checked_neg<int64_t>(INT_MIN)` does not
+    template <typename R = void, typename... Policies, typename A,
+        typename std::enable_if<detail::is_checked_integer<A>::value
+        && detail::are_overflow_policies<Policies...>::value, int>::type = 0>
+    NUMERIC_CAST_ALWAYS_INLINE typename detail::checked_result<R, A, A>::type checked_neg(const A a)
+    {
+        typename detail::checked_result<R, A, A>::type result;
+        const bool overflow = detail::sub_overflow(A(0), a, result);
+        return detail::checked_operation<detail::neg_operation, Policies...>(overflow, result, A(0), a);
+    }
+
+    /// the mathematical `a * 2^n` as R, by default A. Unlike `a << n`, a negative `a` is shifted
+    /// as a multiplication, and a count not below the width of R is not undefined behaviour,
+    /// the result is 0 for `a == 0` and a failure otherwise, as a negative count
+    template <typename R = void, typename... Policies, typename A, typename N,
+        typename std::enable_if<detail::is_checked_integer<A>::value && detail::is_checked_integer<N>::value
+        && detail::are_overflow_policies<Policies...>::value, int>::type = 0>
+    NUMERIC_CAST_ALWAYS_INLINE typename detail::checked_result<R, A, A>::type checked_shl(const A a, const N n)
+    {
+        typename detail::checked_result<R, A, A>::type result;
+        const bool overflow = detail::shl_overflow(a, n, result);
+        return detail::checked_operation<detail::shl_operation, Policies...>(overflow, result, a, n);
+    }
+
+    template <typename T>
+    class checked;
+
+namespace detail{
+
+    template <typename T>
+    struct is_checked : std::false_type {};
+
+    template <typename T>
+    struct is_checked<checked<T>> : std::true_type {};
+
+    /// the integer type of an operand of checked<T>, which is a checked<T> or an integer
+    template <typename T>
+    struct checked_operand
+    {
+        typedef T type;
+    };
+
+    template <typename T>
+    struct checked_operand<checked<T>>
+    {
+        typedef T type;
+    };
+
+    template <typename T>
+    constexpr T operand_value(const T value) noexcept
+    {
+        return value;
+    }
+
+    template <typename T>
+    constexpr T operand_value(const checked<T> value) noexcept
+    {
+        return value.value();
+    }
+
+    /// at least one of A and B is a checked<T>, the other an integer or a checked<T>
+    template <typename A, typename B>
+    struct are_checked_operands : std::integral_constant<bool,
+        (is_checked<A>::value || is_checked<B>::value)
+        && is_checked_integer<typename checked_operand<A>::type>::value
+        && is_checked_integer<typename checked_operand<B>::type>::value> {};
+
+    /// int32_t or int64_t, uint32_t or uint64_t, the narrowest with Digits digits.
+    /// `fits` is false if even the 64-bit type has fewer digits, then the operation is checked
+    template <bool Signed, int Digits>
+    struct promoted_integer
+    {
+        typedef typename std::conditional<Signed,
+            typename std::conditional<(Digits <= 31), int32_t, int64_t>::type,
+            typename std::conditional<(Digits <= 32), uint32_t, uint64_t>::type>::type type;
+        static constexpr bool fits = Digits <= std::numeric_limits<type>::digits;
+    };
+
+    template <typename A, typename B>
+    struct max_digits : std::integral_constant<int,
+        (std::numeric_limits<A>::digits > std::numeric_limits<B>::digits)
+        ? std::numeric_limits<A>::digits : std::numeric_limits<B>::digits> {};
+
+    /// if even the 64-bit type of P does not hold every result, `a + b` and `a - b` are checked in the
+    /// type of the wider operand, as by `+=` and `-=`, e.g. in uint64_t for two uint64_t operands
+    template <typename P, typename A, typename B>
+    struct wider_operand_fallback : P
+    {
+        typedef typename std::conditional<P::fits, typename P::type,
+            typename std::conditional<(std::numeric_limits<A>::digits >= std::numeric_limits<B>::digits),
+            A, B>::type>::type type;
+    };
+
+    /// the digits of every result of the operation, by the ranges of A and B:
+    /// `a + b` one more than the wider operand, `a - b` the same but always signed,
+    /// `a * b` the sum, plus one for `lowest() * lowest()` of two signed types
+    template <typename A, typename B>
+    struct add_promotion : wider_operand_fallback<promoted_integer<std::is_signed<A>::value
+        || std::is_signed<B>::value, max_digits<A, B>::value + 1>, A, B> {};
+
+    template <typename A, typename B>
+    struct sub_promotion : wider_operand_fallback<promoted_integer<true, max_digits<A, B>::value + 1>, A, B> {};
+
+    template <typename A, typename B>
+    struct mul_promotion : promoted_integer<std::is_signed<A>::value || std::is_signed<B>::value,
+        std::numeric_limits<A>::digits + std::numeric_limits<B>::digits
+        + (std::is_signed<A>::value && std::is_signed<B>::value)> {};
+
+    /// `-lowest()` of a signed type needs one more digit
+    template <typename A, typename B>
+    struct neg_promotion : promoted_integer<true, std::numeric_limits<B>::digits + std::is_signed<B>::value> {};
+
+    /// the result of the operator Promotion of the checked<T> or integer operands A and B
+    template <template <typename, typename> class Promotion, typename A, typename B>
+    struct checked_operator : Promotion<typename checked_operand<A>::type, typename checked_operand<B>::type>
+    {
+        typedef std::integral_constant<bool, Promotion<typename checked_operand<A>::type,
+            typename checked_operand<B>::type>::fits> fits_type;
+    };
+
+    /// R holds every result, a plain operation without check
+    template <typename R, typename A, typename B>
+    constexpr R promoted_add(const A a, const B b, std::true_type) noexcept
+    {
+        return static_cast<R>(static_cast<R>(a) + static_cast<R>(b));
+    }
+
+    /// R may not hold the result, checked by the overflow builtins
+    template <typename R, typename A, typename B>
+    R promoted_add(const A a, const B b, std::false_type)
+    {
+        return checked_add<R>(a, b);
+    }
+
+    template <typename R, typename A, typename B>
+    constexpr R promoted_sub(const A a, const B b, std::true_type) noexcept
+    {
+        return static_cast<R>(static_cast<R>(a) - static_cast<R>(b));
+    }
+
+    template <typename R, typename A, typename B>
+    R promoted_sub(const A a, const B b, std::false_type)
+    {
+        return checked_sub<R>(a, b);
+    }
+
+    template <typename R, typename A, typename B>
+    constexpr R promoted_mul(const A a, const B b, std::true_type) noexcept
+    {
+        return static_cast<R>(static_cast<R>(a) * static_cast<R>(b));
+    }
+
+    template <typename R, typename A, typename B>
+    R promoted_mul(const A a, const B b, std::false_type)
+    {
+        return checked_mul<R>(a, b);
+    }
+}
+
+    /// usage `checked<int32_t> count;`, an integer whose arithmetic never overflows silently.
+    /// `a + b`, `a - b`, `a * b` and `-a` give a checked<> of a type wide enough for every result,
+    /// decided at compile time, e.g. `checked<int16_t> + checked<int16_t>` is a `checked<int32_t>`
+    /// without any check. Only if even the 64-bit type may not hold the result, e.g. for
+    /// `checked<int64_t> + checked<int64_t>`, it is checked by the overflow builtins, for `+` and `-`
+    /// in the type of the wider operand, e.g. `checked<uint64_t> - 1u` is a `checked<uint64_t>`.
+    /// `+=`, `-=`, `*=`, `++` and `--` keep T and are checked by `checked_add<T>()` etc.,
+    /// a single `jo` for a counter in a loop. The conversion out of it is by `numeric_cast<U>()`.
+    /// The comparisons are by the mathematical value, also of mixed signs
+    template <typename T>
+    class checked
+    {
+    public:
+        typedef T value_type;
+
+        constexpr checked() noexcept : value_(0) {}
+
+        /// a lossless conversion is implicit, e.g. from int16_t to checked<int32_t>
+        template <typename S,
+            typename std::enable_if<detail::is_checked_integer<S>::value
+            && detail::is_unchecked_conversion<T, S>::value, int>::type = 0>
+        constexpr checked(const S value) noexcept : value_(value) {}
+
+        /// otherwise explicit, checked by `numeric_cast<T>()`
+        template <typename S,
+            typename std::enable_if<detail::is_checked_integer<S>::value
+            && !detail::is_unchecked_conversion<T, S>::value, int>::type = 0>
+        constexpr explicit checked(const S value) : value_(numeric_cast<T>(value)) {}
+
+        template <typename S,
+            typename std::enable_if<detail::is_unchecked_conversion<T, S>::value, int>::type = 0>
+        constexpr checked(const checked<S> other) noexcept : value_(other.value()) {}
+
+        template <typename S,
+            typename std::enable_if<!detail::is_unchecked_conversion<T, S>::value, int>::type = 0>
+        constexpr explicit checked(const checked<S> other) : value_(numeric_cast<T>(other.value())) {}
+
+        constexpr T value() const noexcept
+        {
+            static_assert(detail::is_checked_integer<T>::value, "checked<T> holds an integral type, not bool");
+            return value_;
+        }
+
+        /// `static_cast<U>(c)`, as `numeric_cast<U>(c.value())`
+        template <typename U,
+            typename std::enable_if<std::is_arithmetic<U>::value, int>::type = 0>
+        constexpr explicit operator U() const
+        {
+            return numeric_cast<U>(value_);
+        }
+
+        template <typename S,
+            typename std::enable_if<detail::is_checked_integer<typename detail::checked_operand<S>::type>::value,
+            int>::type = 0>
+        checked& operator+=(const S other)
+        {
+            value_ = checked_add<T>(value_, detail::operand_value(other));
+            return *this;
+        }
+
+        template <typename S,
+            typename std::enable_if<detail::is_checked_integer<typename detail::checked_operand<S>::type>::value,
+            int>::type = 0>
+        checked& operator-=(const S other)
+        {
+            value_ = checked_sub<T>(value_, detail::operand_value(other));
+            return *this;
+        }
+
+        template <typename S,
+            typename std::enable_if<detail::is_checked_integer<typename detail::checked_operand<S>::type>::value,
+            int>::type = 0>
+        checked& operator*=(const S other)
+        {
+            value_ = checked_mul<T>(value_, detail::operand_value(other));
+            return *this;
+        }
+
+        checked& operator++()
+        {
+            value_ = checked_add<T>(value_, 1);
+            return *this;
+        }
+
+        checked& operator--()
+        {
+            value_ = checked_sub<T>(value_, 1);
+            return *this;
+        }
+
+        checked operator++(int)
+        {
+            const checked old = *this;
+            ++*this;
+            return old;
+        }
+
+        checked operator--(int)
+        {
+            const checked old = *this;
+            --*this;
+            return old;
+        }
+
+    private:
+        T value_;
+    };
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::are_checked_operands<A, B>::value, int>::type = 0>
+    constexpr checked<typename detail::checked_operator<detail::add_promotion, A, B>::type>
+    operator+(const A a, const B b)
+    {
+        return detail::promoted_add<typename detail::checked_operator<detail::add_promotion, A, B>::type>(
+            detail::operand_value(a), detail::operand_value(b),
+            typename detail::checked_operator<detail::add_promotion, A, B>::fits_type());
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::are_checked_operands<A, B>::value, int>::type = 0>
+    constexpr checked<typename detail::checked_operator<detail::sub_promotion, A, B>::type>
+    operator-(const A a, const B b)
+    {
+        return detail::promoted_sub<typename detail::checked_operator<detail::sub_promotion, A, B>::type>(
+            detail::operand_value(a), detail::operand_value(b),
+            typename detail::checked_operator<detail::sub_promotion, A, B>::fits_type());
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::are_checked_operands<A, B>::value, int>::type = 0>
+    constexpr checked<typename detail::checked_operator<detail::mul_promotion, A, B>::type>
+    operator*(const A a, const B b)
+    {
+        return detail::promoted_mul<typename detail::checked_operator<detail::mul_promotion, A, B>::type>(
+            detail::operand_value(a), detail::operand_value(b),
+            typename detail::checked_operator<detail::mul_promotion, A, B>::fits_type());
+    }
+
+    template <typename T>
+    constexpr checked<typename detail::neg_promotion<T, T>::type> operator-(const checked<T> a)
+    {
+        return detail::promoted_sub<typename detail::neg_promotion<T, T>::type>(T(0), a.value(),
+            std::integral_constant<bool, detail::neg_promotion<T, T>::fits>());
+    }
+
+    template <typename T>
+    constexpr checked<T> operator+(const checked<T> a) noexcept
+    {
+        return a;
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::are_checked_operands<A, B>::value, int>::type = 0>
+    constexpr bool operator<(const A a, const B b) noexcept
+    {
+        return detail::cmp_less(detail::operand_value(a), detail::operand_value(b));
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::are_checked_operands<A, B>::value, int>::type = 0>
+    constexpr bool operator>(const A a, const B b) noexcept
+    {
+        return detail::cmp_less(detail::operand_value(b), detail::operand_value(a));
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::are_checked_operands<A, B>::value, int>::type = 0>
+    constexpr bool operator<=(const A a, const B b) noexcept
+    {
+        return !detail::cmp_less(detail::operand_value(b), detail::operand_value(a));
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::are_checked_operands<A, B>::value, int>::type = 0>
+    constexpr bool operator>=(const A a, const B b) noexcept
+    {
+        return !detail::cmp_less(detail::operand_value(a), detail::operand_value(b));
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::are_checked_operands<A, B>::value, int>::type = 0>
+    constexpr bool operator==(const A a, const B b) noexcept
+    {
+        return detail::cmp_equal(detail::operand_value(a), detail::operand_value(b));
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::are_checked_operands<A, B>::value, int>::type = 0>
+    constexpr bool operator!=(const A a, const B b) noexcept
+    {
+        return !(a == b);
+    }
+
+    /// `numeric_cast<U>(c)` of checked<T> converts its value
+    template <typename U, typename T,
+        typename std::enable_if<std::is_arithmetic<U>::value, int>::type = 0>
+    constexpr U numeric_cast(const checked<T> c NUMERIC_CAST_LOCATION_PARAMETER)
+    {
+        return detail::numeric_cast<U, T>(c.value(), NUMERIC_CAST_LOCATION);
+    }
+
+    template <typename U, typename... Policies, typename T,
+        typename std::enable_if<std::is_arithmetic<U>::value
+        && sizeof...(Policies) != 0 && detail::are_cast_policies<Policies...>::value, int>::type = 0>
+    U numeric_cast(const checked<T> c)
+    {
+        return detail::policy_cast<U, T, Policies...>(c.value());
+    }
+
+namespace detail{
+
+    /// how overflow_accumulator computes the overflow of an operation without branch:
+    /// by the sign bits in R, if R holds both operands, by a compare in the promoted type
+    /// that holds every result, or else by the overflow builtins, which are not vectorized
+    struct in_result_type {};
+    struct in_promoted_type {};
+    struct by_overflow_builtin {};
+
+    template <template <typename, typename> class Promotion, typename R, typename A, typename B>
+    struct sticky_method : std::conditional<is_unchecked_conversion<R, A>::value
+        && is_unchecked_conversion<R, B>::value && !std::is_same<Promotion<A, B>, mul_promotion<A, B>>::value,
+        in_result_type, typename std::conditional<Promotion<A, B>::fits,
+        in_promoted_type, by_overflow_builtin>::type> {};
+
+    /// a signed sum overflows if both operands have a sign other than the result,
+    /// the sign bit of R is at `digits` also in the wider unsigned type
+    template <typename R, typename A, typename B,
+        typename std::enable_if<std::is_signed<R>::value, int>::type = 0>
+    bool sticky_add_overflow(const A a, const B b, R& result, in_result_type) noexcept
+    {
+        typedef typename wrapping_unsigned<R>::type U;
+        const U x = static_cast<U>(static_cast<R>(a));
+        const U y = static_cast<U>(static_cast<R>(b));
+        const U sum = static_cast<U>(x + y);
+        result = static_cast<R>(sum);
+        return (((x ^ sum) & (y ^ sum)) >> std::numeric_limits<R>::digits) & U(1);
+    }
+
+    template <typename R, typename A, typename B,
+        typename std::enable_if<std::is_unsigned<R>::value, int>::type = 0>
+    bool sticky_add_overflow(const A a, const B b, R& result, in_result_type) noexcept
+    {
+        typedef typename wrapping_unsigned<R>::type U;
+        result = static_cast<R>(static_cast<U>(static_cast<U>(a) + static_cast<U>(b)));
+        return result < static_cast<R>(a);
+    }
+
+    /// a signed difference overflows if the operands have different signs and the result
+    /// has not the sign of `a`
+    template <typename R, typename A, typename B,
+        typename std::enable_if<std::is_signed<R>::value, int>::type = 0>
+    bool sticky_sub_overflow(const A a, const B b, R& result, in_result_type) noexcept
+    {
+        typedef typename wrapping_unsigned<R>::type U;
+        const U x = static_cast<U>(static_cast<R>(a));
+        const U y = static_cast<U>(static_cast<R>(b));
+        const U difference = static_cast<U>(x - y);
+        result = static_cast<R>(difference);
+        return (((x ^ y) & (x ^ difference)) >> std::numeric_limits<R>::digits) & U(1);
+    }
+
+    template <typename R, typename A, typename B,
+        typename std::enable_if<std::is_unsigned<R>::value, int>::type = 0>
+    bool sticky_sub_overflow(const A a, const B b, R& result, in_result_type) noexcept
+    {
+        typedef typename wrapping_unsigned<R>::type U;
+        result = static_cast<R>(static_cast<U>(static_cast<U>(a) - static_cast<U>(b)));
+        return static_cast<R>(a) < static_cast<R>(b);
+    }
+
+    /// the exact result in the promoted type W, then a range compare as `numeric_cast<R>()`
+    template <typename R, typename W>
+    bool sticky_narrow(const W exact, R& result) noexcept
+    {
+        result = static_cast<R>(static_cast<typename wrapping_unsigned<R>::type>(exact));
+        return !convertible<R, W>(exact);
+    }
+
+    template <typename R, typename A, typename B>
+    bool sticky_add_overflow(const A a, const B b, R& result, in_promoted_type) noexcept
+    {
+        typedef typename add_promotion<A, B>::type W;
+        return sticky_narrow(static_cast<W>(static_cast<W>(a) + static_cast<W>(b)), result);
+    }
+
+    template <typename R, typename A, typename B>
+    bool sticky_sub_overflow(const A a, const B b, R& result, in_promoted_type) noexcept
+    {
+        typedef typename sub_promotion<A, B>::type W;
+        return sticky_narrow(static_cast<W>(static_cast<W>(a) - static_cast<W>(b)), result);
+    }
+
+    template <typename R, typename A, typename B>
+    bool sticky_mul_overflow(const A a, const B b, R& result, in_promoted_type) noexcept
+    {
+        typedef typename mul_promotion<A, B>::type W;
+        return sticky_narrow(static_cast<W>(static_cast<W>(a) * static_cast<W>(b)), result);
+    }
+
+    template <typename R, typename A, typename B>
+    bool sticky_add_overflow(const A a, const B b, R& result, by_overflow_builtin) noexcept
+    {
+        return add_overflow(a, b, result);
+    }
+
+    template <typename R, typename A, typename B>
+    bool sticky_sub_overflow(const A a, const B b, R& result, by_overflow_builtin) noexcept
+    {
+        return sub_overflow(a, b, result);
+    }
+
+    template <typename R, typename A, typename B>
+    bool sticky_mul_overflow(const A a, const B b, R& result, by_overflow_builtin) noexcept
+    {
+        return mul_overflow(a, b, result);
+    }
+}
+
+    /// usage `overflow_accumulator overflow; ... if (overflow) { ... }`, deferred overflow check
+    /// of a loop, as the sticky flags of floating point exceptions in <cfenv>. Its operations
+    /// never branch, each ORs its overflow into the flag, so that the loop can be vectorized,
+    /// and the flag is tested once after the loop. On failure, the loop can be run again by
+    /// `checked_add()` etc. or `numeric_cast()` to find the first bad element:
+    /// ```
+    /// std::overflow_accumulator overflow;
+    /// for (size_t i = 0; i < n; i++)
+    ///     out[i] = overflow.add(a[i], b[i]);
+    /// if (overflow)
+    ///     for (size_t i = 0; i < n; i++)
+    ///         out[i] = std::checked_add(a[i], b[i]);  // throws at the first overflow
+    /// ```
+    /// The result of an arithmetic operation out of the range of R is modulo 2^N of R,
+    /// as `overflow_policy::wrap`, a conversion out of the range of T gives 0
+    class overflow_accumulator
+    {
+    public:
+        constexpr overflow_accumulator() noexcept : overflow_(0) {}
+
+        /// the mathematical `a + b` as R, by default the common type of A and B
+        template <typename R = void, typename A, typename B,
+            typename std::enable_if<detail::is_checked_integer<A>::value
+            && detail::is_checked_integer<B>::value, int>::type = 0>
+        typename detail::checked_result<R, A, B>::type add(const A a, const B b) noexcept
+        {
+            typedef typename detail::checked_result<R, A, B>::type result_type;
+            result_type result;
+            overflow_ |= static_cast<unsigned>(detail::sticky_add_overflow(a, b, result,
+                typename detail::sticky_method<detail::add_promotion, result_type, A, B>::type()));
+            return result;
+        }
+
+        template <typename R = void, typename A, typename B,
+            typename std::enable_if<detail::is_checked_integer<A>::value
+            && detail::is_checked_integer<B>::value, int>::type = 0>
+        typename detail::checked_result<R, A, B>::type sub(const A a, const B b) noexcept
+        {
+            typedef typename detail::checked_result<R, A, B>::type result_type;
+            result_type result;
+            overflow_ |= static_cast<unsigned>(detail::sticky_sub_overflow(a, b, result,
+                typename detail::sticky_method<detail::sub_promotion, result_type, A, B>::type()));
+            return result;
+        }
+
+        template <typename R = void, typename A, typename B,
+            typename std::enable_if<detail::is_checked_integer<A>::value
+            && detail::is_checked_integer<B>::value, int>::type = 0>
+        typename detail::checked_result<R, A, B>::type mul(const A a, const B b) noexcept
+        {
+            typedef typename detail::checked_result<R, A, B>::type result_type;
+            result_type result;
+            overflow_ |= static_cast<unsigned>(detail::sticky_mul_overflow(a, b, result,
+                typename detail::sticky_method<detail::mul_promotion, result_type, A, B>::type()));
+            return result;
+        }
+
+        /// `numeric_cast<T>(value)` of arithmetic types, NaN is out of range.
+        /// The value is selected before the conversion, which is undefined behaviour out of range
+        template <typename T, typename S,
+            typename std::enable_if<std::is_arithmetic<T>::value && std::is_arithmetic<S>::value, int>::type = 0>
+        T cast(const S value) noexcept
+        {
+            const bool in_range = detail::convertible<T, S>(value);
+            overflow_ |= static_cast<unsigned>(!in_range);
+            return static_cast<T>(in_range ? value : S(0));
+        }
+
+        /// true if any operation since the construction or `clear()` overflowed
+        bool overflowed() const noexcept
+        {
+            return overflow_ != 0;
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return overflow_ != 0;
+        }
+
+        void clear() noexcept
+        {
+            overflow_ = 0;
+        }
+
+        /// the flag of another accumulator, e.g. of a chunk run by another thread
+        overflow_accumulator& operator|=(const overflow_accumulator& other) noexcept
+        {
+            overflow_ |= other.overflow_;
+            return *this;
+        }
+
+    private:
+        unsigned overflow_;  // not bool, an OR reduction of bool is not vectorized by GCC
+    };
+}
@@ -0,0 +1,614 @@
+/***********************************************************
+//              copyright Qingfeng Xia, 2020
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+************************************************************/
+
+/**
+* overflow-safe reductions of integer arrays, this is a header-only library
+*
+* `std::checked_reduce_sum<R>(in, n)` and `std::checked_dot<R>(a, b, n)` compute the exact
+* sum and dot product in 64-bit lanes, with a count of the carries out of each lane,
+* i.e. a 128-bit accumulator, and convert the result to R only at the end by `numeric_cast<R>()`,
+* so that a partial sum out of the range of R is not an error, but the result is never wrapped.
+* ```
+* int32_t total = std::checked_reduce_sum(column.data(), column.size());  // throws std::overflow_error
+* int64_t energy = std::checked_dot<int64_t>(x.data(), x.data(), x.size());
+* ```
+* For `int32_t`, the elements are sign-extended into int64_t lanes, for `int64_t`, each lane
+* counts its signed overflow without branch. These kernels are AVX2 and AVX-512, selected
+* at runtime in the same way as those of numeric_cast_bulk.h, other types and CPUs use
+* a branch-free loop the compiler can vectorize.
+*
+* `std::checked_inclusive_scan<T>(in, out, n)` gives every prefix sum as T, checked by
+* an `overflow_accumulator` per block, and throws at the first prefix out of range.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "checked_arithmetic.h"
+#include "numeric_cast_bulk.h"
+
+namespace std {
+
+namespace detail{
+
+    /// the exact value `sum + wraps * 2^64` of a reduction: `sum` is modulo 2^64 as W,
+    /// `wraps` counts the overflows of `sum`, +1 above max and -1 below lowest
+    template <typename W>
+    struct wide_sum
+    {
+        W sum;
+        int64_t wraps;
+    };
+
+    /// int64_t lanes for signed, uint64_t lanes for unsigned elements
+    template <typename S>
+    struct reduce_type : std::conditional<std::is_signed<S>::value, int64_t, uint64_t> {};
+
+    /// elements reduced by one kernel call, the int32_t lanes of the SIMD kernels can not overflow
+    const size_t reduce_block_size = size_t(1) << 24;
+
+    /// a signed sum overflows if both operands have a sign other than the result,
+    /// toward the sign of `x`, without branch so that a loop of it can be vectorized
+    inline void wide_add(wide_sum<int64_t>& total, const int64_t x) noexcept
+    {
+        const uint64_t sum = static_cast<uint64_t>(total.sum) + static_cast<uint64_t>(x);
+        const uint64_t overflow = ((static_cast<uint64_t>(total.sum) ^ sum) & (static_cast<uint64_t>(x) ^ sum)) >> 63;
+        const uint64_t negative = static_cast<uint64_t>(x) >> 63;
+        total.wraps += static_cast<int64_t>(overflow) - 2 * static_cast<int64_t>(overflow & negative);
+        total.sum = static_cast<int64_t>(sum);
+    }
+
+    inline void wide_add(wide_sum<uint64_t>& total, const uint64_t x) noexcept
+    {
+        total.sum += x;
+        total.wraps += static_cast<int64_t>(total.sum < x);
+    }
+
+    /// `wraps + x`, saturated at the limits of int64_t, where it then stays: such a sum is
+    /// at least 2^127, out of the range of any R, and must not come back into the range by
+    /// later terms of the other sign. `narrow_sum()` applies the overflow policy to it
+    template <typename X>
+    int64_t add_wraps(const int64_t wraps, const X x) noexcept
+    {
+        return wraps == INT64_MAX || wraps == INT64_MIN ? wraps
+            : checked_add<int64_t, overflow_policy::saturate>(wraps, x);
+    }
+
+    /// the sum of two partial reductions
+    template <typename W>
+    void wide_add(wide_sum<W>& total, const wide_sum<W>& other) noexcept
+    {
+        wide_sum<W> low = {total.sum, 0};
+        wide_add(low, other.sum);
+        total.sum = low.sum;
+        total.wraps = add_wraps(add_wraps(total.wraps, other.wraps), low.wraps);
+    }
+
+    /// a value out of the range of integral R, of the sign of `wraps`: the exact value is at least 2^63
+    /// in magnitude, it is not converted, as it rounds into the range of int64_t if `long double` is double
+    template <typename R, typename W,
+        typename std::enable_if<std::is_integral<R>::value && (std::numeric_limits<R>::digits <= 64), int>::type = 0>
+    long double wide_value(const wide_sum<W> total) noexcept
+    {
+        return std::ldexp(total.wraps < 0 ? -1.0L : 1.0L, 64);
+    }
+
+    /// floating point or wider R, e.g. __int128, the exact value as far as `long double` holds it
+    template <typename R, typename W,
+        typename std::enable_if<!std::is_integral<R>::value || (std::numeric_limits<R>::digits > 64), int>::type = 0>
+    long double wide_value(const wide_sum<W> total) noexcept
+    {
+        return std::ldexp(static_cast<long double>(total.wraps), 64) + static_cast<long double>(total.sum);
+    }
+
+    /// `numeric_cast<R>()` of the exact value: as W if `wraps` is 0, as uint64_t if it is in
+    /// [2^63, 2^64), otherwise as `wide_value()`
+    template <typename R, typename... Policies>
+    R narrow_sum(const wide_sum<int64_t> total)
+    {
+        return total.wraps == 0 ? std::numeric_cast<R, Policies...>(total.sum)
+            : (total.wraps == 1 && total.sum < 0)
+            ? std::numeric_cast<R, Policies...>(static_cast<uint64_t>(total.sum))
+            : std::numeric_cast<R, Policies...>(wide_value<R>(total));
+    }
+
+    template <typename R, typename... Policies>
+    R narrow_sum(const wide_sum<uint64_t> total)
+    {
+        return total.wraps == 0 ? std::numeric_cast<R, Policies...>(total.sum)
+            : std::numeric_cast<R, Policies...>(wide_value<R>(total));
+    }
+
+    /// portable kernels, the compiler can vectorize them
+    template <typename S>
+    wide_sum<typename reduce_type<S>::type> reduce_sum_generic(const S* in, size_t n) noexcept
+    {
+        typedef typename reduce_type<S>::type W;
+        wide_sum<W> total = {W(0), 0};
+        for (size_t i = 0; i < n; i++)
+        {
+            wide_add(total, static_cast<W>(in[i]));
+        }
+        return total;
+    }
+
+    /// the product of elements up to 32 bits is exact in 64 bits
+    template <typename S,
+        typename std::enable_if<(std::numeric_limits<S>::digits <= 32), int>::type = 0>
+    wide_sum<typename reduce_type<S>::type> reduce_dot_generic(const S* a, const S* b, size_t n)
+    {
+        typedef typename reduce_type<S>::type W;
+        wide_sum<W> total = {W(0), 0};
+        for (size_t i = 0; i < n; i++)
+        {
+            wide_add(total, static_cast<W>(static_cast<W>(a[i]) * static_cast<W>(b[i])));
+        }
+        return total;
+    }
+
+    /// the 128-bit product `high * 2^64 + low` of 64-bit integers, returns `low`
+    inline uint64_t mul_wide(const uint64_t a, const uint64_t b, uint64_t& high) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        high = static_cast<uint64_t>(product >> 64);
+        return static_cast<uint64_t>(product);
+#else
+        // the four products of the 32-bit halves, `cross` can not overflow
+        const uint64_t lo_lo = (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu);
+        const uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFFu);
+        const uint64_t lo_hi = (a & 0xFFFFFFFFu) * (b >> 32);
+        const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+        high = (a >> 32) * (b >> 32) + (hi_lo >> 32) + (cross >> 32);
+        return (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+#endif
+    }
+
+    /// the signed product is the unsigned one, less `b * 2^64` if `a` is negative and vice versa,
+    /// `high` is counted toward the signed `low` as `wide_sum<int64_t>`
+    inline int64_t mul_wide(const int64_t a, const int64_t b, int64_t& high) noexcept
+    {
+        uint64_t h = 0;
+        const uint64_t low = mul_wide(static_cast<uint64_t>(a), static_cast<uint64_t>(b), h);
+        h -= (a < 0 ? static_cast<uint64_t>(b) : 0) + (b < 0 ? static_cast<uint64_t>(a) : 0);
+        h += low >> 63;
+        high = static_cast<int64_t>(h);
+        return static_cast<int64_t>(low);
+    }
+
+    /// the low 64 bits of the products are added with carry, the high 64 bits are added
+    /// exactly in a second wide_sum, then to `wraps`
+    template <typename S,
+        typename std::enable_if<(std::numeric_limits<S>::digits > 32), int>::type = 0>
+    wide_sum<typename reduce_type<S>::type> reduce_dot_generic(const S* a, const S* b, size_t n) noexcept
+    {
+        typedef typename reduce_type<S>::type W;
+        wide_sum<W> total = {W(0), 0};
+        wide_sum<W> high = {W(0), 0};
+        for (size_t i = 0; i < n; i++)
+        {
+            W product_high = 0;
+            wide_add(total, mul_wide(static_cast<W>(a[i]), static_cast<W>(b[i]), product_high));
+            wide_add(high, product_high);
+        }
+        total.wraps = high.wraps != 0 ? (high.wraps > 0 ? INT64_MAX : INT64_MIN)
+            : add_wraps(add_wraps(0, high.sum), total.wraps);
+        return total;
+    }
+
+#if defined(__AVX2__) || NUMERIC_CAST_DISPATCH
+NUMERIC_CAST_SIMD_WARNINGS_PUSH
+    namespace simd_avx2 {
+
+    /// the lanes of the accumulators are added into a wide_sum by the scalar wide_add()
+    NUMERIC_CAST_TARGET("avx2") inline void add_lanes(wide_sum<int64_t>& total, const __m256i sum,
+                                                      const __m256i wraps)
+    {
+        int64_t sums[4];
+        int64_t counts[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(sums), sum);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(counts), wraps);
+        for (int k = 0; k < 4; k++)
+        {
+            wide_add(total, sums[k]);
+            total.wraps += counts[k];
+        }
+    }
+
+    /// wide_add() of 4 lanes, there is no 64-bit arithmetic shift, the signs are compared with 0
+    NUMERIC_CAST_TARGET("avx2") inline void wide_add_epi64(__m256i& sum, __m256i& wraps, const __m256i x) noexcept
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i s = _mm256_add_epi64(sum, x);
+        const __m256i overflow = _mm256_cmpgt_epi64(zero,
+            _mm256_and_si256(_mm256_xor_si256(sum, s), _mm256_xor_si256(x, s)));
+        const __m256i below = _mm256_and_si256(overflow, _mm256_cmpgt_epi64(zero, x));
+        wraps = _mm256_add_epi64(_mm256_sub_epi64(wraps, overflow), _mm256_add_epi64(below, below));
+        sum = s;
+    }
+
+    /// sign-extended into int64_t lanes, at most reduce_block_size elements
+    NUMERIC_CAST_TARGET("avx2") inline wide_sum<int64_t> reduce_sum(const int32_t* in, size_t n)
+    {
+        __m256i s0 = _mm256_setzero_si256();
+        __m256i s1 = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm256_add_epi64(s0, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+            s1 = _mm256_add_epi64(s1, _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 4))));
+        }
+        wide_sum<int64_t> total = reduce_sum_generic(in + i, n - i);
+        add_lanes(total, _mm256_add_epi64(s0, s1), _mm256_setzero_si256());
+        return total;
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline wide_sum<int64_t> reduce_sum(const int64_t* in, size_t n)
+    {
+        __m256i s0 = _mm256_setzero_si256();
+        __m256i s1 = _mm256_setzero_si256();
+        __m256i w0 = _mm256_setzero_si256();
+        __m256i w1 = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            wide_add_epi64(s0, w0, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)));
+            wide_add_epi64(s1, w1, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 4)));
+        }
+        wide_sum<int64_t> total = reduce_sum_generic(in + i, n - i);
+        add_lanes(total, s0, w0);
+        add_lanes(total, s1, w1);
+        return total;
+    }
+
+    /// vpmuldq multiplies the even int32_t lanes into int64_t, the odd ones are shifted down first
+    NUMERIC_CAST_TARGET("avx2") inline wide_sum<int64_t> reduce_dot(const int32_t* a, const int32_t* b, size_t n)
+    {
+        __m256i s0 = _mm256_setzero_si256();
+        __m256i s1 = _mm256_setzero_si256();
+        __m256i w0 = _mm256_setzero_si256();
+        __m256i w1 = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            wide_add_epi64(s0, w0, _mm256_mul_epi32(x, y));
+            wide_add_epi64(s1, w1, _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32)));
+        }
+        wide_sum<int64_t> total = reduce_dot_generic(a + i, b + i, n - i);
+        add_lanes(total, s0, w0);
+        add_lanes(total, s1, w1);
+        return total;
+    }
+
+    }  // namespace simd_avx2
+NUMERIC_CAST_SIMD_WARNINGS_POP
+#endif
+
+#if defined(__AVX512F__) || NUMERIC_CAST_DISPATCH
+NUMERIC_CAST_SIMD_WARNINGS_PUSH
+    namespace simd_avx512 {
+
+    NUMERIC_CAST_TARGET("avx512f") inline void add_lanes(wide_sum<int64_t>& total, const __m512i sum,
+                                                         const __m512i wraps)
+    {
+        int64_t sums[8];
+        int64_t counts[8];
+        _mm512_storeu_si512(sums, sum);
+        _mm512_storeu_si512(counts, wraps);
+        for (int k = 0; k < 8; k++)
+        {
+            wide_add(total, sums[k]);
+            total.wraps += counts[k];
+        }
+    }
+
+    /// wide_add() of 8 lanes, the signs by vpsraq
+    NUMERIC_CAST_TARGET("avx512f") inline void wide_add_epi64(__m512i& sum, __m512i& wraps, const __m512i x) noexcept
+    {
+        const __m512i s = _mm512_add_epi64(sum, x);
+        const __m512i overflow = _mm512_srai_epi64(
+            _mm512_and_si512(_mm512_xor_si512(sum, s), _mm512_xor_si512(x, s)), 63);
+        const __m512i below = _mm512_and_si512(overflow, _mm512_srai_epi64(x, 63));
+        wraps = _mm512_add_epi64(_mm512_sub_epi64(wraps, overflow), _mm512_add_epi64(below, below));
+        sum = s;
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline wide_sum<int64_t> reduce_sum(const int32_t* in, size_t n)
+    {
+        __m512i s0 = _mm512_setzero_si512();
+        __m512i s1 = _mm512_setzero_si512();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm512_add_epi64(s0, _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i))));
+            s1 = _mm512_add_epi64(s1, _mm512_cvtepi32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8))));
+        }
+        wide_sum<int64_t> total = reduce_sum_generic(in + i, n - i);
+        add_lanes(total, _mm512_add_epi64(s0, s1), _mm512_setzero_si512());
+        return total;
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline wide_sum<int64_t> reduce_sum(const int64_t* in, size_t n)
+    {
+        __m512i s0 = _mm512_setzero_si512();
+        __m512i s1 = _mm512_setzero_si512();
+        __m512i w0 = _mm512_setzero_si512();
+        __m512i w1 = _mm512_setzero_si512();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            wide_add_epi64(s0, w0, _mm512_loadu_si512(in + i));
+            wide_add_epi64(s1, w1, _mm512_loadu_si512(in + i + 8));
+        }
+        wide_sum<int64_t> total = reduce_sum_generic(in + i, n - i);
+        add_lanes(total, s0, w0);
+        add_lanes(total, s1, w1);
+        return total;
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline wide_sum<int64_t> reduce_dot(const int32_t* a, const int32_t* b, size_t n)
+    {
+        __m512i s0 = _mm512_setzero_si512();
+        __m512i s1 = _mm512_setzero_si512();
+        __m512i w0 = _mm512_setzero_si512();
+        __m512i w1 = _mm512_setzero_si512();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512i x = _mm512_loadu_si512(a + i);
+            const __m512i y = _mm512_loadu_si512(b + i);
+            wide_add_epi64(s0, w0, _mm512_mul_epi32(x, y));
+            wide_add_epi64(s1, w1, _mm512_mul_epi32(_mm512_srli_epi64(x, 32), _mm512_srli_epi64(y, 32)));
+        }
+        wide_sum<int64_t> total = reduce_dot_generic(a + i, b + i, n - i);
+        add_lanes(total, s0, w0);
+        add_lanes(total, s1, w1);
+        return total;
+    }
+
+    }  // namespace simd_avx512
+NUMERIC_CAST_SIMD_WARNINGS_POP
+#endif
+
+    /// sum of int32_t and int64_t elements, selected in the same way as bulk_simd_kernel,
+    /// SSE2 has neither vpmovsxdq nor vpcmpgtq, it uses the portable loop
+    template <typename S>
+    struct bulk_simd_sum_kernel
+    {
+#if NUMERIC_CAST_DISPATCH
+        typedef wide_sum<int64_t> (*sum_fn)(const S*, size_t);
+
+        static sum_fn select_sum() noexcept
+        {
+            switch (cpu_simd_level())
+            {
+            case simd_level::avx512: return simd_avx512::reduce_sum;
+            case simd_level::avx2: return simd_avx2::reduce_sum;
+            default: return reduce_sum_generic<S>;
+            }
+        }
+
+        static std::atomic<sum_fn> sum_ptr;
+
+        static wide_sum<int64_t> resolve_sum(const S* in, size_t n)
+        {
+            const sum_fn f = select_sum();
+            sum_ptr.store(f, std::memory_order_relaxed);
+            return f(in, n);
+        }
+
+        static wide_sum<int64_t> reduce_sum(const S* in, size_t n)
+        {
+            return sum_ptr.load(std::memory_order_relaxed)(in, n);
+        }
+#elif defined(__AVX2__) || defined(__AVX512F__)
+        static wide_sum<int64_t> reduce_sum(const S* in, size_t n)
+        {
+            return simd_native::reduce_sum(in, n);
+        }
+#else
+        static wide_sum<int64_t> reduce_sum(const S* in, size_t n)
+        {
+            return reduce_sum_generic<S>(in, n);
+        }
+#endif
+    };
+
+    /// dot product of int32_t elements, selected in the same way as bulk_simd_sum_kernel
+    template <typename S>
+    struct bulk_simd_dot_kernel
+    {
+#if NUMERIC_CAST_DISPATCH
+        typedef wide_sum<int64_t> (*dot_fn)(const S*, const S*, size_t);
+
+        static dot_fn select_dot() noexcept
+        {
+            switch (cpu_simd_level())
+            {
+            case simd_level::avx512: return simd_avx512::reduce_dot;
+            case simd_level::avx2: return simd_avx2::reduce_dot;
+            default: return reduce_dot_generic<S>;
+            }
+        }
+
+        static std::atomic<dot_fn> dot_ptr;
+
+        static wide_sum<int64_t> resolve_dot(const S* a, const S* b, size_t n)
+        {
+            const dot_fn f = select_dot();
+            dot_ptr.store(f, std::memory_order_relaxed);
+            return f(a, b, n);
+        }
+
+        static wide_sum<int64_t> reduce_dot(const S* a, const S* b, size_t n)
+        {
+            return dot_ptr.load(std::memory_order_relaxed)(a, b, n);
+        }
+#elif defined(__AVX2__) || defined(__AVX512F__)
+        static wide_sum<int64_t> reduce_dot(const S* a, const S* b, size_t n)
+        {
+            return simd_native::reduce_dot(a, b, n);
+        }
+#else
+        static wide_sum<int64_t> reduce_dot(const S* a, const S* b, size_t n)
+        {
+            return reduce_dot_generic<S>(a, b, n);
+        }
+#endif
+    };
+
+#if NUMERIC_CAST_DISPATCH
+    template <typename S>
+    std::atomic<typename bulk_simd_sum_kernel<S>::sum_fn>
+        bulk_simd_sum_kernel<S>::sum_ptr(&bulk_simd_sum_kernel<S>::resolve_sum);
+
+    template <typename S>
+    std::atomic<typename bulk_simd_dot_kernel<S>::dot_fn>
+        bulk_simd_dot_kernel<S>::dot_ptr(&bulk_simd_dot_kernel<S>::resolve_dot);
+#endif
+
+    /// element types without a SIMD kernel use the portable loops
+    template <typename S>
+    struct bulk_generic_sum_kernel
+    {
+        static wide_sum<typename reduce_type<S>::type> reduce_sum(const S* in, size_t n)
+        {
+            return reduce_sum_generic<S>(in, n);
+        }
+    };
+
+    template <typename S>
+    struct bulk_generic_dot_kernel
+    {
+        static wide_sum<typename reduce_type<S>::type> reduce_dot(const S* a, const S* b, size_t n)
+        {
+            return reduce_dot_generic<S>(a, b, n);
+        }
+    };
+
+    template <typename S>
+    struct bulk_reduce_kernel : bulk_generic_sum_kernel<S>, bulk_generic_dot_kernel<S> {};
+
+    template <> struct bulk_reduce_kernel<int32_t> : bulk_simd_sum_kernel<int32_t>, bulk_simd_dot_kernel<int32_t> {};
+    template <> struct bulk_reduce_kernel<int64_t> : bulk_simd_sum_kernel<int64_t>, bulk_generic_dot_kernel<int64_t> {};
+}
+
+    /// the sum of `n` integers, usage `int32_t total = checked_reduce_sum(in, n);`. The sum is exact,
+    /// then converted to R, by default S, by `numeric_cast<R, Policies...>()`, so only the result is
+    /// checked, e.g. `checked_reduce_sum<int64_t>(in, n)` of int32_t never fails,
+    /// `checked_reduce_sum<int16_t, overflow_policy::saturate>(in, n)` is clamped
+    template <typename R = void, typename... Policies, typename S,
+        typename std::enable_if<detail::is_checked_integer<S>::value
+        && detail::are_cast_policies<Policies...>::value, int>::type = 0>
+    typename detail::checked_result<R, S, S>::type checked_reduce_sum(const S* in, size_t n)
+    {
+        typedef typename detail::reduce_type<S>::type W;
+        detail::wide_sum<W> total = {W(0), 0};
+        for (size_t i = 0; i < n; i += detail::reduce_block_size)
+        {
+            const size_t m = n - i < detail::reduce_block_size ? n - i : detail::reduce_block_size;
+            detail::wide_add(total, detail::bulk_reduce_kernel<S>::reduce_sum(in + i, m));
+        }
+        return detail::narrow_sum<typename detail::checked_result<R, S, S>::type, Policies...>(total);
+    }
+
+    /// the dot product `a[0] * b[0] + ... + a[n - 1] * b[n - 1]`, exact then converted to R as
+    /// `checked_reduce_sum()`. For 64-bit elements, a partial sum of 2^127 or more is taken as
+    /// out of range, even if later products would bring the dot product back into the range
+    template <typename R = void, typename... Policies, typename S,
+        typename std::enable_if<detail::is_checked_integer<S>::value
+        && detail::are_cast_policies<Policies...>::value, int>::type = 0>
+    typename detail::checked_result<R, S, S>::type checked_dot(const S* a, const S* b, size_t n)
+    {
+        typedef typename detail::reduce_type<S>::type W;
+        detail::wide_sum<W> total = {W(0), 0};
+        for (size_t i = 0; i < n; i += detail::reduce_block_size)
+        {
+            const size_t m = n - i < detail::reduce_block_size ? n - i : detail::reduce_block_size;
+            detail::wide_add(total, detail::bulk_reduce_kernel<S>::reduce_dot(a + i, b + i, m));
+        }
+        return detail::narrow_sum<typename detail::checked_result<R, S, S>::type, Policies...>(total);
+    }
+
+    /// the prefix sums `out[i] = in[0] + ... + in[i]` as T, by default S, usage
+    /// `checked_inclusive_scan(in, out, n);`. Each block is summed with an overflow_accumulator,
+    /// only a block with a prefix out of the range of T is summed again by `checked_add<T, Policies...>()`,
+    /// which throws at the offending element by default: the elements before it hold their prefix sums,
+    /// the following ones of its block hold wrapped prefix sums. `in` and `out` may be the same array,
+    /// each block of inputs is kept for the slow path. Returns `out + n` as `std::inclusive_scan()`
+    template <typename T = void, typename... Policies, typename S,
+        typename std::enable_if<detail::is_checked_integer<S>::value
+        && detail::are_overflow_policies<Policies...>::value, int>::type = 0>
+    typename detail::checked_result<T, S, S>::type* checked_inclusive_scan(const S* in,
+        typename detail::checked_result<T, S, S>::type* out, size_t n)
+    {
+        typedef typename detail::checked_result<T, S, S>::type result_type;
+        result_type sum = result_type(0);
+        S block[detail::bulk_block_size];
+        for (size_t i = 0; i < n; i += detail::bulk_block_size)
+        {
+            const size_t m = n - i < detail::bulk_block_size ? n - i : detail::bulk_block_size;
+            overflow_accumulator overflow;
+            result_type s = sum;
+            for (size_t j = 0; j < m; j++)
+            {
+                block[j] = in[i + j];
+                s = overflow.add<result_type>(s, block[j]);
+                out[i + j] = s;
+            }
+            if (overflow)
+            {
+                // slow path, only for the block with a prefix out of range
+                s = sum;
+                for (size_t j = 0; j < m; j++)
+                {
+                    s = checked_add<result_type, Policies...>(s, block[j]);
+                    out[i + j] = s;
+                }
+            }
+            sum = s;
+        }
+        return out + n;
+    }
+
+#if __cplusplus > 201703L  && __has_include(<span>)  // C++20
+    /// span versions
+    template <typename R = void, typename... Policies, typename S, size_t Extent>
+    typename detail::checked_result<R, typename std::remove_cv<S>::type, typename std::remove_cv<S>::type>::type
+    checked_reduce_sum(span<S, Extent> in)
+    {
+        return checked_reduce_sum<R, Policies...>(in.data(), in.size());
+    }
+
+    /// `a` and `b` must have the same size
+    template <typename R = void, typename... Policies, typename S, size_t AExtent, size_t BExtent>
+    typename detail::checked_result<R, typename std::remove_cv<S>::type, typename std::remove_cv<S>::type>::type
+    checked_dot(span<S, AExtent> a, span<S, BExtent> b)
+    {
+        if (a.size() != b.size())
+            detail::throw_span_size_error("spans of the dot product have different sizes");
+        return checked_dot<R, Policies...>(a.data(), b.data(), a.size());
+    }
+
+    /// `out` must have at least as many elements as `in`
+    template <typename T = void, typename... Policies, typename S, size_t InExtent, typename U, size_t OutExtent>
+    span<U, OutExtent> checked_inclusive_scan(span<S, InExtent> in, span<U, OutExtent> out)
+    {
+        if (out.size() < in.size())
+            detail::throw_span_size_error("output span is smaller than the input span");
+        checked_inclusive_scan<typename std::conditional<std::is_void<T>::value, U, T>::type, Policies...>(
+            in.data(), out.data(), in.size());
+        return out;
+    }
+#endif
+
+}
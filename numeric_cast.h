@@ -11,117 +11,1886 @@
 
 #pragma once
 
+#include <atomic>  // the failure handler
+#include <cmath>
+#include <cstdio>  // snprintf into the buffer of numeric_cast_error
+#include <exception> // for std::terminate
 #include <limits>
 #include <stdexcept> // for std::overflow_error
 #include <type_traits>
+#include <utility>  // std::cmp_less() etc. since C++20
 
 #if __cplusplus >= 201703L
 #include <cstddef>
 #endif
 
+#if __cplusplus > 201703L && defined(__has_include)
+#if __has_include(<source_location>)
+#include <source_location>
+#endif
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <cstdint>
+#include <emmintrin.h>  // SSE2 scalar min/max for saturate_cast
+#endif
+
+/// tell the optimizer that `cond` holds, undefined behaviour if it does not
+#if defined(__has_cpp_attribute)
+#if __has_cpp_attribute(assume) >= 202207L
+#define NUMERIC_CAST_ASSUME(cond) [[assume(cond)]]
+#endif
+#endif
+#ifndef NUMERIC_CAST_ASSUME
+#if defined(__GNUC__) || defined(__clang__)
+#define NUMERIC_CAST_ASSUME(cond) ((cond) ? static_cast<void>(0) : __builtin_unreachable())
+#elif defined(_MSC_VER)
+#define NUMERIC_CAST_ASSUME(cond) __assume(cond)
+#else
+#define NUMERIC_CAST_ASSUME(cond) static_cast<void>(0)
+#endif
+#endif
+
+/// inlined also without optimization, for the conversions compiled to a bare `static_cast`
+#if defined(__GNUC__) || defined(__clang__)
+#define NUMERIC_CAST_ALWAYS_INLINE __attribute__((always_inline)) inline
+#elif defined(_MSC_VER)
+#define NUMERIC_CAST_ALWAYS_INLINE __forceinline
+#else
+#define NUMERIC_CAST_ALWAYS_INLINE inline
+#endif
+
+/// out of line and in a cold section, for the functions that report a failure
+#if defined(__GNUC__) || defined(__clang__)
+#define NUMERIC_CAST_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define NUMERIC_CAST_COLD __declspec(noinline)
+#else
+#define NUMERIC_CAST_COLD
+#endif
+
+/// a failure is passed to the failure handler, see `set_numeric_cast_failure_handler()`,
+/// and the conversion gives a fallback value instead of throwing.
+/// The default without exception support, e.g. `-fno-exceptions`, no `throw` is compiled then
+#ifndef NUMERIC_CAST_NO_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define NUMERIC_CAST_NO_EXCEPTIONS 0
+#else
+#define NUMERIC_CAST_NO_EXCEPTIONS 1
+#endif
+#endif
+
+/// since C++20, the checked conversions take the `std::source_location` of the call
+/// as a defaulted last parameter, given to the failure handler
+#if defined(__cpp_lib_source_location) && __cpp_lib_source_location >= 201907L
+#define NUMERIC_CAST_HAS_SOURCE_LOCATION 1
+#define NUMERIC_CAST_LOCATION_PARAMETER , const std::source_location location = std::source_location::current()
+#define NUMERIC_CAST_LOCATION detail::numeric_cast_site(location)
+#else
+#define NUMERIC_CAST_LOCATION_PARAMETER
+#define NUMERIC_CAST_LOCATION detail::numeric_cast_site()
+#endif
+
+/// Define NUMERIC_CAST_STATS to count the checked conversions per type pair, and
+/// NUMERIC_CAST_HEADROOM_SAMPLING=N to sample the headroom of 1 in N conversions, see numeric_cast_stats.h.
+/// They must be defined for the whole program, the counting is skipped in constant expression
+#if NUMERIC_CAST_STATS || NUMERIC_CAST_HEADROOM_SAMPLING
+#define NUMERIC_CAST_INSTRUMENTED 1
+#endif
+
+/// The range check of `numeric_cast`, `to_integer`, `to_unsigned` and `to_enum`, for the whole program:
+/// NUMERIC_CAST_MODE_CHECKED (the default) throws or reports every failure,
+/// NUMERIC_CAST_MODE_ASSUME takes the check as a hint to the optimizer, undefined behaviour if it fails,
+/// NUMERIC_CAST_MODE_SAMPLED checks 1 in NUMERIC_CAST_MODE_SAMPLING conversions of each thread and assumes the rest.
+/// A constant expression is always checked. `try_numeric_cast` and the policies other than
+/// `throw_on_overflow` are not changed
+#define NUMERIC_CAST_MODE_CHECKED 0
+#define NUMERIC_CAST_MODE_ASSUME 1
+#define NUMERIC_CAST_MODE_SAMPLED 2
+#ifndef NUMERIC_CAST_MODE
+#define NUMERIC_CAST_MODE NUMERIC_CAST_MODE_CHECKED
+#endif
+#ifndef NUMERIC_CAST_MODE_SAMPLING
+#define NUMERIC_CAST_MODE_SAMPLING 1024
+#endif
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define NUMERIC_CAST_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+#if !defined(NUMERIC_CAST_CONSTANT_EVALUATED) \
+    && ((defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925))
+#define NUMERIC_CAST_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#ifndef NUMERIC_CAST_CONSTANT_EVALUATED
+#define NUMERIC_CAST_CONSTANT_EVALUATED() false  // the counted and sampled conversions are not constexpr
+#endif
+
 /// it is safe to inject into std namespace
 namespace std {
 
-namespace detail{
+namespace detail{
+
+#if __cplusplus < 201703L
+    // void_t is not defined until C++17
+    template<class...> struct make_void { using type = void; };
+    template<class... Ts> using void_t = typename make_void<Ts...>::type;
+#endif
+
+    template<class T, class = void>
+    struct supports_arithmetic_operations : std::false_type {};
+    
+    template<class T>
+    struct supports_arithmetic_operations<T, 
+               void_t<decltype(std::declval<T>() + std::declval<T>()),
+                      decltype(std::declval<T>() - std::declval<T>()),
+                      decltype(std::declval<T>() * std::declval<T>()),
+                      decltype(std::declval<T>() / std::declval<T>())>> 
+           : std::true_type {};
+
+    /// type_trait to test if numeric_limits<T> is instantiatable
+    template<class T, class = void>
+    struct _is_numeric : std::false_type {};
+    
+    template<class T>
+    struct _is_numeric<T, 
+               void_t<decltype(std::numeric_limits<T>::max()),
+               decltype(std::numeric_limits<T>::min())>> 
+           : std::true_type {};
+ 
+    /// exact range of floating point S convertible to integral T, for every pair:
+    /// `lower()` and `upper()` are the lowest and the largest value of S inside [min(), max()].
+    /// `value <= numeric_limits<T>::max()` is not exact if T has more digits than S,
+    /// max() is rounded up to `limit()`, e.g. 2^63 for int64_t from double, which passes.
+    /// `max() / 2 + 1` and min() are powers of two, exact in S, and the predecessor of
+    /// `limit()` in S is `limit() * (1 - epsilon / 2)`, e.g. 2^63 - 1024 for int64_t from double
+    template <typename T, typename S>
+    struct float_int_bounds
+    {
+        static_assert(std::is_integral<T>::value && std::is_floating_point<S>::value,
+                      "float_int_bounds<T, S> is for integral T and floating point S");
+
+        /// the first integer above max(), 2^digits
+        static constexpr S limit() noexcept
+        {
+            return static_cast<S>(std::numeric_limits<T>::max() / 2 + 1) * S(2);
+        }
+
+        static constexpr S upper() noexcept
+        {
+            return std::numeric_limits<T>::digits <= std::numeric_limits<S>::digits
+                ? static_cast<S>(std::numeric_limits<T>::max())
+                : limit() - limit() * (std::numeric_limits<S>::epsilon() / 2);
+        }
+
+        static constexpr S lower() noexcept
+        {
+            return static_cast<S>(std::numeric_limits<T>::min());
+        }
+    };
+
+    /// `cmp_less(a, b)` of C++20 for C++11: integer comparison by the mathematical value,
+    /// without the unsigned conversion of mixed-sign `a < b`, e.g. `cmp_less(-1, 0u)` is true
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value
+        && std::is_signed<A>::value == std::is_signed<B>::value, int>::type = 0>
+    constexpr bool cmp_less(const A a, const B b) noexcept
+    {
+        return a < b;
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value
+        && std::is_signed<A>::value && std::is_unsigned<B>::value, int>::type = 0>
+    constexpr bool cmp_less(const A a, const B b) noexcept
+    {
+        return a < 0 || static_cast<typename std::make_unsigned<A>::type>(a) < b;
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value
+        && std::is_unsigned<A>::value && std::is_signed<B>::value, int>::type = 0>
+    constexpr bool cmp_less(const A a, const B b) noexcept
+    {
+        return b >= 0 && a < static_cast<typename std::make_unsigned<B>::type>(b);
+    }
+
+    template <typename A, typename B>
+    constexpr bool cmp_greater(const A a, const B b) noexcept
+    {
+        return cmp_less(b, a);
+    }
+
+    /// `cmp_equal(a, b)`, a negative value is not equal to any unsigned value
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value
+        && std::is_signed<A>::value == std::is_signed<B>::value, int>::type = 0>
+    constexpr bool cmp_equal(const A a, const B b) noexcept
+    {
+        return a == b;
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value
+        && std::is_signed<A>::value && std::is_unsigned<B>::value, int>::type = 0>
+    constexpr bool cmp_equal(const A a, const B b) noexcept
+    {
+        return a >= 0 && static_cast<typename std::make_unsigned<A>::type>(a) == b;
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value
+        && std::is_unsigned<A>::value && std::is_signed<B>::value, int>::type = 0>
+    constexpr bool cmp_equal(const A a, const B b) noexcept
+    {
+        return cmp_equal(b, a);
+    }
+
+    /// the operand types of `std::cmp_less()` etc. of C++20: integral, but not bool or a character type
+    template <typename T>
+    struct is_standard_integer : std::integral_constant<bool, std::is_integral<T>::value
+        && !std::is_same<typename std::remove_cv<T>::type, bool>::value
+        && !std::is_same<typename std::remove_cv<T>::type, char>::value
+        && !std::is_same<typename std::remove_cv<T>::type, wchar_t>::value
+#if defined(__cpp_char8_t)
+        && !std::is_same<typename std::remove_cv<T>::type, char8_t>::value
+#endif
+        && !std::is_same<typename std::remove_cv<T>::type, char16_t>::value
+        && !std::is_same<typename std::remove_cv<T>::type, char32_t>::value> {};
+
+    /// the unsigned type of the promoted S, in which the subtraction of
+    /// `in_integral_range()` wraps at the width of the comparison
+    template <typename S>
+    struct promoted_unsigned : std::make_unsigned<decltype(S() + 0)> {};
+
+    /// range check of integral to integral conversion by a single compare,
+    /// the same result as `!cmp_less(value, min()) && !cmp_greater(value, max())`:
+    /// unsigned S, or signed S to a wider unsigned T, compares with one limit only
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value
+        && (std::is_unsigned<S>::value || (std::is_unsigned<T>::value
+        && std::numeric_limits<T>::digits >= std::numeric_limits<S>::digits)), int>::type = 0>
+    constexpr bool in_integral_range(const S value) noexcept
+    {
+        return std::is_unsigned<S>::value ? !cmp_greater(value, std::numeric_limits<T>::max())
+            : !(value < S(0));
+    }
+
+    /// signed S to a narrower unsigned T, negative value becomes a large unsigned value,
+    /// e.g. int64_t to uint32_t is `uint64_t(value) <= 0xFFFFFFFF`
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value
+        && std::is_signed<S>::value && std::is_unsigned<T>::value
+        && (std::numeric_limits<T>::digits < std::numeric_limits<S>::digits), int>::type = 0>
+    constexpr bool in_integral_range(const S value) noexcept
+    {
+        return static_cast<typename promoted_unsigned<S>::type>(value)
+            <= static_cast<typename promoted_unsigned<S>::type>(std::numeric_limits<T>::max());
+    }
+
+    /// signed to signed, `value - min()` as unsigned is below `max() - min()` only if
+    /// value is in [min(), max()], e.g. int32_t to int8_t is `uint32_t(value + 128) <= 255`
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value
+        && std::is_signed<S>::value && std::is_signed<T>::value, int>::type = 0>
+    constexpr bool in_integral_range(const S value) noexcept
+    {
+        typedef typename promoted_unsigned<S>::type unsigned_type;
+        return std::numeric_limits<T>::digits >= std::numeric_limits<S>::digits
+            || static_cast<unsigned_type>(static_cast<unsigned_type>(value)
+                - static_cast<unsigned_type>(std::numeric_limits<T>::min()))
+            <= static_cast<unsigned_type>(static_cast<unsigned_type>(std::numeric_limits<T>::max())
+                - static_cast<unsigned_type>(std::numeric_limits<T>::min()));
+    }
+
+    template <typename T, typename S,
+        typename std::enable_if<(std::is_arithmetic<S>::value
+        || supports_arithmetic_operations<S>::value)
+        && !(std::is_floating_point<S>::value && std::is_integral<T>::value)
+        && !(std::is_integral<S>::value && std::is_integral<T>::value), int>::type = 0>
+    constexpr bool convertible(const S value) noexcept
+    {
+        // combined without short-circuit, so that a loop of convertible() can be
+        // vectorized, NaN fails both comparisons and is not convertible
+        return (value <= std::numeric_limits<T>::max())
+            & (value >= std::numeric_limits<T>::lowest());
+    }
+
+    /// integral to integral, a single compare
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value, int>::type = 0>
+    constexpr bool convertible(const S value) noexcept
+    {
+        return in_integral_range<T, S>(value);
+    }
+
+    /// floating point to integral, two exact compares
+    template <typename T, typename S,
+        typename std::enable_if<std::is_floating_point<S>::value
+        && std::is_integral<T>::value, int>::type = 0>
+    constexpr bool convertible(const S value) noexcept
+    {
+        return (value <= float_int_bounds<T, S>::upper())
+            & (value >= float_int_bounds<T, S>::lower());
+    }
+
+    /// `value != value` is the portable NaN test, also for user defined types such as half
+    template <typename S,
+        typename std::enable_if<std::is_integral<S>::value, int>::type = 0>
+    constexpr bool is_nan(const S) noexcept
+    {
+        return false;
+    }
+
+    template <typename S,
+        typename std::enable_if<!std::is_integral<S>::value, int>::type = 0>
+    constexpr bool is_nan(const S value)
+    {
+        return value != value;
+    }
+
+    /// true for +/-infinity of a type which has infinity
+    template <typename S,
+        typename std::enable_if<std::is_integral<S>::value, int>::type = 0>
+    constexpr bool is_infinity(const S) noexcept
+    {
+        return false;
+    }
+
+    template <typename S,
+        typename std::enable_if<!std::is_integral<S>::value, int>::type = 0>
+    constexpr bool is_infinity(const S value)
+    {
+        return std::numeric_limits<S>::has_infinity
+            && (value == std::numeric_limits<S>::infinity() || value == -std::numeric_limits<S>::infinity());
+    }
+
+    /// `convertible()`, and also NaN and infinity to a T which has them, as `try_numeric_cast<T>()`.
+    /// The bulk range checks use `convertible()`, so that NaN goes to the NaN policy
+    template <typename T, typename S>
+    constexpr bool convertible_or_special(const S value)
+    {
+        return convertible<T, S>(value)
+            | (std::numeric_limits<T>::has_quiet_NaN && is_nan(value))
+            | (std::numeric_limits<T>::has_infinity && is_infinity(value));
+    }
+
+    /// saturation between integral types of the same signedness,
+    /// the usual arithmetic conversion of the comparison is value-preserving
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value
+        && std::is_signed<S>::value == std::is_signed<T>::value, int>::type = 0>
+    T saturate_cast(const S value, const T) noexcept
+    {
+        return value > std::numeric_limits<T>::max() ? std::numeric_limits<T>::max()
+            : (value < std::numeric_limits<T>::min() ? std::numeric_limits<T>::min()
+            : static_cast<T>(value));
+    }
+
+    /// signed to unsigned integral, the non-negative value is compared as unsigned
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value
+        && std::is_signed<S>::value && std::is_unsigned<T>::value, int>::type = 0>
+    T saturate_cast(const S value, const T) noexcept
+    {
+        typedef typename std::make_unsigned<S>::type unsigned_type;
+        return value < 0 ? T(0)
+            : (static_cast<unsigned_type>(value) > std::numeric_limits<T>::max()
+            ? std::numeric_limits<T>::max() : static_cast<T>(value));
+    }
+
+    /// unsigned to signed integral, the limit is compared as unsigned
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value
+        && std::is_unsigned<S>::value && std::is_signed<T>::value, int>::type = 0>
+    T saturate_cast(const S value, const T) noexcept
+    {
+        typedef typename std::make_unsigned<T>::type unsigned_type;
+        return value > static_cast<unsigned_type>(std::numeric_limits<T>::max())
+            ? std::numeric_limits<T>::max() : static_cast<T>(value);
+    }
+
+    /// x86-64 has scalar SSE2 min/max and truncation into int64_t, which holds
+    /// any integral type except uint64_t
+    template <typename T, typename S>
+    struct has_sse2_clamp_truncate : std::integral_constant<bool,
+#if defined(__x86_64__) || defined(_M_X64)
+        std::numeric_limits<T>::digits <= 63
+        && (std::is_same<S, double>::value || std::is_same<S, float>::value)
+#else
+        false
+#endif
+        > {};
+
+    /// clamp to [lower, upper] then truncate, NaN is clamped to `lower`.
+    /// This C++ version may be compiled with branches, the SSE2 version below
+    /// is always maxsd + minsd + cvttsd2si
+    template <typename T, typename S,
+        typename std::enable_if<!has_sse2_clamp_truncate<T, S>::value, int>::type = 0>
+    T clamp_truncate(const S value, const S lower, const S upper) noexcept
+    {
+        const S low_clamped = value > lower ? value : lower;
+        return static_cast<T>(low_clamped < upper ? low_clamped : upper);
+    }
+
+#if defined(__x86_64__) || defined(_M_X64)
+    /// maxsd and minsd give the second operand if any operand is NaN
+    inline int64_t clamp_truncate_sse2(const double value, const double lower, const double upper) noexcept
+    {
+        return _mm_cvttsd_si64(_mm_min_sd(_mm_max_sd(_mm_set_sd(value), _mm_set_sd(lower)), _mm_set_sd(upper)));
+    }
+
+    inline int64_t clamp_truncate_sse2(const float value, const float lower, const float upper) noexcept
+    {
+        return _mm_cvttss_si64(_mm_min_ss(_mm_max_ss(_mm_set_ss(value), _mm_set_ss(lower)), _mm_set_ss(upper)));
+    }
+
+    template <typename T, typename S,
+        typename std::enable_if<has_sse2_clamp_truncate<T, S>::value, int>::type = 0>
+    T clamp_truncate(const S value, const S lower, const S upper) noexcept
+    {
+        return static_cast<T>(clamp_truncate_sse2(value, lower, upper));
+    }
+#endif
+
+    /// floating point to integral, clamp_truncate() + cmov, without branch
+    template <typename T, typename S,
+        typename std::enable_if<std::is_floating_point<S>::value
+        && std::is_integral<T>::value, int>::type = 0>
+    T saturate_cast(const S value, const T nan_value) noexcept
+    {
+        typedef float_int_bounds<T, S> bounds;
+        const T converted = clamp_truncate<T, S>(value, bounds::lower(), bounds::upper());
+        // if T has more digits than S, e.g. int64_t from double, `upper()` is below max(),
+        // values at and above `limit()` are selected by a mask, so is NaN, so as not to give a branch
+        typedef typename std::make_unsigned<T>::type unsigned_type;
+        const unsigned_type above = std::numeric_limits<T>::digits > std::numeric_limits<S>::digits
+            ? unsigned_type(0) - static_cast<unsigned_type>(value >= bounds::limit()) : unsigned_type(0);
+        const unsigned_type nan = unsigned_type(0) - static_cast<unsigned_type>(is_nan(value));
+        const unsigned_type saturated = (static_cast<unsigned_type>(converted) & ~above)
+            | (static_cast<unsigned_type>(std::numeric_limits<T>::max()) & above);
+        return static_cast<T>((saturated & ~nan) | (static_cast<unsigned_type>(nan_value) & nan));
+    }
+
+    /// other types, e.g. double to float, or user defined types such as half,
+    /// infinity is passed to a T which has infinity as by `numeric_cast<T>()`, only finite values are clamped
+    template <typename T, typename S,
+        typename std::enable_if<!(std::is_integral<T>::value
+        && (std::is_integral<S>::value || std::is_floating_point<S>::value)), int>::type = 0>
+    T saturate_cast(const S value, const T nan_value)
+    {
+        return is_nan(value) ? nan_value
+            : (std::numeric_limits<T>::has_infinity && is_infinity(value)) ? static_cast<T>(value)
+            : (value > std::numeric_limits<T>::max() ? std::numeric_limits<T>::max()
+            : (value < std::numeric_limits<T>::lowest() ? std::numeric_limits<T>::lowest()
+            : static_cast<T>(value)));
+    }
+
+    /// `value > numeric_limits<T>::max()` and `value < numeric_limits<T>::lowest()`
+    /// of integral types, without the unsigned conversion of mixed-sign integer comparison
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value, int>::type = 0>
+    constexpr bool above_max(const S value) noexcept
+    {
+        return cmp_greater(value, std::numeric_limits<T>::max());
+    }
+
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value, int>::type = 0>
+    constexpr bool below_min(const S value) noexcept
+    {
+        return cmp_less(value, std::numeric_limits<T>::min());
+    }
+
+    /// floating point to integral by the exact bounds, NaN is taken as above max
+    template <typename T, typename S,
+        typename std::enable_if<std::is_floating_point<S>::value
+        && std::is_integral<T>::value, int>::type = 0>
+    constexpr bool above_max(const S value) noexcept
+    {
+        return !(value <= float_int_bounds<T, S>::upper());
+    }
+
+    template <typename T, typename S,
+        typename std::enable_if<std::is_floating_point<S>::value
+        && std::is_integral<T>::value, int>::type = 0>
+    constexpr bool below_min(const S value) noexcept
+    {
+        return value < float_int_bounds<T, S>::lower();
+    }
+
+    /// floating point and user defined types, NaN is taken as above max
+    template <typename T, typename S,
+        typename std::enable_if<!(std::is_integral<S>::value && std::is_integral<T>::value)
+        && !(std::is_floating_point<S>::value && std::is_integral<T>::value), int>::type = 0>
+    constexpr bool above_max(const S value)
+    {
+        return !(value <= std::numeric_limits<T>::max());
+    }
+
+    template <typename T, typename S,
+        typename std::enable_if<!(std::is_integral<S>::value && std::is_integral<T>::value)
+        && !(std::is_floating_point<S>::value && std::is_integral<T>::value), int>::type = 0>
+    constexpr bool below_min(const S value)
+    {
+        return value < std::numeric_limits<T>::lowest();
+    }
+
+    /// range check, out-of-range value is passed to `Handler::overflow<T>()` or
+    /// `Handler::underflow<T>()`, whose return value is the result
+    template <typename T, typename S, typename Handler>
+    T range_checked_cast(const S value)
+    {
+        if (above_max<T>(value))
+        {
+            return Handler::template overflow<T>(value);
+        }
+        if (below_min<T>(value))
+        {
+            return Handler::template underflow<T>(value);
+        }
+        return static_cast<T>(value);
+    }
+
+    /// modular conversion of integral types, floating point is truncated to
+    /// `long long` first (saturated, NaN to zero), or for a 64 bit unsigned T its magnitude
+    /// to `unsigned long long`, negated if the value is negative, so that -1.0 is the max() of any unsigned T
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_integral<T>::value, int>::type = 0>
+    constexpr T wrap_cast(const S value) noexcept
+    {
+        return static_cast<T>(value);
+    }
+
+    template <typename T, typename S,
+        typename std::enable_if<std::is_floating_point<S>::value && std::is_integral<T>::value, int>::type = 0>
+    T wrap_cast(const S value) noexcept
+    {
+        typedef typename std::conditional<std::is_signed<T>::value
+            || std::numeric_limits<T>::digits < std::numeric_limits<long long>::digits,
+            long long, unsigned long long>::type wide_type;
+        return std::is_signed<wide_type>::value || !(value < S(0))
+            ? static_cast<T>(saturate_cast<wide_type, S>(value, wide_type(0)))
+            : static_cast<T>(wide_type(0) - saturate_cast<wide_type, S>(-value, wide_type(0)));
+    }
+
+    /// a floating point target has no wrap-around, it is a plain conversion
+    template <typename T, typename S,
+        typename std::enable_if<!std::is_integral<T>::value
+        || !(std::is_integral<S>::value || std::is_floating_point<S>::value), int>::type = 0>
+    T wrap_cast(const S value)
+    {
+        return static_cast<T>(value);
+    }
+
+}
+
+    /// the range check a conversion needs, decided at compile time from `numeric_limits`
+    enum class conversion_category
+    {
+        lossless,        ///< the target range is a superset, e.g. int32_t to int64_t, float to double
+        upper_check,     ///< only `value > max()`, e.g. uint32_t to int32_t, uint32_t to uint16_t
+        lower_check,     ///< only `value < 0`, e.g. int32_t to uint32_t
+        both_checks,     ///< e.g. int32_t to int16_t (one unsigned compare of `value - min()`),
+                         ///< double to int, double to float, user defined types
+        sign_change,     ///< signed to narrower unsigned, one unsigned compare to max()
+        precision_loss   ///< integer to floating point with fewer digits, e.g. int64_t to double,
+                         ///< always in range, low bits are rounded
+    };
+
+namespace detail{
+
+    template <typename T, typename S>
+    struct conversion_category_of
+    {
+        typedef std::numeric_limits<S> s;
+        typedef std::numeric_limits<T> t;
+        static constexpr bool integers = s::is_integer && t::is_integer;
+        static constexpr bool wider = t::digits >= s::digits;
+
+        static constexpr conversion_category value =
+            !s::is_specialized || !t::is_specialized || std::is_same<T, bool>::value
+                ? conversion_category::both_checks
+            : integers && s::is_signed == t::is_signed
+                ? (wider ? conversion_category::lossless
+                    : (s::is_signed ? conversion_category::both_checks : conversion_category::upper_check))
+            : integers && !s::is_signed
+                ? (wider ? conversion_category::lossless : conversion_category::upper_check)
+            : integers
+                ? (wider ? conversion_category::lower_check : conversion_category::sign_change)
+            : s::is_integer
+                ? (wider ? conversion_category::lossless
+                    : (t::max_exponent > s::digits ? conversion_category::precision_loss
+                        : conversion_category::both_checks))
+            : !t::is_integer && wider && t::max_exponent >= s::max_exponent && t::min_exponent <= s::min_exponent
+                ? conversion_category::lossless
+                : conversion_category::both_checks;
+    };
+}
+
+    /// `conversion_kind<T, S>::value` is the conversion_category from S to T
+    template <typename T, typename S>
+    struct conversion_kind
+        : std::integral_constant<conversion_category, detail::conversion_category_of<T, S>::value> {};
+
+    /// error of the non-throwing conversion `try_numeric_cast<T>()`
+    enum class numeric_cast_errc
+    {
+        ok = 0,
+        overflow,   ///< above the max of the target type, +infinity if the target type has no infinity
+        underflow,  ///< below the lowest of the target type, -infinity if the target type has no infinity
+        nan,        ///< NaN, and the target type has no NaN
+        inexact,    ///< not an integer, by `round_policy::exact`
+        negative_shift  ///< a negative count of `checked_shl()`, only of checked arithmetic
+    };
+
+    /// `numeric_type_name<T>::name()` is the name of T in the message of numeric_cast_error,
+    /// a string literal, e.g. "int" for int32_t, also usable as a constexpr `std::string_view`.
+    /// Specialize it for a user defined numeric type
+    template <typename T, typename = void>
+    struct numeric_type_name
+    {
+        static constexpr const char* name() noexcept
+        {
+            return std::is_enum<T>::value ? "enum" : "non-builtin type";
+        }
+    };
+
+#define NUMERIC_CAST_TYPE_NAME(type)                           \
+    template <> struct numeric_type_name<type>                 \
+    {                                                          \
+        static constexpr const char* name() noexcept           \
+        {                                                      \
+            return #type;                                      \
+        }                                                      \
+    };
+
+    NUMERIC_CAST_TYPE_NAME(bool)
+    NUMERIC_CAST_TYPE_NAME(char)
+    NUMERIC_CAST_TYPE_NAME(signed char)
+    NUMERIC_CAST_TYPE_NAME(unsigned char)
+    NUMERIC_CAST_TYPE_NAME(wchar_t)
+    NUMERIC_CAST_TYPE_NAME(char16_t)
+    NUMERIC_CAST_TYPE_NAME(char32_t)
+    NUMERIC_CAST_TYPE_NAME(short)
+    NUMERIC_CAST_TYPE_NAME(unsigned short)
+    NUMERIC_CAST_TYPE_NAME(int)
+    NUMERIC_CAST_TYPE_NAME(unsigned int)
+    NUMERIC_CAST_TYPE_NAME(long)
+    NUMERIC_CAST_TYPE_NAME(unsigned long)
+    NUMERIC_CAST_TYPE_NAME(long long)
+    NUMERIC_CAST_TYPE_NAME(unsigned long long)
+    NUMERIC_CAST_TYPE_NAME(float)
+    NUMERIC_CAST_TYPE_NAME(double)
+    NUMERIC_CAST_TYPE_NAME(long double)
+#undef NUMERIC_CAST_TYPE_NAME
+
+    /// true if the value of the user defined numeric type T is written into the message of
+    /// numeric_cast_error by `static_cast<long double>()`, otherwise the value text is empty.
+    /// Specialize it as `std::true_type`, e.g. for half
+    template <typename T>
+    struct numeric_value_formattable : std::false_type {};
+
+    /// the details of a failed conversion, the common base of the exceptions thrown by
+    /// `numeric_cast<T>()`: numeric_overflow_error, numeric_underflow_error and
+    /// numeric_range_error, which also derive from `std::overflow_error`, `std::underflow_error`
+    /// and `std::range_error`. The type names are string literals, the value and the message
+    /// are formatted into fixed-size buffers inside the object, so that creating the
+    /// exception never allocates; the `std::` base holds an empty message, which
+    /// does not allocate either
+    class numeric_cast_error
+    {
+    public:
+        numeric_cast_error(const numeric_cast_errc kind, const char* source_type,
+                           const char* target_type, const char* value) noexcept
+            : kind_(kind), source_type_(source_type), target_type_(target_type)
+        {
+            std::snprintf(value_, sizeof(value_), "%s", value);
+            const char* what = kind == numeric_cast_errc::underflow ? "underflows"
+                : (kind == numeric_cast_errc::nan ? "can not be converted to" : "overflows");
+            // the value text is empty for a user defined type which is not numeric_value_formattable
+            const char* space = value[0] != '\0' ? " " : "";
+            if (kind == numeric_cast_errc::inexact)
+                std::snprintf(message_, sizeof(message_), "numeric_cast: %s%s%s is not an integer",
+                              source_type, space, value);
+            else if (kind == numeric_cast_errc::negative_shift)
+                std::snprintf(message_, sizeof(message_), "numeric_cast: %s%s%s has a negative shift count",
+                              source_type, space, value);
+            else if (source_type[0] != '\0')
+                std::snprintf(message_, sizeof(message_), "numeric_cast: %s%s%s %s %s",
+                              source_type, space, value, what, target_type);
+            else
+                std::snprintf(message_, sizeof(message_), "numeric_cast: input value %s %s",
+                              what, target_type);
+        }
+
+        numeric_cast_errc kind() const noexcept
+        {
+            return kind_;
+        }
+
+        /// name of the source type, empty if not known, e.g. by `numeric_cast_result<T>::value()`
+        const char* source_type() const noexcept
+        {
+            return source_type_;
+        }
+
+        const char* target_type() const noexcept
+        {
+            return target_type_;
+        }
+
+        /// the offending value as text, empty if not known,
+        /// the operation of checked arithmetic, e.g. "2147483647 + 1"
+        const char* value() const noexcept
+        {
+            return value_;
+        }
+
+        const char* message() const noexcept
+        {
+            return message_;
+        }
+
+    protected:
+        ~numeric_cast_error() = default;
+
+    private:
+        numeric_cast_errc kind_;
+        const char* source_type_;
+        const char* target_type_;
+        char value_[72];
+        char message_[192];
+    };
+
+    /// one of the standard exceptions with the details of numeric_cast_error
+    template <typename Base>
+    class basic_numeric_cast_error : public Base, public numeric_cast_error
+    {
+    public:
+        basic_numeric_cast_error(const numeric_cast_errc kind, const char* source_type,
+                                 const char* target_type, const char* value) noexcept
+            : Base(""), numeric_cast_error(kind, source_type, target_type, value) {}
+
+        const char* what() const noexcept override
+        {
+            return message();
+        }
+    };
+
+    /// above the max of the target type
+    typedef basic_numeric_cast_error<std::overflow_error> numeric_overflow_error;
+    /// below the lowest of the target type
+    typedef basic_numeric_cast_error<std::underflow_error> numeric_underflow_error;
+    /// NaN, not an integer by `round_policy::exact`, or a negative shift count
+    typedef basic_numeric_cast_error<std::range_error> numeric_range_error;
+
+    /// the details of a failed conversion given to the failure handler, and where the conversion
+    /// is in the source code, known since C++20 by `std::source_location`, empty otherwise
+    class numeric_cast_failure_info : public numeric_cast_error
+    {
+    public:
+        numeric_cast_failure_info(const numeric_cast_errc kind, const char* source_type, const char* target_type,
+                                  const char* value, const char* file, const unsigned line,
+                                  const char* function) noexcept
+            : numeric_cast_error(kind, source_type, target_type, value), file_(file), line_(line),
+              function_(function) {}
+
+        const char* file() const noexcept
+        {
+            return file_;
+        }
+
+        /// 0 if not known
+        unsigned line() const noexcept
+        {
+            return line_;
+        }
+
+        const char* function() const noexcept
+        {
+            return function_;
+        }
+
+    private:
+        const char* file_;
+        unsigned line_;
+        const char* function_;
+    };
+
+    /// called on a failed conversion instead of throwing, with NUMERIC_CAST_NO_EXCEPTIONS
+    /// or by `overflow_policy::report`. If it returns, the result of the conversion is the
+    /// nearest limit of the target type, zero for NaN
+    typedef void (*numeric_cast_failure_handler)(const numeric_cast_failure_info& failure);
+
+namespace detail{
+
+    inline std::atomic<numeric_cast_failure_handler>& failure_handler() noexcept
+    {
+        static std::atomic<numeric_cast_failure_handler> handler(nullptr);
+        return handler;
+    }
+
+    /// where the conversion is, given by `std::source_location` since C++20, empty otherwise
+    struct numeric_cast_site
+    {
+        const char* file;
+        unsigned line;
+        const char* function;
+
+        constexpr numeric_cast_site() noexcept
+            : file(""), line(0), function("") {}
+
+#if NUMERIC_CAST_HAS_SOURCE_LOCATION
+        constexpr numeric_cast_site(const std::source_location& location) noexcept
+            : file(location.file_name()), line(location.line()), function(location.function_name()) {}
+#endif
+    };
+}
+
+    /// usage `set_numeric_cast_failure_handler([](const numeric_cast_failure_info& f) { log(f.message()); });`,
+    /// as `std::set_terminate()`, gives the previous handler. nullptr restores the default,
+    /// which prints the message to stderr and calls `std::terminate()`, as an uncaught exception
+    inline numeric_cast_failure_handler set_numeric_cast_failure_handler(
+        const numeric_cast_failure_handler handler) noexcept
+    {
+        return detail::failure_handler().exchange(handler);
+    }
+
+    inline numeric_cast_failure_handler get_numeric_cast_failure_handler() noexcept
+    {
+        return detail::failure_handler().load();
+    }
+
+namespace detail{
+
+    /// the offending value as text, into the buffer of the exception
+    template <typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_signed<S>::value, int>::type = 0>
+    void format_value(char (&buffer)[32], const S value) noexcept
+    {
+        std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+    }
+
+    template <typename S,
+        typename std::enable_if<std::is_integral<S>::value && std::is_unsigned<S>::value, int>::type = 0>
+    void format_value(char (&buffer)[32], const S value) noexcept
+    {
+        std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+    }
+
+    template <typename S,
+        typename std::enable_if<std::is_enum<S>::value, int>::type = 0>
+    void format_value(char (&buffer)[32], const S value) noexcept
+    {
+        format_value(buffer, static_cast<typename std::underlying_type<S>::type>(value));
+    }
+
+    /// floating point types, and user defined types of `numeric_value_formattable`
+    template <typename S,
+        typename std::enable_if<std::is_floating_point<S>::value
+        || numeric_value_formattable<S>::value, int>::type = 0>
+    void format_value(char (&buffer)[32], const S value) noexcept
+    {
+        std::snprintf(buffer, sizeof(buffer), "%.17Lg", static_cast<long double>(value));
+    }
+
+    /// other user defined types have no value text, a trait such as `std::is_constructible`
+    /// is not used here, it is a hard error for e.g. `boost::safe_numerics::safe<int>`
+    template <typename S,
+        typename std::enable_if<!std::is_arithmetic<S>::value && !std::is_enum<S>::value
+        && !numeric_value_formattable<S>::value, int>::type = 0>
+    void format_value(char (&buffer)[32], const S) noexcept
+    {
+        buffer[0] = '\0';
+    }
+
+    /// pass the failure to the handler, or print it and terminate if there is none
+    NUMERIC_CAST_COLD inline void report_numeric_cast_failure(const numeric_cast_failure_info& failure)
+    {
+        const numeric_cast_failure_handler handler = failure_handler().load();
+        if (handler)
+        {
+            handler(failure);
+            return;
+        }
+        if (failure.line() != 0)
+            std::fprintf(stderr, "%s:%u: %s: ", failure.file(), failure.line(), failure.function());
+        std::fprintf(stderr, "%s\n", failure.message());
+        std::terminate();
+    }
+
+    /// the exception of `numeric_cast<T>()` for the error, the only place that throws.
+    /// Not a template and never inlined, one copy for the program, so that a call site
+    /// of the conversion has only compare, branch and convert, the error code is
+    /// passed in a register instead of constructing the message and the exception inline
+    [[noreturn]] NUMERIC_CAST_COLD inline void throw_numeric_cast_error(const numeric_cast_errc error,
+        const char* source_type, const char* target_type, const char* value)
+    {
+#if NUMERIC_CAST_NO_EXCEPTIONS
+        report_numeric_cast_failure(numeric_cast_failure_info(error, source_type, target_type, value, "", 0, ""));
+        std::terminate();  // there is no value to return
+#else
+        switch (error)
+        {
+        case numeric_cast_errc::underflow:
+            throw numeric_underflow_error(error, source_type, target_type, value);
+        case numeric_cast_errc::nan:
+        case numeric_cast_errc::inexact:
+        case numeric_cast_errc::negative_shift:
+            throw numeric_range_error(error, source_type, target_type, value);
+        default:
+            throw numeric_overflow_error(error, source_type, target_type, value);
+        }
+#endif
+    }
+
+    /// the value is formatted here, out of line as well, one per type pair
+    template <typename T, typename S>
+    [[noreturn]] NUMERIC_CAST_COLD void throw_numeric_cast_error(const numeric_cast_errc error, const S value)
+    {
+        char text[32];
+        format_value(text, value);
+        throw_numeric_cast_error(error, numeric_type_name<S>::name(), numeric_type_name<T>::name(), text);
+    }
+
+    /// the result after the failure handler returns: the nearest limit of T,
+    /// zero for NaN and a negative shift count, the value as it is if it is not an integer
+    template <typename T, typename S,
+        typename std::enable_if<!std::is_enum<T>::value, int>::type = 0>
+    T failure_fallback(const numeric_cast_errc error, const S value)
+    {
+        return error == numeric_cast_errc::overflow ? std::numeric_limits<T>::max()
+            : error == numeric_cast_errc::underflow ? std::numeric_limits<T>::lowest()
+            : error == numeric_cast_errc::inexact ? static_cast<T>(value) : T(0);
+    }
+
+    template <typename T, typename S,
+        typename std::enable_if<std::is_enum<T>::value, int>::type = 0>
+    T failure_fallback(const numeric_cast_errc error, const S value)
+    {
+        return static_cast<T>(failure_fallback<typename std::underlying_type<T>::type, S>(error, value));
+    }
+
+    /// call the failure handler with the message of the conversion from S to T
+    template <typename T, typename S>
+    NUMERIC_CAST_COLD void report_numeric_cast_failure(const numeric_cast_errc error, const S value,
+                                                       const numeric_cast_site site)
+    {
+        char text[32];
+        format_value(text, value);
+        report_numeric_cast_failure(numeric_cast_failure_info(error, numeric_type_name<S>::name(),
+            numeric_type_name<T>::name(), text, site.file, site.line, site.function));
+    }
+
+    /// call the failure handler, then give the fallback value, out of line as the throw
+    template <typename T, typename S>
+    NUMERIC_CAST_COLD T handle_numeric_cast_failure(const numeric_cast_errc error, const S value,
+                                                    const numeric_cast_site site)
+    {
+        report_numeric_cast_failure<T, S>(error, value, site);
+        return failure_fallback<T, S>(error, value);
+    }
+
+#if NUMERIC_CAST_NO_EXCEPTIONS
+    /// the failure of the checked conversions, given to the failure handler, then the fallback value
+    template <typename T>
+    T numeric_cast_failure(const numeric_cast_errc error, const numeric_cast_site site = numeric_cast_site())
+    {
+        report_numeric_cast_failure(numeric_cast_failure_info(error, "", numeric_type_name<T>::name(), "",
+                                                              site.file, site.line, site.function));
+        return failure_fallback<T, T>(error, T());
+    }
+
+    template <typename T, typename S>
+    T numeric_cast_failure(const numeric_cast_errc error, const S value,
+                           const numeric_cast_site site = numeric_cast_site())
+    {
+        return handle_numeric_cast_failure<T, S>(error, value, site);
+    }
+#else
+    /// throw_numeric_cast_error() as an expression of type T, for the conditional
+    /// expression of a constexpr function
+    template <typename T>
+    [[noreturn]] T numeric_cast_failure(const numeric_cast_errc error, const numeric_cast_site = numeric_cast_site())
+    {
+        throw_numeric_cast_error(error, "", numeric_type_name<T>::name(), "");
+    }
+
+    template <typename T, typename S>
+    [[noreturn]] T numeric_cast_failure(const numeric_cast_errc error, const S value,
+                                        const numeric_cast_site = numeric_cast_site())
+    {
+        throw_numeric_cast_error<T, S>(error, value);
+    }
+#endif
+}
+
+    /// result of `try_numeric_cast<T>()`, either the converted value or the error,
+    /// in the manner of `std::expected<T, numeric_cast_errc>`, but also for C++11.
+    /// Usage `if (auto r = try_numeric_cast<int>(v)) use(*r); else log(r.error());`
+    template <typename T>
+    class numeric_cast_result
+    {
+    public:
+        constexpr numeric_cast_result(const T value) noexcept
+            : value_(value), error_(numeric_cast_errc::ok) {}
+
+        constexpr numeric_cast_result(const numeric_cast_errc error) noexcept
+            : value_(), error_(error) {}
+
+        constexpr bool has_value() const noexcept
+        {
+            return error_ == numeric_cast_errc::ok;
+        }
+
+        constexpr explicit operator bool() const noexcept
+        {
+            return has_value();
+        }
+
+        constexpr numeric_cast_errc error() const noexcept
+        {
+            return error_;
+        }
+
+        /// the converted value, throw the exception of `numeric_cast<T>()` if there is an error
+#if NUMERIC_CAST_HAS_SOURCE_LOCATION
+        constexpr T value(const std::source_location location = std::source_location::current()) const
+#else
+        constexpr T value() const
+#endif
+        {
+            return has_value() ? value_ : detail::numeric_cast_failure<T>(error_, NUMERIC_CAST_LOCATION);
+        }
+
+        constexpr T value_or(const T default_value) const noexcept
+        {
+            return has_value() ? value_ : default_value;
+        }
+
+        /// the converted value, unspecified if there is an error
+        constexpr T operator*() const noexcept
+        {
+            return value_;
+        }
+
+    private:
+        T value_;
+        numeric_cast_errc error_;
+    };
+
+namespace detail{
+
+    template <conversion_category Category>
+    using conversion_tag = std::integral_constant<conversion_category, Category>;
+
+    /// true if the conversion from S to T needs no range check
+    template <typename T, typename S>
+    struct is_unchecked_conversion : std::integral_constant<bool,
+        conversion_kind<T, S>::value == conversion_category::lossless
+        || conversion_kind<T, S>::value == conversion_category::precision_loss> {};
+
+    /// the checks of each conversion_category, only the needed comparisons are compiled
+    template <typename T, typename S>
+    constexpr numeric_cast_result<T> try_cast(const S value, conversion_tag<conversion_category::lossless>) noexcept
+    {
+        return numeric_cast_result<T>(static_cast<T>(value));
+    }
+
+    template <typename T, typename S>
+    constexpr numeric_cast_result<T> try_cast(const S value, conversion_tag<conversion_category::precision_loss>) noexcept
+    {
+        return numeric_cast_result<T>(static_cast<T>(value));
+    }
+
+    /// integer types by numeric_limits only, e.g. boost::multiprecision::int128_t,
+    /// the built-in integral types use the integral_conversion_tag below
+    template <typename T, typename S>
+    constexpr numeric_cast_result<T> try_cast(const S value, conversion_tag<conversion_category::upper_check>) noexcept
+    {
+        return above_max<T>(value) ? numeric_cast_result<T>(numeric_cast_errc::overflow)
+            : numeric_cast_result<T>(static_cast<T>(value));
+    }
+
+    template <typename T, typename S>
+    constexpr numeric_cast_result<T> try_cast(const S value, conversion_tag<conversion_category::lower_check>) noexcept
+    {
+        return below_min<T>(value) ? numeric_cast_result<T>(numeric_cast_errc::underflow)
+            : numeric_cast_result<T>(static_cast<T>(value));
+    }
+
+    template <typename T, typename S>
+    constexpr numeric_cast_result<T> try_cast(const S value, conversion_tag<conversion_category::sign_change>) noexcept
+    {
+        return below_min<T>(value) ? numeric_cast_result<T>(numeric_cast_errc::underflow)
+            : (above_max<T>(value) ? numeric_cast_result<T>(numeric_cast_errc::overflow)
+            : numeric_cast_result<T>(static_cast<T>(value)));
+    }
+
+    /// NaN and infinity are passed to a target type which has them, e.g. from double to float
+    template <typename T, typename S>
+    constexpr numeric_cast_result<T> try_cast(const S value, conversion_tag<conversion_category::both_checks>) noexcept
+    {
+        return is_nan(value)
+            ? (std::numeric_limits<T>::has_quiet_NaN ? numeric_cast_result<T>(static_cast<T>(value))
+                : numeric_cast_result<T>(numeric_cast_errc::nan))
+            : (std::numeric_limits<T>::has_infinity && is_infinity(value))
+                ? numeric_cast_result<T>(static_cast<T>(value))
+            : (above_max<T>(value) ? numeric_cast_result<T>(numeric_cast_errc::overflow)
+            : (below_min<T>(value) ? numeric_cast_result<T>(numeric_cast_errc::underflow)
+            : numeric_cast_result<T>(static_cast<T>(value))));
+    }
+
+    /// integral to integral with range check: the single compare of `in_integral_range()`,
+    /// the sign of the value tells overflow from underflow only after the check failed
+    struct integral_conversion_tag {};
+
+    template <typename T, typename S>
+    constexpr numeric_cast_result<T> try_cast(const S value, integral_conversion_tag) noexcept
+    {
+        return in_integral_range<T, S>(value) ? numeric_cast_result<T>(static_cast<T>(value))
+            : numeric_cast_result<T>(below_min<T>(value) ? numeric_cast_errc::underflow
+                : numeric_cast_errc::overflow);
+    }
+
+    template <typename T, typename S>
+    struct try_cast_tag : std::conditional<std::is_integral<S>::value && std::is_integral<T>::value
+        && !is_unchecked_conversion<T, S>::value,
+        integral_conversion_tag, conversion_tag<conversion_kind<T, S>::value>> {};
+
+#if NUMERIC_CAST_INSTRUMENTED
+    /// count the conversion and sample the headroom of the value, defined in numeric_cast_stats.h
+    template <typename T, typename S>
+    void count_numeric_cast(numeric_cast_errc error, S value) noexcept;
+
+    template <typename T, typename S>
+    constexpr numeric_cast_result<T> counted(const numeric_cast_result<T> result, const S value) noexcept
+    {
+        return NUMERIC_CAST_CONSTANT_EVALUATED() ? result
+            : (count_numeric_cast<T, S>(result.error(), value), result);
+    }
+#endif
+
+    /// the non-throwing conversion, all the other conversions with range check are built on it
+    template <typename T, typename S>
+    constexpr numeric_cast_result<T> try_cast(const S value) noexcept
+    {
+#if NUMERIC_CAST_INSTRUMENTED
+        return counted<T, S>(try_cast<T, S>(value, typename try_cast_tag<T, S>::type()), value);
+#else
+        return try_cast<T, S>(value, typename try_cast_tag<T, S>::type());
+#endif
+    }
+
+    /// the result of the underlying type as the result of the enum, or of another type
+    template <typename E, typename U>
+    constexpr numeric_cast_result<E> to_enum_result(const numeric_cast_result<U> result) noexcept
+    {
+        return result ? numeric_cast_result<E>(static_cast<E>(*result)) : numeric_cast_result<E>(result.error());
+    }
+
+    /// the value of the result, or throw the error with the source value
+    template <typename T, typename S>
+    constexpr T verified_value(const numeric_cast_result<T> result, const S value,
+                               const numeric_cast_site site)
+    {
+        return result.has_value() ? *result : numeric_cast_failure<T, S>(result.error(), value, site);
+    }
+
+    /// marks the failure branch of an assumed conversion unreachable, it is never a constant expression
+    template <typename T>
+    [[noreturn]] NUMERIC_CAST_ALWAYS_INLINE T unreachable_value() noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_unreachable();
+#elif defined(_MSC_VER)
+        __assume(0);
+#else
+        std::terminate();
+#endif
+    }
+
+#if NUMERIC_CAST_MODE != NUMERIC_CAST_MODE_CHECKED
+    /// the value of a result assumed to hold one, the compare of `try_cast()` is folded away.
+    /// In a constant expression, a failure is still a compile error
+    template <typename T>
+    constexpr T assumed_value(const numeric_cast_result<T> result) noexcept
+    {
+        return result.has_value() ? *result : unreachable_value<T>();
+    }
+#endif
+
+#if NUMERIC_CAST_MODE == NUMERIC_CAST_MODE_SAMPLED
+    /// true for 1 in NUMERIC_CAST_MODE_SAMPLING calls of each thread
+    inline bool sample_check() noexcept
+    {
+        static thread_local unsigned countdown = 1;
+        if (--countdown != 0)
+            return false;
+        countdown = NUMERIC_CAST_MODE_SAMPLING;
+        return true;
+    }
+#endif
+
+    /// the value of the result by NUMERIC_CAST_MODE, checked or assumed
+    template <typename T, typename S>
+    constexpr T checked_value(const numeric_cast_result<T> result, const S value,
+                              const numeric_cast_site site = numeric_cast_site())
+    {
+#if NUMERIC_CAST_MODE == NUMERIC_CAST_MODE_ASSUME
+        return static_cast<void>(value), static_cast<void>(site), assumed_value<T>(result);
+#elif NUMERIC_CAST_MODE == NUMERIC_CAST_MODE_SAMPLED
+        return NUMERIC_CAST_CONSTANT_EVALUATED() || sample_check() ? verified_value<T, S>(result, value, site)
+            : assumed_value<T>(result);
+#else
+        return verified_value<T, S>(result, value, site);
+#endif
+    }
+
+    /// throw `std::overflow_error`, `std::underflow_error`, or `std::range_error` for NaN.
+    /// A conversion without range check is a bare `static_cast`, also in debug build
+    template <typename T, typename S,
+        typename std::enable_if<(std::is_arithmetic<S>::value
+        || supports_arithmetic_operations<S>::value)
+        && !is_unchecked_conversion<T, S>::value, int>::type = 0>
+    constexpr T numeric_cast(const S value, const numeric_cast_site site = numeric_cast_site())
+    {
+        return checked_value<T, S>(try_cast<T, S>(value), value, site);
+    }
+
+    template <typename T, typename S,
+        typename std::enable_if<is_unchecked_conversion<T, S>::value, int>::type = 0>
+    NUMERIC_CAST_ALWAYS_INLINE constexpr T numeric_cast(const S value,
+                                                        const numeric_cast_site = numeric_cast_site()) noexcept
+    {
+        return static_cast<T>(value);
+    }
+}
+
+/// overflow policies, the second template parameter of `numeric_cast<T, Policy>()`,
+/// `to_integer<T, Policy>()` and `to_unsigned<T, Policy>()`.
+/// A policy has the member `template <typename T, typename S> static T cast(const S value)`
+namespace overflow_policy {
+
+    /// base of all overflow policies, derive from it to write a new policy
+    struct policy_tag {};
+
+    /// the default of `numeric_cast<T>()`: throw `std::overflow_error` or `std::underflow_error`
+    struct throw_on_overflow : policy_tag
+    {
+        template <typename T, typename S>
+        static T cast(const S value)
+        {
+            return detail::numeric_cast<T, S>(value);
+        }
+    };
+
+    /// clamp to the limits of T, as `saturate_cast<T>()`, NaN to `quiet_NaN()` of T
+    struct saturate : policy_tag
+    {
+        template <typename T, typename S>
+        static T cast(const S value)
+        {
+            return detail::saturate_cast<T, S>(value, std::numeric_limits<T>::quiet_NaN());
+        }
+    };
+
+    /// modular arithmetic for integral types, as `static_cast` for integer,
+    /// floating point is truncated to a 64 bit integer first, modulo 2^64 also for uint64_t. No range check at all
+    struct wrap : policy_tag
+    {
+        template <typename T, typename S>
+        static T cast(const S value)
+        {
+            return detail::wrap_cast<T, S>(value);
+        }
+    };
+
+    /// `std::terminate()` if out of range or NaN, no exception code is generated
+    struct terminate : policy_tag
+    {
+        template <typename T, typename S>
+        [[noreturn]] static T overflow(const S) noexcept
+        {
+            std::terminate();
+        }
+
+        template <typename T, typename S>
+        [[noreturn]] static T underflow(const S) noexcept
+        {
+            std::terminate();
+        }
+
+        template <typename T, typename S>
+        static T cast(const S value) noexcept
+        {
+            return detail::range_checked_cast<T, S, terminate>(value);
+        }
+    };
+
+    /// the caller guarantees the value is in range, the check is only a hint to the optimizer,
+    /// undefined behaviour otherwise. Use it where the range has been validated,
+    /// e.g. by `is_numeric_convertible_n()`
+    struct assume_in_range : policy_tag
+    {
+        template <typename T, typename S>
+        static T cast(const S value) noexcept
+        {
+            NUMERIC_CAST_ASSUME(!detail::above_max<T>(value) && !detail::below_min<T>(value));
+            return static_cast<T>(value);
+        }
+    };
+
+    /// out-of-range value is passed to `Handler::on_overflow<T>(value)` or
+    /// `Handler::on_underflow<T>(value)`, whose return value is the result,
+    /// they may also throw or log. NaN, and a value which is not an integer by
+    /// `round_policy::exact`, are passed to `on_overflow`
+    template <typename Handler>
+    struct user_callback : policy_tag
+    {
+        template <typename T, typename S>
+        static T overflow(const S value)
+        {
+            return Handler::template on_overflow<T>(value);
+        }
+
+        template <typename T, typename S>
+        static T underflow(const S value)
+        {
+            return Handler::template on_underflow<T>(value);
+        }
+
+        template <typename T, typename S>
+        static T cast(const S value)
+        {
+            return detail::range_checked_cast<T, S, user_callback>(value);
+        }
+    };
+
+    /// out-of-range value is passed to the failure handler of `set_numeric_cast_failure_handler()`,
+    /// also with exceptions enabled, then the result is the nearest limit of T, zero for NaN
+    struct report : policy_tag
+    {
+        template <typename T, typename S>
+        static T overflow(const S value)
+        {
+            return detail::handle_numeric_cast_failure<T, S>(detail::is_nan(value) ? numeric_cast_errc::nan
+                : numeric_cast_errc::overflow, value, detail::numeric_cast_site());
+        }
+
+        template <typename T, typename S>
+        static T underflow(const S value)
+        {
+            return detail::handle_numeric_cast_failure<T, S>(numeric_cast_errc::underflow, value,
+                                                             detail::numeric_cast_site());
+        }
 
-#if __cplusplus < 201703L
-    // void_t is not defined until C++17
-    template<class...> struct make_void { using type = void; };
-    template<class... Ts> using void_t = typename make_void<Ts...>::type;
-#endif
+        template <typename T, typename S>
+        static T cast(const S value)
+        {
+            return detail::range_checked_cast<T, S, report>(value);
+        }
+    };
+}
 
-    template<class T, class = void>
-    struct supports_arithmetic_operations : std::false_type {};
-    
-    template<class T>
-    struct supports_arithmetic_operations<T, 
-               void_t<decltype(std::declval<T>() + std::declval<T>()),
-                      decltype(std::declval<T>() - std::declval<T>()),
-                      decltype(std::declval<T>() * std::declval<T>()),
-                      decltype(std::declval<T>() / std::declval<T>())>> 
-           : std::true_type {};
+/// rounding policies of floating point to integer conversion, applied before the range check.
+/// A policy has the member `template <typename S> static S round(const S value)`, giving an
+/// integral value of the floating point or user defined type S, and `mode`, the rounding
+/// control encoding of the x86 round instructions, used by the bulk SIMD kernels
+namespace round_policy {
 
-    /// type_trait to test if numeric_limits<T> is instantiatable
-    template<class T, class = void>
-    struct _is_numeric : std::false_type {};
-    
-    template<class T>
-    struct _is_numeric<T, 
-               void_t<decltype(std::numeric_limits<T>::max()),
-               decltype(std::numeric_limits<T>::min())>> 
-           : std::true_type {};
- 
-    template <typename T, typename S,
-        typename std::enable_if<std::is_arithmetic<S>::value
-        || supports_arithmetic_operations<S>::value, int>::type = 0>
-#if __cplusplus >= 201703L
-    T constexpr numeric_cast(const S value)
-#else
-    T numeric_cast(const S value)
-#endif
+    /// base of all rounding policies
+    struct policy_tag {};
+
+    /// toward zero as `static_cast`, but the range is checked on the truncated value,
+    /// so that e.g. `2147483647.5` is converted to `int32_t`
+    struct truncate : policy_tag
     {
-        // todo:  warning: comparison between signed and unsigned integer expressions [-Wsign-compare]
-        if (value > std::numeric_limits<T>::max())
+        static constexpr int mode = 3;
+
+        template <typename S>
+        static S round(const S value)
         {
-            throw std::overflow_error(
-                "input value overflows the target type");
+            using std::trunc;
+            return trunc(value);
+        }
+    };
+
+    /// to nearest, ties to even, by `rint` in the default floating point environment,
+    /// i.e. `roundsd` with SSE4.1 or the same as `cvtsd2si`
+    struct nearest_even : policy_tag
+    {
+        static constexpr int mode = 0;
+
+        template <typename S>
+        static S round(const S value)
+        {
+            using std::rint;
+            return rint(value);
         }
-        if (value < std::numeric_limits<T>::min())
+    };
+
+    /// toward negative infinity
+    struct floor : policy_tag
+    {
+        static constexpr int mode = 1;
+
+        template <typename S>
+        static S round(const S value)
         {
-            // todo: message
-            throw underflow_error(
-                "input value underflows the target type");
+            using std::floor;
+            return floor(value);
         }
-        return static_cast<T>(value);
+    };
+
+    /// toward positive infinity
+    struct ceil : policy_tag
+    {
+        static constexpr int mode = 2;
+
+        template <typename S>
+        static S round(const S value)
+        {
+            using std::ceil;
+            return ceil(value);
+        }
+    };
+
+    /// no rounding, a value which is not an integer is an error: `numeric_cast_errc::inexact`
+    /// of `try_numeric_cast<T>()`, or `std::range_error` of `numeric_cast<T>()`, with an overflow
+    /// policy it is handled by that policy as an out-of-range value, see `detail::inexact_policy`.
+    /// It has no SIMD rounding mode, the bulk conversion checks element by element
+    struct exact : policy_tag
+    {
+        static constexpr int mode = -1;
+
+        template <typename S>
+        static S round(const S value)
+        {
+            using std::trunc;
+            return trunc(value) == value || value != value ? value
+                : detail::numeric_cast_failure<S, S>(numeric_cast_errc::inexact, value);
+        }
+    };
+
+    /// to nearest, ties away from zero as `std::round`. For built-in floating point types,
+    /// `trunc(value +/- predecessor of 0.5)` is exact, and it is inlined unlike `std::round`
+    struct nearest_away : policy_tag
+    {
+        static constexpr int mode = 4;
+
+        template <typename S,
+            typename std::enable_if<std::is_floating_point<S>::value, int>::type = 0>
+        static S round(const S value)
+        {
+            const S below_half = S(0.5) - std::numeric_limits<S>::epsilon() / 4;
+            return std::trunc(value + std::copysign(below_half, value));
+        }
+
+        template <typename S,
+            typename std::enable_if<!std::is_floating_point<S>::value, int>::type = 0>
+        static S round(const S value)
+        {
+            using std::round;
+            return round(value);
+        }
+    };
+}
+
+/// NaN policies of floating point to integer conversion, applied before rounding and the range check.
+/// A policy has `mapped`, false if NaN is left to the overflow policy,
+/// and `template <typename T> static T value()`, the result for NaN.
+/// Infinity is out of range as any other large value, handled by the overflow policy
+namespace nan_policy {
+
+    /// base of all NaN policies
+    struct policy_tag {};
+
+    /// the default: NaN is out of range, `std::range_error` by `overflow_policy::throw_on_overflow`,
+    /// `quiet_NaN()` of T by `saturate`, `on_overflow` by `user_callback`
+    struct as_overflow : policy_tag
+    {
+        static constexpr bool mapped = false;
+
+        template <typename T>
+        static constexpr T value() noexcept
+        {
+            return T();
+        }
+    };
+
+    /// NaN is converted to zero, e.g. a missing sample
+    struct to_zero : policy_tag
+    {
+        static constexpr bool mapped = true;
+
+        template <typename T>
+        static constexpr T value() noexcept
+        {
+            return T(0);
+        }
+    };
+
+    /// NaN is converted to `numeric_limits<T>::lowest()`, e.g. a sentinel of integer data
+    struct to_lowest : policy_tag
+    {
+        static constexpr bool mapped = true;
+
+        template <typename T>
+        static constexpr T value() noexcept
+        {
+            return std::numeric_limits<T>::lowest();
+        }
+    };
+
+    /// NaN is converted to `numeric_limits<T>::max()`
+    struct to_max : policy_tag
+    {
+        static constexpr bool mapped = true;
+
+        template <typename T>
+        static constexpr T value() noexcept
+        {
+            return std::numeric_limits<T>::max();
+        }
+    };
+}
+
+    /// true if P is an overflow policy, derived from `overflow_policy::policy_tag`
+    template <typename P>
+    struct is_overflow_policy : std::is_base_of<overflow_policy::policy_tag, P> {};
+
+    /// true if P is a rounding policy, derived from `round_policy::policy_tag`
+    template <typename P>
+    struct is_round_policy : std::is_base_of<round_policy::policy_tag, P> {};
+
+    /// true if P is a NaN policy, derived from `nan_policy::policy_tag`
+    template <typename P>
+    struct is_nan_policy : std::is_base_of<nan_policy::policy_tag, P> {};
+
+namespace detail{
+
+    /// integer value needs no rounding
+    template <typename Round, typename S,
+        typename std::enable_if<std::is_integral<S>::value, int>::type = 0>
+    constexpr S round_value(const S value) noexcept
+    {
+        return value;
     }
 
-    template <typename T, typename S,
-        typename std::enable_if<std::is_arithmetic<S>::value
-        || supports_arithmetic_operations<S>::value, int>::type = 0>
-    bool convertible(const S value) noexcept
+    template <typename Round, typename S,
+        typename std::enable_if<!std::is_integral<S>::value, int>::type = 0>
+    S round_value(const S value)
+    {
+        return Round::round(value);
+    }
+
+    /// the default if no rounding policy is given: the range is checked on the value
+    /// before the truncation of `static_cast`, as `numeric_cast<T>()`
+    struct no_rounding
     {
-        if (value > std::numeric_limits<T>::max())
+        template <typename S>
+        static S round(const S value)
         {
-            return false;
+            return value;
+        }
+    };
+
+    /// true if all of Policies are overflow, rounding or NaN policies
+    template <typename... Policies>
+    struct are_cast_policies : std::true_type {};
+
+    template <typename P, typename... Policies>
+    struct are_cast_policies<P, Policies...> : std::integral_constant<bool,
+        (is_overflow_policy<P>::value || is_round_policy<P>::value || is_nan_policy<P>::value)
+        && are_cast_policies<Policies...>::value> {};
+
+    /// the first of Policies derived from Tag, or Default if none
+    template <typename Tag, typename Default, typename... Policies>
+    struct select_policy
+    {
+        typedef Default type;
+    };
+
+    template <typename Tag, typename Default, typename P, typename... Policies>
+    struct select_policy<Tag, Default, P, Policies...>
+    {
+        typedef typename std::conditional<std::is_base_of<Tag, P>::value, P,
+            typename select_policy<Tag, Default, Policies...>::type>::type type;
+    };
+
+    /// true if the value is not an integer, for `round_policy::exact` only
+    template <typename Round, typename S,
+        typename std::enable_if<!std::is_same<Round, round_policy::exact>::value
+        || std::is_integral<S>::value, int>::type = 0>
+    constexpr bool inexact(const S) noexcept
+    {
+        return false;
+    }
+
+    template <typename Round, typename S,
+        typename std::enable_if<std::is_same<Round, round_policy::exact>::value
+        && !std::is_integral<S>::value, int>::type = 0>
+    bool inexact(const S value) noexcept
+    {
+        using std::trunc;
+        return !is_nan(value) && trunc(value) != value;
+    }
+
+    /// the non-throwing conversion with a rounding policy
+    template <typename T, typename Round, typename S>
+    numeric_cast_result<T> try_round_cast(const S value) noexcept
+    {
+        return inexact<Round, S>(value) ? numeric_cast_result<T>(numeric_cast_errc::inexact)
+            : try_cast<T, S>(round_value<Round, S>(value));
+    }
+
+    /// a value which is not an integer by `round_policy::exact` is an error of the overflow policy:
+    /// `std::range_error` by default and for policies not listed here, otherwise as an out-of-range
+    /// value, i.e. `saturate`, `wrap` and `assume_in_range` convert the truncated value,
+    /// `terminate` terminates, `user_callback` passes it to `on_overflow` as NaN, and `report`
+    /// passes `numeric_cast_errc::inexact` to the failure handler, then converts the truncated value
+    template <typename Overflow>
+    struct inexact_policy
+    {
+        template <typename T, typename S>
+        static T cast(const S value)
+        {
+            return Overflow::template cast<T, S>(round_policy::exact::round(value));
         }
-        if (value < std::numeric_limits<T>::min())
+    };
+
+    template <typename Overflow>
+    struct inexact_as_truncated
+    {
+        template <typename T, typename S>
+        static T cast(const S value)
         {
-            return false;
+            return Overflow::template cast<T, S>(round_policy::truncate::round(value));
         }
-        return true;
+    };
+
+    template <> struct inexact_policy<overflow_policy::saturate> : inexact_as_truncated<overflow_policy::saturate> {};
+    template <> struct inexact_policy<overflow_policy::wrap> : inexact_as_truncated<overflow_policy::wrap> {};
+    template <> struct inexact_policy<overflow_policy::assume_in_range>
+        : inexact_as_truncated<overflow_policy::assume_in_range> {};
+
+    template <>
+    struct inexact_policy<overflow_policy::terminate>
+    {
+        template <typename T, typename S>
+        [[noreturn]] static T cast(const S) noexcept
+        {
+            std::terminate();
+        }
+    };
+
+    template <typename Handler>
+    struct inexact_policy<overflow_policy::user_callback<Handler>>
+    {
+        template <typename T, typename S>
+        static T cast(const S value)
+        {
+            return Handler::template on_overflow<T>(value);
+        }
+    };
+
+    template <>
+    struct inexact_policy<overflow_policy::report>
+    {
+        template <typename T, typename S>
+        static T cast(const S value)
+        {
+            report_numeric_cast_failure<T, S>(numeric_cast_errc::inexact, value, numeric_cast_site());
+            return overflow_policy::report::cast<T, S>(round_policy::truncate::round(value));
+        }
+    };
+
+    /// map NaN by the NaN policy, round by the rounding policy, then convert by the overflow policy.
+    /// `is_nan()` of integer is constant false, so the NaN test is only compiled for floating point
+    template <typename T, typename S, typename... Policies>
+    T policy_cast(const S value)
+    {
+        typedef typename select_policy<overflow_policy::policy_tag,
+            overflow_policy::throw_on_overflow, Policies...>::type overflow;
+        typedef typename select_policy<round_policy::policy_tag, no_rounding, Policies...>::type rounding;
+        typedef typename select_policy<nan_policy::policy_tag, nan_policy::as_overflow, Policies...>::type nan_handling;
+        return nan_handling::mapped && is_nan(value) ? nan_handling::template value<T>()
+            : inexact<rounding, S>(value) ? inexact_policy<overflow>::template cast<T, S>(value)
+            : overflow::template cast<T, S>(round_value<rounding, S>(value));
+    }
+
+    /// `to_unsigned<T>()` to a signed T still rejects a negative value, as it does for an unsigned T
+    template <typename T, typename S,
+        typename std::enable_if<std::is_unsigned<T>::value || !std::numeric_limits<S>::is_signed, int>::type = 0>
+    constexpr bool negative_to_unsigned(const S) noexcept
+    {
+        return false;
     }
 
+    template <typename T, typename S,
+        typename std::enable_if<!std::is_unsigned<T>::value && std::numeric_limits<S>::is_signed, int>::type = 0>
+    constexpr bool negative_to_unsigned(const S value) noexcept
+    {
+        return value < S(0);
+    }
+
+    /// the target of a negative value of `to_unsigned<T, Policies...>()` to a signed T: the unsigned
+    /// type of the same width, so that the value underflows by the policy as for an unsigned T
+    template <typename T>
+    struct unsigned_proxy : std::conditional<std::is_signed<T>::value,
+        std::make_unsigned<T>, std::remove_cv<T>>::type {};
+
+    template <typename T, typename S, typename... Policies>
+    T to_unsigned_policy_cast(const S value)
+    {
+        return negative_to_unsigned<T, S>(value)
+            ? static_cast<T>(policy_cast<typename unsigned_proxy<T>::type, S, Policies...>(value))
+            : policy_cast<T, S, Policies...>(value);
+    }
 }
 
     template<class T> using is_numeric = detail::_is_numeric<T>;
 
     /// convert to built-in arithmetic type and half, boost::multiprecision::int128_t
     template <typename T, typename S, 
-        typename std::enable_if<std::is_arithmetic<T>::value
-        || detail::supports_arithmetic_operations<T>::value, int>::type = 0>
-    bool is_numeric_convertible(const S value) noexcept
+        typename std::enable_if<(std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value) && !std::is_enum<S>::value, int>::type = 0>
+    constexpr bool is_numeric_convertible(const S value) noexcept
     {
-        return detail::convertible<T, S>(value);
+        return detail::is_unchecked_conversion<T, S>::value || detail::convertible_or_special<T, S>(value);
     }
 
     /// specialization for enum source type
     template <typename T, typename E, 
         typename std::enable_if<std::is_enum<E>::value
         && std::is_integral<T>::value, int>::type = 0>
-    bool is_numeric_convertible(const E e)
+    constexpr bool is_numeric_convertible(const E e) noexcept
+    {
+        return detail::convertible<T, typename std::underlying_type<E>::type>(
+            static_cast<typename std::underlying_type<E>::type>(e));
+    }
+
+#if !defined(__cpp_lib_integer_comparison_functions)
+    /// usage `if (cmp_less(i, v.size()))`, `std::cmp_equal()`, `cmp_less()` etc. of C++20 for C++11:
+    /// integer comparison by the mathematical value, without the unsigned conversion
+    /// of mixed-sign `a < b`, e.g. `cmp_less(-1, 0u)` is true. Since C++20, those of <utility> are used
+    template <typename A, typename B,
+        typename std::enable_if<detail::is_standard_integer<A>::value
+        && detail::is_standard_integer<B>::value, int>::type = 0>
+    constexpr bool cmp_equal(const A a, const B b) noexcept
+    {
+        return detail::cmp_equal(a, b);
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::is_standard_integer<A>::value
+        && detail::is_standard_integer<B>::value, int>::type = 0>
+    constexpr bool cmp_not_equal(const A a, const B b) noexcept
     {
-        typedef typename std::underlying_type<E>::type enum_under_type;
-        enum_under_type value = static_cast<enum_under_type>(e);
-        return detail::convertible<T, E>(value);
+        return !detail::cmp_equal(a, b);
     }
 
+    template <typename A, typename B,
+        typename std::enable_if<detail::is_standard_integer<A>::value
+        && detail::is_standard_integer<B>::value, int>::type = 0>
+    constexpr bool cmp_less(const A a, const B b) noexcept
+    {
+        return detail::cmp_less(a, b);
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::is_standard_integer<A>::value
+        && detail::is_standard_integer<B>::value, int>::type = 0>
+    constexpr bool cmp_greater(const A a, const B b) noexcept
+    {
+        return detail::cmp_less(b, a);
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::is_standard_integer<A>::value
+        && detail::is_standard_integer<B>::value, int>::type = 0>
+    constexpr bool cmp_less_equal(const A a, const B b) noexcept
+    {
+        return !detail::cmp_less(b, a);
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<detail::is_standard_integer<A>::value
+        && detail::is_standard_integer<B>::value, int>::type = 0>
+    constexpr bool cmp_greater_equal(const A a, const B b) noexcept
+    {
+        return !detail::cmp_less(a, b);
+    }
+
+    /// usage `if (in_range<int16_t>(value))`, `std::in_range()` of C++20 for C++11, true if
+    /// T can hold the value, the same check as `numeric_cast<T>()`, by a single compare
+    template <typename T, typename S,
+        typename std::enable_if<detail::is_standard_integer<T>::value
+        && detail::is_standard_integer<S>::value, int>::type = 0>
+    constexpr bool in_range(const S value) noexcept
+    {
+        return detail::convertible<T, S>(value);
+    }
+#endif
+
     /// convert to built-in arithmetic type and half, boost::multiprecision::int128_t
     template <typename T, typename S, 
         typename std::enable_if<std::is_arithmetic<T>::value
         || detail::supports_arithmetic_operations<T>::value, int>::type = 0>
+    NUMERIC_CAST_ALWAYS_INLINE constexpr T numeric_cast(const S v NUMERIC_CAST_LOCATION_PARAMETER)
+    {
+        return detail::numeric_cast<T, S>(v, NUMERIC_CAST_LOCATION);
+    }
+
+    /// usage `int i = numeric_cast<int, overflow_policy::saturate>(value);`,
+    /// out-of-range value is handled by the overflow policy instead of throwing.
+    /// A rounding policy may be given too, in any order, e.g.
+    /// `numeric_cast<int, round_policy::nearest_even, overflow_policy::saturate>(value)`,
+    /// the range is then checked on the rounded value, and a NaN policy,
+    /// e.g. `numeric_cast<int, nan_policy::to_zero>(value)`
+    template <typename T, typename... Policies, typename S,
+        typename std::enable_if<(std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value)
+        && sizeof...(Policies) != 0 && detail::are_cast_policies<Policies...>::value, int>::type = 0>
     T numeric_cast(const S v)
     {
-        return detail::numeric_cast<T, S>(v);
+        return detail::policy_cast<T, S, Policies...>(v);
+    }
+
+    /// usage `auto r = try_numeric_cast<int>(value);`, the non-throwing `numeric_cast<T>()`,
+    /// gives the converted value or the error, see numeric_cast_result
+    template <typename T, typename S,
+        typename std::enable_if<std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value, int>::type = 0>
+    constexpr numeric_cast_result<T> try_numeric_cast(const S value) noexcept
+    {
+        return detail::try_cast<T, S>(value);
+    }
+
+    /// with a rounding policy, e.g. `try_numeric_cast<int, round_policy::exact>(value)`
+    template <typename T, typename Round, typename S,
+        typename std::enable_if<(std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value)
+        && is_round_policy<Round>::value, int>::type = 0>
+    numeric_cast_result<T> try_numeric_cast(const S value) noexcept
+    {
+        return detail::try_round_cast<T, Round, S>(value);
+    }
+
+    /// usage `int16_t s = saturate_cast<int16_t>(sample);`, out-of-range value is clamped
+    /// to the nearest limit of the target type instead of throwing, without branch.
+    /// NaN is converted to `nan_value`, by default `numeric_limits<T>::quiet_NaN()`,
+    /// which is zero for integer and NaN for floating point target type, infinity to a
+    /// floating point target type stays infinity
+    template <typename T, typename S,
+        typename std::enable_if<std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value, int>::type = 0>
+    T saturate_cast(const S value, const T nan_value = std::numeric_limits<T>::quiet_NaN())
+    {
+        return detail::saturate_cast<T, S>(value, nan_value);
     }
 
     /// usage `int s = to_integer<int>(value);`, by auto template type derivation,
@@ -129,31 +1898,50 @@ namespace detail{
     /// target signed can be any arithmetic type, but should be signed integer
     /// to floating point is possible with lost precision
     template <typename T, typename S, 
-        typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+        typename std::enable_if<std::is_integral<T>::value && !std::is_enum<S>::value, int>::type = 0>
+    NUMERIC_CAST_ALWAYS_INLINE constexpr T to_integer(const S v NUMERIC_CAST_LOCATION_PARAMETER)
+    {
+        return detail::numeric_cast<T, S>(v, NUMERIC_CAST_LOCATION);
+    }
+
+    /// the non-throwing `to_integer<T>()`, target type must be integer
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<T>::value && !std::is_enum<S>::value, int>::type = 0>
+    constexpr numeric_cast_result<T> try_to_integer(const S value) noexcept
+    {
+        return detail::try_cast<T, S>(value);
+    }
+
+    template <typename T, typename E,
+        typename std::enable_if<std::is_enum<E>::value
+        && std::is_integral<T>::value, int>::type = 0>
+    constexpr numeric_cast_result<T> try_to_integer(const E e) noexcept
+    {
+        return detail::try_cast<T>(static_cast<typename std::underlying_type<E>::type>(e));
+    }
+
+    template <typename T, typename Round, typename S,
+        typename std::enable_if<std::is_integral<T>::value && is_round_policy<Round>::value, int>::type = 0>
+    numeric_cast_result<T> try_to_integer(const S value) noexcept
+    {
+        return detail::try_round_cast<T, Round, S>(value);
+    }
+
+    /// usage `int s = to_integer<int, round_policy::floor>(value);`, with overflow and rounding policies
+    template <typename T, typename... Policies, typename S,
+        typename std::enable_if<std::is_integral<T>::value
+        && sizeof...(Policies) != 0 && detail::are_cast_policies<Policies...>::value, int>::type = 0>
     T to_integer(const S v)
     {
-        return detail::numeric_cast<T, S>(v);
+        return detail::policy_cast<T, S, Policies...>(v);
     }
 
     template <typename T, typename E, 
         typename std::enable_if<std::is_enum<E>::value
         && std::is_integral<T>::value, int>::type = 0>
-    T to_integer(const E e)
+    constexpr T to_integer(const E e NUMERIC_CAST_LOCATION_PARAMETER)
     {
-        typedef typename std::underlying_type<E>::type enum_under_type;
-        enum_under_type value = static_cast<enum_under_type>(e);
-        if (value > std::numeric_limits<T>::max())
-        {
-            throw std::overflow_error(
-                "input enum as an integer value overflows the target type");
-        }
-        if (value < std::numeric_limits<T>::min())
-        {
-            // todo: message
-            throw underflow_error(
-                "input enum as an integer value underflows the target type");
-        }
-        return static_cast<T>(value);
+        return detail::checked_value<T, E>(try_to_integer<T>(e), e, NUMERIC_CAST_LOCATION);
     }
 
 // confliction with <cstddef> in C++17
@@ -178,41 +1966,64 @@ namespace detail{
     template  <typename T, typename S,
         typename enable_if<is_arithmetic<S>::value
              || detail::supports_arithmetic_operations<S>::value, int>::type = 0>
-    T to_unsigned(const S signed_value)
+    NUMERIC_CAST_ALWAYS_INLINE constexpr T to_unsigned(const S signed_value NUMERIC_CAST_LOCATION_PARAMETER)
     {
-        if (signed_value > numeric_limits<T>::max())
-        {
-            throw overflow_error(
-                "input value overflow the target type");
-        }
-        if (signed_value < 0)
-        {
-            throw underflow_error(
-                "signed value less than zero should not be converted to unsigned integer");
-        }
-        return static_cast<T>(signed_value);
+        return detail::checked_value<T, S>(detail::negative_to_unsigned<T, S>(signed_value)
+            ? numeric_cast_result<T>(numeric_cast_errc::underflow) : detail::try_cast<T, S>(signed_value),
+            signed_value, NUMERIC_CAST_LOCATION);
+    }
+
+    /// the non-throwing `to_unsigned<T>()`, negative value is `numeric_cast_errc::underflow`,
+    /// also for a signed T
+    template <typename T, typename S,
+        typename std::enable_if<!std::is_enum<S>::value, int>::type = 0>
+    constexpr numeric_cast_result<T> try_to_unsigned(const S value) noexcept
+    {
+        return detail::negative_to_unsigned<T, S>(value) ? numeric_cast_result<T>(numeric_cast_errc::underflow)
+            : detail::try_cast<T, S>(value);
+    }
+
+    template <typename T, typename E,
+        typename std::enable_if<std::is_integral<T>::value && std::is_enum<E>::value, int>::type = 0>
+    constexpr numeric_cast_result<T> try_to_unsigned(const E e) noexcept
+    {
+        return detail::negative_to_unsigned<T>(static_cast<typename std::underlying_type<E>::type>(e))
+            ? numeric_cast_result<T>(numeric_cast_errc::underflow)
+            : detail::try_cast<T>(static_cast<typename std::underlying_type<E>::type>(e));
+    }
+
+    /// a negative value is rounded as for an unsigned T, e.g. -0.4 by `round_policy::nearest_away` is 0
+    template <typename T, typename Round, typename S,
+        typename std::enable_if<std::is_integral<T>::value && is_round_policy<Round>::value, int>::type = 0>
+    numeric_cast_result<T> try_to_unsigned(const S value) noexcept
+    {
+        return detail::negative_to_unsigned<T, S>(value)
+            ? detail::to_enum_result<T>(detail::try_round_cast<typename detail::unsigned_proxy<T>::type, Round, S>(value))
+            : detail::try_round_cast<T, Round, S>(value);
+    }
+
+    /// usage `size_t s = to_unsigned<size_t, overflow_policy::saturate>(value);`,
+    /// negative value is an underflow of the policy, also for a signed T
+    template <typename T, typename... Policies, typename S,
+        typename std::enable_if<std::is_integral<T>::value
+        && sizeof...(Policies) != 0 && detail::are_cast_policies<Policies...>::value, int>::type = 0>
+    T to_unsigned(const S value)
+    {
+        return detail::to_unsigned_policy_cast<T, S, Policies...>(value);
     }
+
     //template< typename T, typename U> std::string to_unsigned( const U& unsigned_int) 
     //{ return to_integer<T, U>(unsigned_int) ; }
 
 
     template  <typename T, typename E,
-        typename enable_if<is_enum<E>::value, int>::type = 0>
-    T to_unsigned(const E enum_value)
+        typename enable_if<is_enum<E>::value && is_integral<T>::value, int>::type = 0>
+    constexpr T to_unsigned(const E enum_value NUMERIC_CAST_LOCATION_PARAMETER)
     {
-        using enum_under_type = typename underlying_type<E>::type;
-        enum_under_type value = static_cast<enum_under_type>(enum_value);
-        if (value > numeric_limits<T>::max())
-        {
-            throw overflow_error(
-                "input value overflow the target type");
-        }
-        if (value < 0)
-        {
-            throw underflow_error(
-                "signed value less than zero should not be converted to unsigned integer");
-        }
-        return static_cast<T>(value);
+        return detail::checked_value<T, E>(detail::negative_to_unsigned<T>(
+            static_cast<typename underlying_type<E>::type>(enum_value))
+            ? numeric_cast_result<T>(numeric_cast_errc::underflow) : try_to_integer<T>(enum_value),
+            enum_value, NUMERIC_CAST_LOCATION);
     }
 
 #if __cplusplus >= 201703L
@@ -223,38 +2034,35 @@ namespace detail{
     {
         if (signed_value > std::numeric_limits<unsigned char>::max())
         {
-            throw std::overflow_error(
-                "input value overflow the target type std::byte (unsigned char)");
+            detail::throw_numeric_cast_error<std::byte, S>(numeric_cast_errc::overflow, signed_value);
         }
         if (signed_value < 0)
         {
-            throw std::underflow_error(
-                "signed value less than zero should not be converted to std::byte");
+            detail::throw_numeric_cast_error<std::byte, S>(numeric_cast_errc::underflow, signed_value);
         }
         return std::byte{signed_value};
     }
 
 #endif
+    /// the non-throwing `to_enum<E>()`, the value is checked against the underlying type
+    template <typename E, typename S,
+        typename std::enable_if<std::is_enum<E>::value, int>::type = 0>
+    constexpr numeric_cast_result<E> try_to_enum(const S value) noexcept
+    {
+        return detail::to_enum_result<E>(detail::try_cast<typename std::underlying_type<E>::type, S>(value));
+    }
+
     // a new name as enum_cast?
     template <typename E, typename S, 
         typename std::enable_if<std::is_enum<E>::value, int>::type = 0>
-    E to_enum(const S value)
+    constexpr E to_enum(const S value NUMERIC_CAST_LOCATION_PARAMETER)
     {
-        using enum_under_type = typename std::underlying_type<E>::type;
-        const enum_under_type enum_value = to_integer<enum_under_type>(value);
-        /*
-        if (value > std::numeric_limits<enum_under_type>::max())
-        {
-            throw std::overflow_error(
-                "input value overflow the target type std::byte (unsigned char)");
-        }
-        if (value < std::numeric_limits<enum_under_type>::min())
-        {
-            throw std::underflow_error(
-                "signed value less than zero should not be converted to std::byte");
-        }
-        */
-        return E{enum_value};  /// enum is not validated for existence!
+        /// enum is not validated for existence!
+        return detail::checked_value<E, S>(try_to_enum<E>(value), value, NUMERIC_CAST_LOCATION);
     }
 
-}
\ No newline at end of file
+}
+
+#if NUMERIC_CAST_INSTRUMENTED
+#include "numeric_cast_stats.h"
+#endif
@@ -0,0 +1,2074 @@
+/***********************************************************
+//              copyright Qingfeng Xia, 2020
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+************************************************************/
+
+/**
+* bulk (array) version of numeric_cast, this is a header-only library
+*
+* `std::numeric_cast_n<T>(in, out, n)` gives the same result as calling
+* `std::numeric_cast<T>()` for each element, but the range check of a whole
+* block is done at once, by SIMD compare instructions for the most common
+* type pairs, and by a branch-free loop the compiler can vectorize otherwise.
+*
+* On x86 with GCC or clang, kernels for SSE2, AVX2 and AVX-512 are all compiled,
+* the best one for the running CPU is selected at the first call and cached.
+*
+* `std::is_numeric_convertible_n<T>(in, n, mask)` is the bulk version of
+* `std::is_numeric_convertible<T>()`, giving a bitmask and the count of convertible elements.
+*
+* `std::saturate_cast_n<T>(in, out, n)` is the bulk version of `std::saturate_cast<T>()`,
+* by SIMD min/max and saturating packs.
+*
+* `std::numeric_cast_n<T, Round>(in, out, n)` rounds by a `round_policy` before the range check,
+* `std::numeric_cast_n<T, Nan>(in, out, n)` converts NaN by a `nan_policy`.
+*
+* `std::is_nan_n(in, n, mask)` finds NaN by SIMD unordered compare.
+*
+* `std::cmp_less_n(a, b, n, mask)`, `cmp_equal_n` etc. compare arrays of integers of mixed signs
+* element-wise as `std::cmp_less()`, into the same bitmask, by SIMD for 32-bit integers.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "numeric_cast.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NUMERIC_CAST_HAS_SSE2 1
+#endif
+
+/// runtime CPU dispatch: kernels of all the instruction sets are compiled by
+/// function attributes, the best one is selected by cpuid at the first call.
+/// Define NUMERIC_CAST_NO_DISPATCH to select by the compiler `-m` flags only
+#if !defined(NUMERIC_CAST_NO_DISPATCH) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define NUMERIC_CAST_DISPATCH 1
+#define NUMERIC_CAST_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NUMERIC_CAST_TARGET(isa)
+#endif
+
+#if NUMERIC_CAST_HAS_SSE2 || NUMERIC_CAST_DISPATCH
+#include <immintrin.h>
+#endif
+
+/// GCC warns -Wmaybe-uninitialized on the `_mm512_undefined_*()` of its own intrinsic
+/// headers when they are inlined into the AVX2 and AVX-512 kernels, a false positive
+#if defined(__GNUC__) && !defined(__clang__)
+#define NUMERIC_CAST_SIMD_WARNINGS_PUSH _Pragma("GCC diagnostic push") \
+    _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define NUMERIC_CAST_SIMD_WARNINGS_POP _Pragma("GCC diagnostic pop")
+#else
+#define NUMERIC_CAST_SIMD_WARNINGS_PUSH
+#define NUMERIC_CAST_SIMD_WARNINGS_POP
+#endif
+
+#if NUMERIC_CAST_DISPATCH
+#include <atomic>
+#endif
+
+#if __cplusplus > 201703L  && __has_include(<span>)  // C++20
+#include <span>
+#endif
+
+namespace std {
+
+namespace detail{
+
+    /// elements checked by one kernel call, if any of them fails the check,
+    /// the block is converted again by the scalar numeric_cast() to throw
+    /// at the offending element. Small enough to stay in L1 cache.
+    const size_t bulk_block_size = 256;
+
+    /// portable kernel: out-of-range elements are not converted, only recorded,
+    /// so this loop has no branch and no undefined behaviour
+    template <typename T, typename S>
+    bool bulk_cast_generic(const S* in, T* out, size_t n) noexcept
+    {
+        bool ok = true;
+        for (size_t i = 0; i < n; i++)
+        {
+            const bool in_range = convertible<T, S>(in[i]);
+            out[i] = in_range ? static_cast<T>(in[i]) : T();
+            ok &= in_range;
+        }
+        return ok;
+    }
+
+    /// portable saturating loop, also the scalar tail of the SIMD kernels
+    template <typename T, typename S>
+    void saturate_generic(const S* in, T* out, size_t n, const T nan_value)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = saturate_cast<T, S>(in[i], nan_value);
+        }
+    }
+
+    /// portable rounding loop by the scalar rounding policy
+    template <typename Round, typename S>
+    void round_generic(const S* in, S* out, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = Round::round(in[i]);
+        }
+    }
+
+    /// tag of the SIMD rounding functions, `Round::mode` of the rounding policy
+    template <int Mode>
+    using round_mode = std::integral_constant<int, Mode>;
+
+    /// the same check as `is_numeric_convertible()`, one bit per element
+    template <typename T, typename S>
+    uint64_t convertible_bits_generic(const S* in, size_t n) noexcept
+    {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            bits |= static_cast<uint64_t>(convertible_or_special<T, S>(in[i])) << i;
+        }
+        return bits;
+    }
+
+    /// the same test as the SIMD nan_bits(), one bit per element
+    template <typename S>
+    uint64_t nan_bits_generic(const S* in, size_t n) noexcept
+    {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            bits |= static_cast<uint64_t>(is_nan(in[i])) << i;
+        }
+        return bits;
+    }
+
+    /// the comparisons of `cmp_less_n()` etc., the others are the negation
+    /// or the swapped operands of these two
+    struct less_comparison
+    {
+        template <typename A, typename B>
+        static constexpr bool compare(const A a, const B b) noexcept
+        {
+            return cmp_less(a, b);
+        }
+    };
+
+    struct equal_comparison
+    {
+        template <typename A, typename B>
+        static constexpr bool compare(const A a, const B b) noexcept
+        {
+            return cmp_equal(a, b);
+        }
+    };
+
+    /// the same comparison as the SIMD cmp_bits(), one bit per pair
+    template <typename Comparison, typename A, typename B>
+    uint64_t cmp_bits_generic(const A* a, const B* b, size_t n) noexcept
+    {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            bits |= static_cast<uint64_t>(Comparison::compare(a[i], b[i])) << i;
+        }
+        return bits;
+    }
+
+    inline size_t popcount64(uint64_t bits) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<size_t>(__builtin_popcountll(bits));
+#else
+        size_t count = 0;
+        for (; bits; bits &= bits - 1)
+            count++;
+        return count;
+#endif
+    }
+
+    /// inclusive bounds of the source values that are convertible to the target type,
+    /// for the type pairs with SIMD kernels, exact for floating point source by `float_int_bounds`
+    template <typename T, typename S> struct bulk_bounds
+    {
+        static constexpr S lo() { return float_int_bounds<T, S>::lower(); }
+        static constexpr S hi() { return float_int_bounds<T, S>::upper(); }
+    };
+
+    template <> struct bulk_bounds<uint16_t, int32_t>
+    {
+        static constexpr int32_t lo() { return 0; }
+        static constexpr int32_t hi() { return 65535; }
+    };
+
+    template <> struct bulk_bounds<int16_t, int32_t>
+    {
+        static constexpr int32_t lo() { return -32768; }
+        static constexpr int32_t hi() { return 32767; }
+    };
+
+#if NUMERIC_CAST_HAS_SSE2 || NUMERIC_CAST_DISPATCH
+    /// The range of the target type is checked by ordered compare against the
+    /// inclusive bounds, i.e. the lowest and the largest source values that fit in
+    /// the target type, negated to NGE/NLE so that NaN is also flagged.
+    /// All the elements are converted; the packed conversion of an out-of-range value
+    /// gives the "integer indefinite" value instead of undefined behaviour.
+    namespace simd_sse2 {
+
+    NUMERIC_CAST_TARGET("sse2") inline bool cast_n(const double* in, int32_t* out, size_t n) noexcept
+    {
+        const __m128d lo = _mm_set1_pd(bulk_bounds<int32_t, double>::lo());
+        const __m128d hi = _mm_set1_pd(bulk_bounds<int32_t, double>::hi());
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128d v0 = _mm_loadu_pd(in + i);
+            const __m128d v1 = _mm_loadu_pd(in + i + 2);
+            bad = _mm_or_pd(bad, _mm_or_pd(_mm_cmpnge_pd(v0, lo), _mm_cmpnle_pd(v0, hi)));
+            bad = _mm_or_pd(bad, _mm_or_pd(_mm_cmpnge_pd(v1, lo), _mm_cmpnle_pd(v1, hi)));
+            const __m128i r = _mm_unpacklo_epi64(_mm_cvttpd_epi32(v0), _mm_cvttpd_epi32(v1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), r);
+        }
+        return (_mm_movemask_pd(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline bool cast_n(const double* in, int16_t* out, size_t n) noexcept
+    {
+        const __m128d lo = _mm_set1_pd(bulk_bounds<int16_t, double>::lo());
+        const __m128d hi = _mm_set1_pd(bulk_bounds<int16_t, double>::hi());
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i r[4];
+            for (int k = 0; k < 4; k++)
+            {
+                const __m128d v = _mm_loadu_pd(in + i + 2 * k);
+                bad = _mm_or_pd(bad, _mm_or_pd(_mm_cmpnge_pd(v, lo), _mm_cmpnle_pd(v, hi)));
+                r[k] = _mm_cvttpd_epi32(v);
+            }
+            // values have been checked, the saturation of packssdw never applies
+            const __m128i p = _mm_packs_epi32(_mm_unpacklo_epi64(r[0], r[1]),
+                                              _mm_unpacklo_epi64(r[2], r[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), p);
+        }
+        return (_mm_movemask_pd(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline bool cast_n(const float* in, int32_t* out, size_t n) noexcept
+    {
+        const __m128 lo = _mm_set1_ps(bulk_bounds<int32_t, float>::lo());
+        const __m128 hi = _mm_set1_ps(bulk_bounds<int32_t, float>::hi());
+        __m128 bad = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 v = _mm_loadu_ps(in + i);
+            bad = _mm_or_ps(bad, _mm_or_ps(_mm_cmpnge_ps(v, lo), _mm_cmpnle_ps(v, hi)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_cvttps_epi32(v));
+        }
+        return (_mm_movemask_ps(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline bool cast_n(const int32_t* in, int16_t* out, size_t n) noexcept
+    {
+        const __m128i lo = _mm_set1_epi32(bulk_bounds<int16_t, int32_t>::lo());
+        const __m128i hi = _mm_set1_epi32(bulk_bounds<int16_t, int32_t>::hi());
+        __m128i bad = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 4));
+            bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmplt_epi32(v0, lo), _mm_cmpgt_epi32(v0, hi)));
+            bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmplt_epi32(v1, lo), _mm_cmpgt_epi32(v1, hi)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(v0, v1));
+        }
+        return (_mm_movemask_epi8(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    /// SSE2 has no unsigned saturating pack (packusdw), the values biased by -32768
+    /// are packed as signed, then the bias is restored by flipping the top bit
+    NUMERIC_CAST_TARGET("sse2") inline bool cast_n(const double* in, uint16_t* out, size_t n) noexcept
+    {
+        const __m128d lo = _mm_set1_pd(bulk_bounds<uint16_t, double>::lo());
+        const __m128d hi = _mm_set1_pd(bulk_bounds<uint16_t, double>::hi());
+        const __m128i bias = _mm_set1_epi32(32768);
+        const __m128i sign = _mm_set1_epi16(-32768);
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i r[4];
+            for (int k = 0; k < 4; k++)
+            {
+                const __m128d v = _mm_loadu_pd(in + i + 2 * k);
+                bad = _mm_or_pd(bad, _mm_or_pd(_mm_cmpnge_pd(v, lo), _mm_cmpnle_pd(v, hi)));
+                r[k] = _mm_cvttpd_epi32(v);
+            }
+            const __m128i p = _mm_packs_epi32(_mm_sub_epi32(_mm_unpacklo_epi64(r[0], r[1]), bias),
+                                              _mm_sub_epi32(_mm_unpacklo_epi64(r[2], r[3]), bias));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(p, sign));
+        }
+        return (_mm_movemask_pd(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline bool cast_n(const int32_t* in, uint16_t* out, size_t n) noexcept
+    {
+        const __m128i lo = _mm_set1_epi32(bulk_bounds<uint16_t, int32_t>::lo());
+        const __m128i hi = _mm_set1_epi32(bulk_bounds<uint16_t, int32_t>::hi());
+        const __m128i bias = _mm_set1_epi32(32768);
+        const __m128i sign = _mm_set1_epi16(-32768);
+        __m128i bad = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 4));
+            bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmplt_epi32(v0, lo), _mm_cmpgt_epi32(v0, hi)));
+            bad = _mm_or_si128(bad, _mm_or_si128(_mm_cmplt_epi32(v1, lo), _mm_cmpgt_epi32(v1, hi)));
+            const __m128i p = _mm_packs_epi32(_mm_sub_epi32(v0, bias), _mm_sub_epi32(v1, bias));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(p, sign));
+        }
+        return (_mm_movemask_epi8(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    /// bit k of the result is set if in[k] is within [lo, hi], for 64 elements
+    NUMERIC_CAST_TARGET("sse2") inline uint64_t in_range_bits(const double* in, double lo_, double hi_) noexcept
+    {
+        const __m128d lo = _mm_set1_pd(lo_);
+        const __m128d hi = _mm_set1_pd(hi_);
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 2)
+        {
+            const __m128d v = _mm_loadu_pd(in + k);
+            const __m128d ok = _mm_and_pd(_mm_cmpge_pd(v, lo), _mm_cmple_pd(v, hi));
+            bits |= static_cast<uint64_t>(_mm_movemask_pd(ok)) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline uint64_t in_range_bits(const float* in, float lo_, float hi_) noexcept
+    {
+        const __m128 lo = _mm_set1_ps(lo_);
+        const __m128 hi = _mm_set1_ps(hi_);
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 4)
+        {
+            const __m128 v = _mm_loadu_ps(in + k);
+            const __m128 ok = _mm_and_ps(_mm_cmpge_ps(v, lo), _mm_cmple_ps(v, hi));
+            bits |= static_cast<uint64_t>(_mm_movemask_ps(ok)) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline uint64_t in_range_bits(const int32_t* in, int32_t lo_, int32_t hi_) noexcept
+    {
+        const __m128i lo = _mm_set1_epi32(lo_);
+        const __m128i hi = _mm_set1_epi32(hi_);
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 4)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + k));
+            const __m128i bad = _mm_or_si128(_mm_cmplt_epi32(v, lo), _mm_cmpgt_epi32(v, hi));
+            bits |= static_cast<uint64_t>(~_mm_movemask_ps(_mm_castsi128_ps(bad)) & 0xF) << k;
+        }
+        return bits;
+    }
+
+    /// NaN bits of 64 elements, one unordered compare per vector
+    NUMERIC_CAST_TARGET("sse2") inline uint64_t nan_bits(const double* in) noexcept
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 2)
+        {
+            const __m128d v = _mm_loadu_pd(in + k);
+            bits |= static_cast<uint64_t>(_mm_movemask_pd(_mm_cmpunord_pd(v, v))) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline uint64_t nan_bits(const float* in) noexcept
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 4)
+        {
+            const __m128 v = _mm_loadu_ps(in + k);
+            bits |= static_cast<uint64_t>(_mm_movemask_ps(_mm_cmpunord_ps(v, v))) << k;
+        }
+        return bits;
+    }
+
+    /// saturating conversion: NaN is replaced by `nan_value`, then maxpd/minpd clamp
+    /// to the bounds, so that the packed conversion and pack never see an out-of-range value
+    NUMERIC_CAST_TARGET("sse2") inline __m128d saturate_pd(__m128d v, __m128d lo, __m128d hi, __m128d nan) noexcept
+    {
+        const __m128d is_nan = _mm_cmpunord_pd(v, v);
+        v = _mm_or_pd(_mm_andnot_pd(is_nan, v), _mm_and_pd(is_nan, nan));
+        return _mm_min_pd(_mm_max_pd(v, lo), hi);
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline void saturate_n(const double* in, int32_t* out, size_t n, int32_t nan_value) noexcept
+    {
+        const __m128d lo = _mm_set1_pd(bulk_bounds<int32_t, double>::lo());
+        const __m128d hi = _mm_set1_pd(bulk_bounds<int32_t, double>::hi());
+        const __m128d nan = _mm_set1_pd(static_cast<double>(nan_value));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128i r0 = _mm_cvttpd_epi32(saturate_pd(_mm_loadu_pd(in + i), lo, hi, nan));
+            const __m128i r1 = _mm_cvttpd_epi32(saturate_pd(_mm_loadu_pd(in + i + 2), lo, hi, nan));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_unpacklo_epi64(r0, r1));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline void saturate_n(const double* in, int16_t* out, size_t n, int16_t nan_value) noexcept
+    {
+        const __m128d lo = _mm_set1_pd(bulk_bounds<int16_t, double>::lo());
+        const __m128d hi = _mm_set1_pd(bulk_bounds<int16_t, double>::hi());
+        const __m128d nan = _mm_set1_pd(static_cast<double>(nan_value));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i r[4];
+            for (int k = 0; k < 4; k++)
+            {
+                r[k] = _mm_cvttpd_epi32(saturate_pd(_mm_loadu_pd(in + i + 2 * k), lo, hi, nan));
+            }
+            const __m128i p = _mm_packs_epi32(_mm_unpacklo_epi64(r[0], r[1]),
+                                              _mm_unpacklo_epi64(r[2], r[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), p);
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline void saturate_n(const double* in, uint16_t* out, size_t n, uint16_t nan_value) noexcept
+    {
+        const __m128d lo = _mm_set1_pd(bulk_bounds<uint16_t, double>::lo());
+        const __m128d hi = _mm_set1_pd(bulk_bounds<uint16_t, double>::hi());
+        const __m128d nan = _mm_set1_pd(static_cast<double>(nan_value));
+        const __m128i bias = _mm_set1_epi32(32768);
+        const __m128i sign = _mm_set1_epi16(-32768);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i r[4];
+            for (int k = 0; k < 4; k++)
+            {
+                r[k] = _mm_cvttpd_epi32(saturate_pd(_mm_loadu_pd(in + i + 2 * k), lo, hi, nan));
+            }
+            const __m128i p = _mm_packs_epi32(_mm_sub_epi32(_mm_unpacklo_epi64(r[0], r[1]), bias),
+                                              _mm_sub_epi32(_mm_unpacklo_epi64(r[2], r[3]), bias));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(p, sign));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    /// cvttps2dq gives INT32_MIN for any value out of range and for NaN, which is already
+    /// the saturated value below the range; above the range it is flipped to INT32_MAX
+    NUMERIC_CAST_TARGET("sse2") inline void saturate_n(const float* in, int32_t* out, size_t n, int32_t nan_value) noexcept
+    {
+        const __m128 upper = _mm_set1_ps(float_int_bounds<int32_t, float>::limit());
+        const __m128i nan = _mm_set1_epi32(nan_value);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 v = _mm_loadu_ps(in + i);
+            const __m128i r = _mm_xor_si128(_mm_cvttps_epi32(v), _mm_castps_si128(_mm_cmpge_ps(v, upper)));
+            const __m128i is_nan = _mm_castps_si128(_mm_cmpunord_ps(v, v));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                             _mm_or_si128(_mm_andnot_si128(is_nan, r), _mm_and_si128(is_nan, nan)));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    /// packssdw is the saturating conversion
+    NUMERIC_CAST_TARGET("sse2") inline void saturate_n(const int32_t* in, int16_t* out, size_t n, int16_t nan_value) noexcept
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(v0, v1));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    /// negative values are zeroed by their sign mask, then the biased signed pack
+    /// saturates values above 65535
+    NUMERIC_CAST_TARGET("sse2") inline void saturate_n(const int32_t* in, uint16_t* out, size_t n, uint16_t nan_value) noexcept
+    {
+        const __m128i bias = _mm_set1_epi32(32768);
+        const __m128i sign = _mm_set1_epi16(-32768);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 4));
+            v0 = _mm_andnot_si128(_mm_srai_epi32(v0, 31), v0);
+            v1 = _mm_andnot_si128(_mm_srai_epi32(v1, 31), v1);
+            const __m128i p = _mm_packs_epi32(_mm_sub_epi32(v0, bias), _mm_sub_epi32(v1, bias));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_xor_si128(p, sign));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    /// SSE2 has no roundpd: |v| < 2^52 is rounded to nearest even by adding and subtracting 2^52
+    /// in the default rounding mode, larger values and NaN are integral already.
+    /// floor, ceil and trunc correct the nearest value by one
+    NUMERIC_CAST_TARGET("sse2") inline __m128d round_pd(__m128d v, round_mode<0>) noexcept
+    {
+        const __m128d sign = _mm_set1_pd(-0.0);
+        const __m128d big = _mm_set1_pd(4503599627370496.0);
+        const __m128d a = _mm_andnot_pd(sign, v);
+        const __m128d small = _mm_cmplt_pd(a, big);
+        const __m128d r = _mm_or_pd(_mm_sub_pd(_mm_add_pd(a, big), big), _mm_and_pd(sign, v));
+        return _mm_or_pd(_mm_and_pd(small, r), _mm_andnot_pd(small, v));
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline __m128d round_pd(__m128d v, round_mode<1>) noexcept
+    {
+        const __m128d r = round_pd(v, round_mode<0>());
+        return _mm_sub_pd(r, _mm_and_pd(_mm_cmpgt_pd(r, v), _mm_set1_pd(1.0)));
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline __m128d round_pd(__m128d v, round_mode<2>) noexcept
+    {
+        const __m128d r = round_pd(v, round_mode<0>());
+        return _mm_add_pd(r, _mm_and_pd(_mm_cmplt_pd(r, v), _mm_set1_pd(1.0)));
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline __m128d round_pd(__m128d v, round_mode<3>) noexcept
+    {
+        const __m128d sign = _mm_set1_pd(-0.0);
+        return _mm_or_pd(round_pd(_mm_andnot_pd(sign, v), round_mode<1>()), _mm_and_pd(sign, v));
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline __m128d round_pd(__m128d v, round_mode<4>) noexcept
+    {
+        const __m128d below_half = _mm_or_pd(_mm_set1_pd(0.49999999999999994), _mm_and_pd(_mm_set1_pd(-0.0), v));
+        return round_pd(_mm_add_pd(v, below_half), round_mode<3>());
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline __m128 round_ps(__m128 v, round_mode<0>) noexcept
+    {
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        const __m128 big = _mm_set1_ps(8388608.0f);
+        const __m128 a = _mm_andnot_ps(sign, v);
+        const __m128 small = _mm_cmplt_ps(a, big);
+        const __m128 r = _mm_or_ps(_mm_sub_ps(_mm_add_ps(a, big), big), _mm_and_ps(sign, v));
+        return _mm_or_ps(_mm_and_ps(small, r), _mm_andnot_ps(small, v));
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline __m128 round_ps(__m128 v, round_mode<1>) noexcept
+    {
+        const __m128 r = round_ps(v, round_mode<0>());
+        return _mm_sub_ps(r, _mm_and_ps(_mm_cmpgt_ps(r, v), _mm_set1_ps(1.0f)));
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline __m128 round_ps(__m128 v, round_mode<2>) noexcept
+    {
+        const __m128 r = round_ps(v, round_mode<0>());
+        return _mm_add_ps(r, _mm_and_ps(_mm_cmplt_ps(r, v), _mm_set1_ps(1.0f)));
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline __m128 round_ps(__m128 v, round_mode<3>) noexcept
+    {
+        const __m128 sign = _mm_set1_ps(-0.0f);
+        return _mm_or_ps(round_ps(_mm_andnot_ps(sign, v), round_mode<1>()), _mm_and_ps(sign, v));
+    }
+
+    NUMERIC_CAST_TARGET("sse2") inline __m128 round_ps(__m128 v, round_mode<4>) noexcept
+    {
+        const __m128 below_half = _mm_or_ps(_mm_set1_ps(0.49999997f), _mm_and_ps(_mm_set1_ps(-0.0f), v));
+        return round_ps(_mm_add_ps(v, below_half), round_mode<3>());
+    }
+
+    /// round `n` elements by the rounding policy, the tail by the scalar policy
+    template <typename Round>
+    NUMERIC_CAST_TARGET("sse2") inline void round_n(const double* in, double* out, size_t n) noexcept
+    {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            _mm_storeu_pd(out + i, round_pd(_mm_loadu_pd(in + i), round_mode<Round::mode>()));
+        }
+        round_generic<Round>(in + i, out + i, n - i);
+    }
+
+    template <typename Round>
+    NUMERIC_CAST_TARGET("sse2") inline void round_n(const float* in, float* out, size_t n) noexcept
+    {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm_storeu_ps(out + i, round_ps(_mm_loadu_ps(in + i), round_mode<Round::mode>()));
+        }
+        round_generic<Round>(in + i, out + i, n - i);
+    }
+
+    /// mixed-sign 32-bit comparisons: the same signedness is a single compare, unsigned
+    /// `x < y` is a signed compare with the sign bits flipped, then a signed operand
+    /// is tested for negative by its sign bit, which decides the result
+    template <typename A, typename B>
+    NUMERIC_CAST_TARGET("sse2") inline __m128i compare_epi32(const __m128i x, const __m128i y, less_comparison) noexcept
+    {
+        if (std::is_signed<A>::value && std::is_signed<B>::value)
+            return _mm_cmpgt_epi32(y, x);
+        const __m128i bias = _mm_set1_epi32(INT32_MIN);
+        const __m128i below = _mm_cmpgt_epi32(_mm_xor_si128(y, bias), _mm_xor_si128(x, bias));
+        if (std::is_signed<A>::value)
+            return _mm_or_si128(below, _mm_srai_epi32(x, 31));
+        if (std::is_signed<B>::value)
+            return _mm_andnot_si128(_mm_srai_epi32(y, 31), below);
+        return below;
+    }
+
+    /// equal bits of mixed signs are not equal values if the sign bit is set
+    template <typename A, typename B>
+    NUMERIC_CAST_TARGET("sse2") inline __m128i compare_epi32(const __m128i x, const __m128i y, equal_comparison) noexcept
+    {
+        return std::is_signed<A>::value == std::is_signed<B>::value ? _mm_cmpeq_epi32(x, y)
+            : _mm_andnot_si128(_mm_srai_epi32(x, 31), _mm_cmpeq_epi32(x, y));
+    }
+
+    /// comparison bits of a full word, i.e. 64 pairs of 32-bit integers
+    template <typename Comparison, typename A, typename B>
+    NUMERIC_CAST_TARGET("sse2") inline uint64_t cmp_bits(const A* a, const B* b) noexcept
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 4)
+        {
+            const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k));
+            const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k));
+            const __m128i r = compare_epi32<A, B>(x, y, Comparison());
+            bits |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(r))) << k;
+        }
+        return bits;
+    }
+
+    }  // namespace simd_sse2
+#endif
+
+#if defined(__AVX2__) || NUMERIC_CAST_DISPATCH
+NUMERIC_CAST_SIMD_WARNINGS_PUSH
+    namespace simd_avx2 {
+
+    NUMERIC_CAST_TARGET("avx2") inline bool cast_n(const double* in, int32_t* out, size_t n) noexcept
+    {
+        const __m256d lo = _mm256_set1_pd(bulk_bounds<int32_t, double>::lo());
+        const __m256d hi = _mm256_set1_pd(bulk_bounds<int32_t, double>::hi());
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256d v0 = _mm256_loadu_pd(in + i);
+            const __m256d v1 = _mm256_loadu_pd(in + i + 4);
+            bad = _mm256_or_pd(bad, _mm256_or_pd(_mm256_cmp_pd(v0, lo, _CMP_NGE_UQ),
+                                                 _mm256_cmp_pd(v0, hi, _CMP_NLE_UQ)));
+            bad = _mm256_or_pd(bad, _mm256_or_pd(_mm256_cmp_pd(v1, lo, _CMP_NGE_UQ),
+                                                 _mm256_cmp_pd(v1, hi, _CMP_NLE_UQ)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvttpd_epi32(v0));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 4), _mm256_cvttpd_epi32(v1));
+        }
+        return (_mm256_movemask_pd(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline bool cast_n(const double* in, int16_t* out, size_t n) noexcept
+    {
+        const __m256d lo = _mm256_set1_pd(bulk_bounds<int16_t, double>::lo());
+        const __m256d hi = _mm256_set1_pd(bulk_bounds<int16_t, double>::hi());
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256d v0 = _mm256_loadu_pd(in + i);
+            const __m256d v1 = _mm256_loadu_pd(in + i + 4);
+            bad = _mm256_or_pd(bad, _mm256_or_pd(_mm256_cmp_pd(v0, lo, _CMP_NGE_UQ),
+                                                 _mm256_cmp_pd(v0, hi, _CMP_NLE_UQ)));
+            bad = _mm256_or_pd(bad, _mm256_or_pd(_mm256_cmp_pd(v1, lo, _CMP_NGE_UQ),
+                                                 _mm256_cmp_pd(v1, hi, _CMP_NLE_UQ)));
+            const __m128i p = _mm_packs_epi32(_mm256_cvttpd_epi32(v0), _mm256_cvttpd_epi32(v1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), p);
+        }
+        return (_mm256_movemask_pd(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline bool cast_n(const float* in, int32_t* out, size_t n) noexcept
+    {
+        const __m256 lo = _mm256_set1_ps(bulk_bounds<int32_t, float>::lo());
+        const __m256 hi = _mm256_set1_ps(bulk_bounds<int32_t, float>::hi());
+        __m256 bad = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256 v = _mm256_loadu_ps(in + i);
+            bad = _mm256_or_ps(bad, _mm256_or_ps(_mm256_cmp_ps(v, lo, _CMP_NGE_UQ),
+                                                 _mm256_cmp_ps(v, hi, _CMP_NLE_UQ)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_cvttps_epi32(v));
+        }
+        return (_mm256_movemask_ps(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline bool cast_n(const int32_t* in, int16_t* out, size_t n) noexcept
+    {
+        const __m256i lo = _mm256_set1_epi32(bulk_bounds<int16_t, int32_t>::lo());
+        const __m256i hi = _mm256_set1_epi32(bulk_bounds<int16_t, int32_t>::hi());
+        __m256i bad = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8));
+            bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi32(lo, v0),
+                                                       _mm256_cmpgt_epi32(v0, hi)));
+            bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi32(lo, v1),
+                                                       _mm256_cmpgt_epi32(v1, hi)));
+            // packssdw works within each 128 bit lane, restore the element order
+            const __m256i p = _mm256_permute4x64_epi64(_mm256_packs_epi32(v0, v1), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), p);
+        }
+        return _mm256_testz_si256(bad, bad) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline bool cast_n(const double* in, uint16_t* out, size_t n) noexcept
+    {
+        const __m256d lo = _mm256_set1_pd(bulk_bounds<uint16_t, double>::lo());
+        const __m256d hi = _mm256_set1_pd(bulk_bounds<uint16_t, double>::hi());
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256d v0 = _mm256_loadu_pd(in + i);
+            const __m256d v1 = _mm256_loadu_pd(in + i + 4);
+            bad = _mm256_or_pd(bad, _mm256_or_pd(_mm256_cmp_pd(v0, lo, _CMP_NGE_UQ),
+                                                 _mm256_cmp_pd(v0, hi, _CMP_NLE_UQ)));
+            bad = _mm256_or_pd(bad, _mm256_or_pd(_mm256_cmp_pd(v1, lo, _CMP_NGE_UQ),
+                                                 _mm256_cmp_pd(v1, hi, _CMP_NLE_UQ)));
+            const __m128i p = _mm_packus_epi32(_mm256_cvttpd_epi32(v0), _mm256_cvttpd_epi32(v1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), p);
+        }
+        return (_mm256_movemask_pd(bad) == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline bool cast_n(const int32_t* in, uint16_t* out, size_t n) noexcept
+    {
+        const __m256i lo = _mm256_set1_epi32(bulk_bounds<uint16_t, int32_t>::lo());
+        const __m256i hi = _mm256_set1_epi32(bulk_bounds<uint16_t, int32_t>::hi());
+        __m256i bad = _mm256_setzero_si256();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8));
+            bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi32(lo, v0),
+                                                       _mm256_cmpgt_epi32(v0, hi)));
+            bad = _mm256_or_si256(bad, _mm256_or_si256(_mm256_cmpgt_epi32(lo, v1),
+                                                       _mm256_cmpgt_epi32(v1, hi)));
+            const __m256i p = _mm256_permute4x64_epi64(_mm256_packus_epi32(v0, v1), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), p);
+        }
+        return _mm256_testz_si256(bad, bad) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline uint64_t in_range_bits(const double* in, double lo_, double hi_) noexcept
+    {
+        const __m256d lo = _mm256_set1_pd(lo_);
+        const __m256d hi = _mm256_set1_pd(hi_);
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 4)
+        {
+            const __m256d v = _mm256_loadu_pd(in + k);
+            const __m256d ok = _mm256_and_pd(_mm256_cmp_pd(v, lo, _CMP_GE_OQ),
+                                             _mm256_cmp_pd(v, hi, _CMP_LE_OQ));
+            bits |= static_cast<uint64_t>(_mm256_movemask_pd(ok)) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline uint64_t in_range_bits(const float* in, float lo_, float hi_) noexcept
+    {
+        const __m256 lo = _mm256_set1_ps(lo_);
+        const __m256 hi = _mm256_set1_ps(hi_);
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 8)
+        {
+            const __m256 v = _mm256_loadu_ps(in + k);
+            const __m256 ok = _mm256_and_ps(_mm256_cmp_ps(v, lo, _CMP_GE_OQ),
+                                            _mm256_cmp_ps(v, hi, _CMP_LE_OQ));
+            bits |= static_cast<uint64_t>(_mm256_movemask_ps(ok)) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline uint64_t in_range_bits(const int32_t* in, int32_t lo_, int32_t hi_) noexcept
+    {
+        const __m256i lo = _mm256_set1_epi32(lo_);
+        const __m256i hi = _mm256_set1_epi32(hi_);
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 8)
+        {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + k));
+            const __m256i bad = _mm256_or_si256(_mm256_cmpgt_epi32(lo, v), _mm256_cmpgt_epi32(v, hi));
+            bits |= static_cast<uint64_t>(~_mm256_movemask_ps(_mm256_castsi256_ps(bad)) & 0xFF) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline uint64_t nan_bits(const double* in) noexcept
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 4)
+        {
+            const __m256d v = _mm256_loadu_pd(in + k);
+            bits |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_cmp_pd(v, v, _CMP_UNORD_Q))) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline uint64_t nan_bits(const float* in) noexcept
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 8)
+        {
+            const __m256 v = _mm256_loadu_ps(in + k);
+            bits |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(v, v, _CMP_UNORD_Q))) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline __m256d saturate_pd(__m256d v, __m256d lo, __m256d hi, __m256d nan) noexcept
+    {
+        v = _mm256_blendv_pd(v, nan, _mm256_cmp_pd(v, v, _CMP_UNORD_Q));
+        return _mm256_min_pd(_mm256_max_pd(v, lo), hi);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline void saturate_n(const double* in, int32_t* out, size_t n, int32_t nan_value) noexcept
+    {
+        const __m256d lo = _mm256_set1_pd(bulk_bounds<int32_t, double>::lo());
+        const __m256d hi = _mm256_set1_pd(bulk_bounds<int32_t, double>::hi());
+        const __m256d nan = _mm256_set1_pd(static_cast<double>(nan_value));
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128i r = _mm256_cvttpd_epi32(saturate_pd(_mm256_loadu_pd(in + i), lo, hi, nan));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), r);
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline void saturate_n(const double* in, int16_t* out, size_t n, int16_t nan_value) noexcept
+    {
+        const __m256d lo = _mm256_set1_pd(bulk_bounds<int16_t, double>::lo());
+        const __m256d hi = _mm256_set1_pd(bulk_bounds<int16_t, double>::hi());
+        const __m256d nan = _mm256_set1_pd(static_cast<double>(nan_value));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m128i r0 = _mm256_cvttpd_epi32(saturate_pd(_mm256_loadu_pd(in + i), lo, hi, nan));
+            const __m128i r1 = _mm256_cvttpd_epi32(saturate_pd(_mm256_loadu_pd(in + i + 4), lo, hi, nan));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(r0, r1));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline void saturate_n(const double* in, uint16_t* out, size_t n, uint16_t nan_value) noexcept
+    {
+        const __m256d lo = _mm256_set1_pd(bulk_bounds<uint16_t, double>::lo());
+        const __m256d hi = _mm256_set1_pd(bulk_bounds<uint16_t, double>::hi());
+        const __m256d nan = _mm256_set1_pd(static_cast<double>(nan_value));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m128i r0 = _mm256_cvttpd_epi32(saturate_pd(_mm256_loadu_pd(in + i), lo, hi, nan));
+            const __m128i r1 = _mm256_cvttpd_epi32(saturate_pd(_mm256_loadu_pd(in + i + 4), lo, hi, nan));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi32(r0, r1));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline void saturate_n(const float* in, int32_t* out, size_t n, int32_t nan_value) noexcept
+    {
+        const __m256 upper = _mm256_set1_ps(float_int_bounds<int32_t, float>::limit());
+        const __m256 nan = _mm256_castsi256_ps(_mm256_set1_epi32(nan_value));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256 v = _mm256_loadu_ps(in + i);
+            const __m256 r = _mm256_xor_ps(_mm256_castsi256_ps(_mm256_cvttps_epi32(v)),
+                                           _mm256_cmp_ps(v, upper, _CMP_GE_OQ));
+            const __m256 s = _mm256_blendv_ps(r, nan, _mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_castps_si256(s));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline void saturate_n(const int32_t* in, int16_t* out, size_t n, int16_t nan_value) noexcept
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8));
+            const __m256i p = _mm256_permute4x64_epi64(_mm256_packs_epi32(v0, v1), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), p);
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline void saturate_n(const int32_t* in, uint16_t* out, size_t n, uint16_t nan_value) noexcept
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i + 8));
+            const __m256i p = _mm256_permute4x64_epi64(_mm256_packus_epi32(v0, v1), 0xD8);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), p);
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    /// vroundpd has the same rounding control as `Round::mode`, except ties away from zero
+    template <int Mode>
+    NUMERIC_CAST_TARGET("avx2") inline __m256d round_pd(__m256d v, round_mode<Mode>) noexcept
+    {
+        return _mm256_round_pd(v, Mode | _MM_FROUND_NO_EXC);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline __m256d round_pd(__m256d v, round_mode<4>) noexcept
+    {
+        const __m256d below_half = _mm256_or_pd(_mm256_set1_pd(0.49999999999999994),
+                                                _mm256_and_pd(_mm256_set1_pd(-0.0), v));
+        return _mm256_round_pd(_mm256_add_pd(v, below_half), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    }
+
+    template <int Mode>
+    NUMERIC_CAST_TARGET("avx2") inline __m256 round_ps(__m256 v, round_mode<Mode>) noexcept
+    {
+        return _mm256_round_ps(v, Mode | _MM_FROUND_NO_EXC);
+    }
+
+    NUMERIC_CAST_TARGET("avx2") inline __m256 round_ps(__m256 v, round_mode<4>) noexcept
+    {
+        const __m256 below_half = _mm256_or_ps(_mm256_set1_ps(0.49999997f),
+                                               _mm256_and_ps(_mm256_set1_ps(-0.0f), v));
+        return _mm256_round_ps(_mm256_add_ps(v, below_half), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    }
+
+    template <typename Round>
+    NUMERIC_CAST_TARGET("avx2") inline void round_n(const double* in, double* out, size_t n) noexcept
+    {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            _mm256_storeu_pd(out + i, round_pd(_mm256_loadu_pd(in + i), round_mode<Round::mode>()));
+        }
+        round_generic<Round>(in + i, out + i, n - i);
+    }
+
+    template <typename Round>
+    NUMERIC_CAST_TARGET("avx2") inline void round_n(const float* in, float* out, size_t n) noexcept
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm256_storeu_ps(out + i, round_ps(_mm256_loadu_ps(in + i), round_mode<Round::mode>()));
+        }
+        round_generic<Round>(in + i, out + i, n - i);
+    }
+
+    template <typename A, typename B>
+    NUMERIC_CAST_TARGET("avx2") inline __m256i compare_epi32(const __m256i x, const __m256i y, less_comparison) noexcept
+    {
+        if (std::is_signed<A>::value && std::is_signed<B>::value)
+            return _mm256_cmpgt_epi32(y, x);
+        const __m256i bias = _mm256_set1_epi32(INT32_MIN);
+        const __m256i below = _mm256_cmpgt_epi32(_mm256_xor_si256(y, bias), _mm256_xor_si256(x, bias));
+        if (std::is_signed<A>::value)
+            return _mm256_or_si256(below, _mm256_srai_epi32(x, 31));
+        if (std::is_signed<B>::value)
+            return _mm256_andnot_si256(_mm256_srai_epi32(y, 31), below);
+        return below;
+    }
+
+    template <typename A, typename B>
+    NUMERIC_CAST_TARGET("avx2") inline __m256i compare_epi32(const __m256i x, const __m256i y, equal_comparison) noexcept
+    {
+        return std::is_signed<A>::value == std::is_signed<B>::value ? _mm256_cmpeq_epi32(x, y)
+            : _mm256_andnot_si256(_mm256_srai_epi32(x, 31), _mm256_cmpeq_epi32(x, y));
+    }
+
+    template <typename Comparison, typename A, typename B>
+    NUMERIC_CAST_TARGET("avx2") inline uint64_t cmp_bits(const A* a, const B* b) noexcept
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 8)
+        {
+            const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+            const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + k));
+            const __m256i r = compare_epi32<A, B>(x, y, Comparison());
+            bits |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(r)))) << k;
+        }
+        return bits;
+    }
+
+    }  // namespace simd_avx2
+NUMERIC_CAST_SIMD_WARNINGS_POP
+#endif
+
+#if defined(__AVX512F__) || NUMERIC_CAST_DISPATCH
+NUMERIC_CAST_SIMD_WARNINGS_PUSH
+    namespace simd_avx512 {
+
+    NUMERIC_CAST_TARGET("avx512f") inline bool cast_n(const double* in, int32_t* out, size_t n) noexcept
+    {
+        const __m512d lo = _mm512_set1_pd(bulk_bounds<int32_t, double>::lo());
+        const __m512d hi = _mm512_set1_pd(bulk_bounds<int32_t, double>::hi());
+        __mmask8 bad = 0;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d v = _mm512_loadu_pd(in + i);
+            bad |= _mm512_cmp_pd_mask(v, lo, _CMP_NGE_UQ) | _mm512_cmp_pd_mask(v, hi, _CMP_NLE_UQ);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvttpd_epi32(v));
+        }
+        return (bad == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline bool cast_n(const double* in, int16_t* out, size_t n) noexcept
+    {
+        const __m512d lo = _mm512_set1_pd(bulk_bounds<int16_t, double>::lo());
+        const __m512d hi = _mm512_set1_pd(bulk_bounds<int16_t, double>::hi());
+        __mmask8 bad = 0;
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512d v0 = _mm512_loadu_pd(in + i);
+            const __m512d v1 = _mm512_loadu_pd(in + i + 8);
+            bad |= _mm512_cmp_pd_mask(v0, lo, _CMP_NGE_UQ) | _mm512_cmp_pd_mask(v0, hi, _CMP_NLE_UQ);
+            bad |= _mm512_cmp_pd_mask(v1, lo, _CMP_NGE_UQ) | _mm512_cmp_pd_mask(v1, hi, _CMP_NLE_UQ);
+            const __m512i r = _mm512_inserti64x4(
+                _mm512_castsi256_si512(_mm512_cvttpd_epi32(v0)), _mm512_cvttpd_epi32(v1), 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtsepi32_epi16(r));
+        }
+        return (bad == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline bool cast_n(const float* in, int32_t* out, size_t n) noexcept
+    {
+        const __m512 lo = _mm512_set1_ps(bulk_bounds<int32_t, float>::lo());
+        const __m512 hi = _mm512_set1_ps(bulk_bounds<int32_t, float>::hi());
+        __mmask16 bad = 0;
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512 v = _mm512_loadu_ps(in + i);
+            bad |= _mm512_cmp_ps_mask(v, lo, _CMP_NGE_UQ) | _mm512_cmp_ps_mask(v, hi, _CMP_NLE_UQ);
+            _mm512_storeu_si512(out + i, _mm512_cvttps_epi32(v));
+        }
+        return (bad == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline bool cast_n(const int32_t* in, int16_t* out, size_t n) noexcept
+    {
+        const __m512i lo = _mm512_set1_epi32(bulk_bounds<int16_t, int32_t>::lo());
+        const __m512i hi = _mm512_set1_epi32(bulk_bounds<int16_t, int32_t>::hi());
+        __mmask16 bad = 0;
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512i v = _mm512_loadu_si512(in + i);
+            bad |= _mm512_cmp_epi32_mask(v, lo, _MM_CMPINT_LT) | _mm512_cmp_epi32_mask(v, hi, _MM_CMPINT_NLE);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtepi32_epi16(v));
+        }
+        return (bad == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline bool cast_n(const double* in, uint16_t* out, size_t n) noexcept
+    {
+        const __m512d lo = _mm512_set1_pd(bulk_bounds<uint16_t, double>::lo());
+        const __m512d hi = _mm512_set1_pd(bulk_bounds<uint16_t, double>::hi());
+        __mmask8 bad = 0;
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512d v0 = _mm512_loadu_pd(in + i);
+            const __m512d v1 = _mm512_loadu_pd(in + i + 8);
+            bad |= _mm512_cmp_pd_mask(v0, lo, _CMP_NGE_UQ) | _mm512_cmp_pd_mask(v0, hi, _CMP_NLE_UQ);
+            bad |= _mm512_cmp_pd_mask(v1, lo, _CMP_NGE_UQ) | _mm512_cmp_pd_mask(v1, hi, _CMP_NLE_UQ);
+            const __m512i r = _mm512_inserti64x4(
+                _mm512_castsi256_si512(_mm512_cvttpd_epi32(v0)), _mm512_cvttpd_epi32(v1), 1);
+            // in-range values fit in 16 bits, the truncating vpmovdw is enough
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtepi32_epi16(r));
+        }
+        return (bad == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline bool cast_n(const int32_t* in, uint16_t* out, size_t n) noexcept
+    {
+        const __m512i lo = _mm512_set1_epi32(bulk_bounds<uint16_t, int32_t>::lo());
+        const __m512i hi = _mm512_set1_epi32(bulk_bounds<uint16_t, int32_t>::hi());
+        __mmask16 bad = 0;
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512i v = _mm512_loadu_si512(in + i);
+            bad |= _mm512_cmp_epi32_mask(v, lo, _MM_CMPINT_LT) | _mm512_cmp_epi32_mask(v, hi, _MM_CMPINT_NLE);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtepi32_epi16(v));
+        }
+        return (bad == 0) & bulk_cast_generic(in + i, out + i, n - i);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline uint64_t in_range_bits(const double* in, double lo_, double hi_) noexcept
+    {
+        const __m512d lo = _mm512_set1_pd(lo_);
+        const __m512d hi = _mm512_set1_pd(hi_);
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 8)
+        {
+            const __m512d v = _mm512_loadu_pd(in + k);
+            const __mmask8 ok = _mm512_cmp_pd_mask(v, lo, _CMP_GE_OQ) & _mm512_cmp_pd_mask(v, hi, _CMP_LE_OQ);
+            bits |= static_cast<uint64_t>(ok) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline uint64_t in_range_bits(const float* in, float lo_, float hi_) noexcept
+    {
+        const __m512 lo = _mm512_set1_ps(lo_);
+        const __m512 hi = _mm512_set1_ps(hi_);
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 16)
+        {
+            const __m512 v = _mm512_loadu_ps(in + k);
+            const __mmask16 ok = _mm512_cmp_ps_mask(v, lo, _CMP_GE_OQ) & _mm512_cmp_ps_mask(v, hi, _CMP_LE_OQ);
+            bits |= static_cast<uint64_t>(ok) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline uint64_t in_range_bits(const int32_t* in, int32_t lo_, int32_t hi_) noexcept
+    {
+        const __m512i lo = _mm512_set1_epi32(lo_);
+        const __m512i hi = _mm512_set1_epi32(hi_);
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 16)
+        {
+            const __m512i v = _mm512_loadu_si512(in + k);
+            const __mmask16 ok = _mm512_cmp_epi32_mask(v, lo, _MM_CMPINT_NLT) & _mm512_cmp_epi32_mask(v, hi, _MM_CMPINT_LE);
+            bits |= static_cast<uint64_t>(ok) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline uint64_t nan_bits(const double* in) noexcept
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 8)
+        {
+            const __m512d v = _mm512_loadu_pd(in + k);
+            bits |= static_cast<uint64_t>(_mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q)) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline uint64_t nan_bits(const float* in) noexcept
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 16)
+        {
+            const __m512 v = _mm512_loadu_ps(in + k);
+            bits |= static_cast<uint64_t>(_mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q)) << k;
+        }
+        return bits;
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline __m512d saturate_pd(__m512d v, __m512d lo, __m512d hi, __m512d nan) noexcept
+    {
+        v = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(v, v, _CMP_UNORD_Q), v, nan);
+        return _mm512_min_pd(_mm512_max_pd(v, lo), hi);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline void saturate_n(const double* in, int32_t* out, size_t n, int32_t nan_value) noexcept
+    {
+        const __m512d lo = _mm512_set1_pd(bulk_bounds<int32_t, double>::lo());
+        const __m512d hi = _mm512_set1_pd(bulk_bounds<int32_t, double>::hi());
+        const __m512d nan = _mm512_set1_pd(static_cast<double>(nan_value));
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256i r = _mm512_cvttpd_epi32(saturate_pd(_mm512_loadu_pd(in + i), lo, hi, nan));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), r);
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline void saturate_n(const double* in, int16_t* out, size_t n, int16_t nan_value) noexcept
+    {
+        const __m512d lo = _mm512_set1_pd(bulk_bounds<int16_t, double>::lo());
+        const __m512d hi = _mm512_set1_pd(bulk_bounds<int16_t, double>::hi());
+        const __m512d nan = _mm512_set1_pd(static_cast<double>(nan_value));
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m256i r0 = _mm512_cvttpd_epi32(saturate_pd(_mm512_loadu_pd(in + i), lo, hi, nan));
+            const __m256i r1 = _mm512_cvttpd_epi32(saturate_pd(_mm512_loadu_pd(in + i + 8), lo, hi, nan));
+            const __m512i r = _mm512_inserti64x4(_mm512_castsi256_si512(r0), r1, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtsepi32_epi16(r));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline void saturate_n(const double* in, uint16_t* out, size_t n, uint16_t nan_value) noexcept
+    {
+        const __m512d lo = _mm512_set1_pd(bulk_bounds<uint16_t, double>::lo());
+        const __m512d hi = _mm512_set1_pd(bulk_bounds<uint16_t, double>::hi());
+        const __m512d nan = _mm512_set1_pd(static_cast<double>(nan_value));
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m256i r0 = _mm512_cvttpd_epi32(saturate_pd(_mm512_loadu_pd(in + i), lo, hi, nan));
+            const __m256i r1 = _mm512_cvttpd_epi32(saturate_pd(_mm512_loadu_pd(in + i + 8), lo, hi, nan));
+            const __m512i r = _mm512_inserti64x4(_mm512_castsi256_si512(r0), r1, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtepi32_epi16(r));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline void saturate_n(const float* in, int32_t* out, size_t n, int32_t nan_value) noexcept
+    {
+        const __m512 upper = _mm512_set1_ps(float_int_bounds<int32_t, float>::limit());
+        const __m512i max = _mm512_set1_epi32(std::numeric_limits<int32_t>::max());
+        const __m512i nan = _mm512_set1_epi32(nan_value);
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512 v = _mm512_loadu_ps(in + i);
+            __m512i r = _mm512_cvttps_epi32(v);
+            r = _mm512_mask_mov_epi32(r, _mm512_cmp_ps_mask(v, upper, _CMP_GE_OQ), max);
+            r = _mm512_mask_mov_epi32(r, _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q), nan);
+            _mm512_storeu_si512(out + i, r);
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    /// vpmovsdw is the saturating conversion
+    NUMERIC_CAST_TARGET("avx512f") inline void saturate_n(const int32_t* in, int16_t* out, size_t n, int16_t nan_value) noexcept
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512i v = _mm512_loadu_si512(in + i);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtsepi32_epi16(v));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    /// vpmovusdw takes the source as unsigned, negative values are zeroed first
+    NUMERIC_CAST_TARGET("avx512f") inline void saturate_n(const int32_t* in, uint16_t* out, size_t n, uint16_t nan_value) noexcept
+    {
+        const __m512i zero = _mm512_setzero_si512();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512i v = _mm512_max_epi32(_mm512_loadu_si512(in + i), zero);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm512_cvtusepi32_epi16(v));
+        }
+        saturate_generic(in + i, out + i, n - i, nan_value);
+    }
+
+    /// vrndscalepd with zero scale is vroundpd
+    template <int Mode>
+    NUMERIC_CAST_TARGET("avx512f") inline __m512d round_pd(__m512d v, round_mode<Mode>) noexcept
+    {
+        return _mm512_roundscale_pd(v, Mode | _MM_FROUND_NO_EXC);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline __m512d round_pd(__m512d v, round_mode<4>) noexcept
+    {
+        const __m512i below_half = _mm512_set1_epi64(0x3FDFFFFFFFFFFFFF);  // 0.49999999999999994
+        const __m512i sign = _mm512_and_epi64(_mm512_castpd_si512(v), _mm512_set1_epi64(INT64_MIN));
+        const __m512d signed_half = _mm512_castsi512_pd(_mm512_or_epi64(below_half, sign));
+        return _mm512_roundscale_pd(_mm512_add_pd(v, signed_half), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    }
+
+    template <int Mode>
+    NUMERIC_CAST_TARGET("avx512f") inline __m512 round_ps(__m512 v, round_mode<Mode>) noexcept
+    {
+        return _mm512_roundscale_ps(v, Mode | _MM_FROUND_NO_EXC);
+    }
+
+    NUMERIC_CAST_TARGET("avx512f") inline __m512 round_ps(__m512 v, round_mode<4>) noexcept
+    {
+        const __m512i below_half = _mm512_set1_epi32(0x3EFFFFFF);  // 0.49999997f
+        const __m512i sign = _mm512_and_epi32(_mm512_castps_si512(v), _mm512_set1_epi32(INT32_MIN));
+        const __m512 signed_half = _mm512_castsi512_ps(_mm512_or_epi32(below_half, sign));
+        return _mm512_roundscale_ps(_mm512_add_ps(v, signed_half), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    }
+
+    template <typename Round>
+    NUMERIC_CAST_TARGET("avx512f") inline void round_n(const double* in, double* out, size_t n) noexcept
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            _mm512_storeu_pd(out + i, round_pd(_mm512_loadu_pd(in + i), round_mode<Round::mode>()));
+        }
+        round_generic<Round>(in + i, out + i, n - i);
+    }
+
+    template <typename Round>
+    NUMERIC_CAST_TARGET("avx512f") inline void round_n(const float* in, float* out, size_t n) noexcept
+    {
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            _mm512_storeu_ps(out + i, round_ps(_mm512_loadu_ps(in + i), round_mode<Round::mode>()));
+        }
+        round_generic<Round>(in + i, out + i, n - i);
+    }
+
+    /// AVX-512 has unsigned compares, a signed operand is tested by a masked compare
+    template <typename A, typename B>
+    NUMERIC_CAST_TARGET("avx512f") inline __mmask16 compare_epi32(const __m512i x, const __m512i y, less_comparison) noexcept
+    {
+        const __m512i zero = _mm512_setzero_si512();
+        if (std::is_signed<A>::value && std::is_signed<B>::value)
+            return _mm512_cmplt_epi32_mask(x, y);
+        if (std::is_signed<A>::value)
+            return static_cast<__mmask16>(_mm512_cmplt_epi32_mask(x, zero) | _mm512_cmplt_epu32_mask(x, y));
+        if (std::is_signed<B>::value)
+            return _mm512_mask_cmplt_epu32_mask(_mm512_cmpge_epi32_mask(y, zero), x, y);
+        return _mm512_cmplt_epu32_mask(x, y);
+    }
+
+    template <typename A, typename B>
+    NUMERIC_CAST_TARGET("avx512f") inline __mmask16 compare_epi32(const __m512i x, const __m512i y, equal_comparison) noexcept
+    {
+        return std::is_signed<A>::value == std::is_signed<B>::value ? _mm512_cmpeq_epi32_mask(x, y)
+            : _mm512_mask_cmpeq_epi32_mask(_mm512_cmpge_epi32_mask(x, _mm512_setzero_si512()), x, y);
+    }
+
+    template <typename Comparison, typename A, typename B>
+    NUMERIC_CAST_TARGET("avx512f") inline uint64_t cmp_bits(const A* a, const B* b) noexcept
+    {
+        uint64_t bits = 0;
+        for (int k = 0; k < 64; k += 16)
+        {
+            const __m512i x = _mm512_loadu_si512(a + k);
+            const __m512i y = _mm512_loadu_si512(b + k);
+            bits |= static_cast<uint64_t>(compare_epi32<A, B>(x, y, Comparison())) << k;
+        }
+        return bits;
+    }
+
+    }  // namespace simd_avx512
+NUMERIC_CAST_SIMD_WARNINGS_POP
+#endif
+
+    /// type pairs without a SIMD kernel use the portable loop
+    template <typename T, typename S>
+    struct bulk_kernel
+    {
+        static bool cast_n(const S* in, T* out, size_t n) noexcept
+        {
+            return bulk_cast_generic<T, S>(in, out, n);
+        }
+
+        /// convertible bits of a full word, i.e. 64 elements
+        static uint64_t convertible_bits(const S* in) noexcept
+        {
+            return convertible_bits_generic<T, S>(in, 64);
+        }
+
+        static void saturate_n(const S* in, T* out, size_t n, const T nan_value)
+        {
+            saturate_generic<T, S>(in, out, n, nan_value);
+        }
+    };
+
+    /// instruction set levels of the SIMD kernels
+    enum class simd_level { none, sse2, avx2, avx512 };
+
+#if NUMERIC_CAST_DISPATCH
+    inline simd_level detect_simd_level() noexcept
+    {
+        // may run before the constructors of libgcc, during static initialization
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return simd_level::avx512;
+        if (__builtin_cpu_supports("avx2"))
+            return simd_level::avx2;
+        if (__builtin_cpu_supports("sse2"))
+            return simd_level::sse2;
+        return simd_level::none;
+    }
+#else
+    inline simd_level detect_simd_level() noexcept
+    {
+#if defined(__AVX512F__)
+        return simd_level::avx512;
+#elif defined(__AVX2__)
+        return simd_level::avx2;
+#elif NUMERIC_CAST_HAS_SSE2
+        return simd_level::sse2;
+#else
+        return simd_level::none;
+#endif
+    }
+#endif
+
+    /// the best instruction set of this CPU, detected once
+    inline simd_level cpu_simd_level() noexcept
+    {
+        static const simd_level level = detect_simd_level();
+        return level;
+    }
+
+#if !NUMERIC_CAST_DISPATCH
+#if defined(__AVX512F__)
+    namespace simd_native = simd_avx512;
+#elif defined(__AVX2__)
+    namespace simd_native = simd_avx2;
+#elif NUMERIC_CAST_HAS_SSE2
+    namespace simd_native = simd_sse2;
+#endif
+#endif
+
+    /// type pairs with SIMD kernels
+    template <typename T, typename S>
+    struct bulk_simd_kernel
+    {
+#if NUMERIC_CAST_DISPATCH
+        typedef bool (*cast_fn)(const S*, T*, size_t);
+        typedef uint64_t (*bits_fn)(const S*, S, S);
+        typedef void (*saturate_fn)(const S*, T*, size_t, T);
+
+        /// the kernels of the best instruction set this CPU supports
+        static cast_fn select_cast() noexcept
+        {
+            switch (cpu_simd_level())
+            {
+            case simd_level::avx512: return simd_avx512::cast_n;
+            case simd_level::avx2: return simd_avx2::cast_n;
+            case simd_level::sse2: return simd_sse2::cast_n;
+            default: return bulk_cast_generic<T, S>;
+            }
+        }
+
+        static bits_fn select_bits() noexcept
+        {
+            switch (cpu_simd_level())
+            {
+            case simd_level::avx512: return simd_avx512::in_range_bits;
+            case simd_level::avx2: return simd_avx2::in_range_bits;
+            case simd_level::sse2: return simd_sse2::in_range_bits;
+            default: return generic_bits;
+            }
+        }
+
+        static saturate_fn select_saturate() noexcept
+        {
+            switch (cpu_simd_level())
+            {
+            case simd_level::avx512: return simd_avx512::saturate_n;
+            case simd_level::avx2: return simd_avx2::saturate_n;
+            case simd_level::sse2: return simd_sse2::saturate_n;
+            default: return saturate_generic<T, S>;
+            }
+        }
+
+        static uint64_t generic_bits(const S* in, S, S) noexcept
+        {
+            return convertible_bits_generic<T, S>(in, 64);
+        }
+
+        /// the pointers start at the resolvers, which select the kernel and
+        /// replace the pointer, so that later calls jump to the kernel directly
+        static std::atomic<cast_fn> cast_ptr;
+        static std::atomic<bits_fn> bits_ptr;
+        static std::atomic<saturate_fn> saturate_ptr;
+
+        static bool resolve_cast(const S* in, T* out, size_t n) noexcept
+        {
+            const cast_fn f = select_cast();
+            cast_ptr.store(f, std::memory_order_relaxed);
+            return f(in, out, n);
+        }
+
+        static uint64_t resolve_bits(const S* in, S lo, S hi) noexcept
+        {
+            const bits_fn f = select_bits();
+            bits_ptr.store(f, std::memory_order_relaxed);
+            return f(in, lo, hi);
+        }
+
+        static void resolve_saturate(const S* in, T* out, size_t n, T nan_value)
+        {
+            const saturate_fn f = select_saturate();
+            saturate_ptr.store(f, std::memory_order_relaxed);
+            f(in, out, n, nan_value);
+        }
+
+        static bool cast_n(const S* in, T* out, size_t n) noexcept
+        {
+            return cast_ptr.load(std::memory_order_relaxed)(in, out, n);
+        }
+
+        static uint64_t convertible_bits(const S* in) noexcept
+        {
+            return bits_ptr.load(std::memory_order_relaxed)(
+                in, bulk_bounds<T, S>::lo(), bulk_bounds<T, S>::hi());
+        }
+
+        static void saturate_n(const S* in, T* out, size_t n, const T nan_value)
+        {
+            saturate_ptr.load(std::memory_order_relaxed)(in, out, n, nan_value);
+        }
+#elif NUMERIC_CAST_HAS_SSE2
+        static bool cast_n(const S* in, T* out, size_t n) noexcept
+        {
+            return simd_native::cast_n(in, out, n);
+        }
+
+        static uint64_t convertible_bits(const S* in) noexcept
+        {
+            return simd_native::in_range_bits(in, bulk_bounds<T, S>::lo(), bulk_bounds<T, S>::hi());
+        }
+
+        static void saturate_n(const S* in, T* out, size_t n, const T nan_value)
+        {
+            simd_native::saturate_n(in, out, n, nan_value);
+        }
+#else
+        static bool cast_n(const S* in, T* out, size_t n) noexcept
+        {
+            return bulk_cast_generic<T, S>(in, out, n);
+        }
+
+        static uint64_t convertible_bits(const S* in) noexcept
+        {
+            return convertible_bits_generic<T, S>(in, 64);
+        }
+
+        static void saturate_n(const S* in, T* out, size_t n, const T nan_value)
+        {
+            saturate_generic<T, S>(in, out, n, nan_value);
+        }
+#endif
+    };
+
+#if NUMERIC_CAST_DISPATCH
+    // constant initialized, no static initialization order issue
+    template <typename T, typename S>
+    std::atomic<typename bulk_simd_kernel<T, S>::cast_fn>
+        bulk_simd_kernel<T, S>::cast_ptr(&bulk_simd_kernel<T, S>::resolve_cast);
+
+    template <typename T, typename S>
+    std::atomic<typename bulk_simd_kernel<T, S>::bits_fn>
+        bulk_simd_kernel<T, S>::bits_ptr(&bulk_simd_kernel<T, S>::resolve_bits);
+
+    template <typename T, typename S>
+    std::atomic<typename bulk_simd_kernel<T, S>::saturate_fn>
+        bulk_simd_kernel<T, S>::saturate_ptr(&bulk_simd_kernel<T, S>::resolve_saturate);
+#endif
+
+    /// rounding kernels of floating point types, selected in the same way as bulk_simd_kernel
+    template <typename S, typename Round>
+    struct bulk_simd_round_kernel
+    {
+#if NUMERIC_CAST_DISPATCH
+        typedef void (*round_fn)(const S*, S*, size_t);
+
+        static round_fn select_round() noexcept
+        {
+            switch (cpu_simd_level())
+            {
+            case simd_level::avx512: return simd_avx512::round_n<Round>;
+            case simd_level::avx2: return simd_avx2::round_n<Round>;
+            case simd_level::sse2: return simd_sse2::round_n<Round>;
+            default: return round_generic<Round, S>;
+            }
+        }
+
+        static std::atomic<round_fn> round_ptr;
+
+        static void resolve_round(const S* in, S* out, size_t n)
+        {
+            const round_fn f = select_round();
+            round_ptr.store(f, std::memory_order_relaxed);
+            f(in, out, n);
+        }
+
+        static void round_n(const S* in, S* out, size_t n)
+        {
+            round_ptr.load(std::memory_order_relaxed)(in, out, n);
+        }
+#elif NUMERIC_CAST_HAS_SSE2
+        static void round_n(const S* in, S* out, size_t n)
+        {
+            simd_native::round_n<Round>(in, out, n);
+        }
+#else
+        static void round_n(const S* in, S* out, size_t n)
+        {
+            round_generic<Round, S>(in, out, n);
+        }
+#endif
+    };
+
+#if NUMERIC_CAST_DISPATCH
+    template <typename S, typename Round>
+    std::atomic<typename bulk_simd_round_kernel<S, Round>::round_fn>
+        bulk_simd_round_kernel<S, Round>::round_ptr(&bulk_simd_round_kernel<S, Round>::resolve_round);
+#endif
+
+    /// other source types, e.g. half, and policies without a SIMD rounding mode
+    /// such as round_policy::exact, are rounded by the scalar policy
+    template <typename S, typename Round, typename = void>
+    struct bulk_round_kernel
+    {
+        static void round_n(const S* in, S* out, size_t n)
+        {
+            round_generic<Round, S>(in, out, n);
+        }
+    };
+
+    template <typename Round>
+    struct bulk_round_kernel<double, Round, typename std::enable_if<(Round::mode >= 0)>::type>
+        : bulk_simd_round_kernel<double, Round> {};
+
+    template <typename Round>
+    struct bulk_round_kernel<float, Round, typename std::enable_if<(Round::mode >= 0)>::type>
+        : bulk_simd_round_kernel<float, Round> {};
+
+    /// NaN test of floating point types, selected in the same way as bulk_simd_kernel
+    template <typename S>
+    struct bulk_simd_nan_kernel
+    {
+#if NUMERIC_CAST_DISPATCH
+        typedef uint64_t (*nan_bits_fn)(const S*);
+
+        static nan_bits_fn select_nan_bits() noexcept
+        {
+            switch (cpu_simd_level())
+            {
+            case simd_level::avx512: return simd_avx512::nan_bits;
+            case simd_level::avx2: return simd_avx2::nan_bits;
+            case simd_level::sse2: return simd_sse2::nan_bits;
+            default: return generic_nan_bits;
+            }
+        }
+
+        static uint64_t generic_nan_bits(const S* in) noexcept
+        {
+            return nan_bits_generic<S>(in, 64);
+        }
+
+        static std::atomic<nan_bits_fn> nan_bits_ptr;
+
+        static uint64_t resolve_nan_bits(const S* in) noexcept
+        {
+            const nan_bits_fn f = select_nan_bits();
+            nan_bits_ptr.store(f, std::memory_order_relaxed);
+            return f(in);
+        }
+
+        /// NaN bits of a full word, i.e. 64 elements
+        static uint64_t nan_bits(const S* in) noexcept
+        {
+            return nan_bits_ptr.load(std::memory_order_relaxed)(in);
+        }
+#elif NUMERIC_CAST_HAS_SSE2
+        static uint64_t nan_bits(const S* in) noexcept
+        {
+            return simd_native::nan_bits(in);
+        }
+#else
+        static uint64_t nan_bits(const S* in) noexcept
+        {
+            return nan_bits_generic<S>(in, 64);
+        }
+#endif
+    };
+
+#if NUMERIC_CAST_DISPATCH
+    template <typename S>
+    std::atomic<typename bulk_simd_nan_kernel<S>::nan_bits_fn>
+        bulk_simd_nan_kernel<S>::nan_bits_ptr(&bulk_simd_nan_kernel<S>::resolve_nan_bits);
+#endif
+
+    /// other source types, e.g. integer and half, by the scalar `is_nan()`
+    template <typename S>
+    struct bulk_nan_kernel
+    {
+        static uint64_t nan_bits(const S* in) noexcept
+        {
+            return nan_bits_generic<S>(in, 64);
+        }
+    };
+
+    /// comparison of 32-bit integers, selected in the same way as bulk_simd_kernel
+    template <typename Comparison, typename A, typename B>
+    struct bulk_simd_cmp_kernel
+    {
+#if NUMERIC_CAST_DISPATCH
+        typedef uint64_t (*cmp_bits_fn)(const A*, const B*);
+
+        static cmp_bits_fn select_cmp_bits() noexcept
+        {
+            switch (cpu_simd_level())
+            {
+            case simd_level::avx512: return simd_avx512::cmp_bits<Comparison, A, B>;
+            case simd_level::avx2: return simd_avx2::cmp_bits<Comparison, A, B>;
+            case simd_level::sse2: return simd_sse2::cmp_bits<Comparison, A, B>;
+            default: return generic_cmp_bits;
+            }
+        }
+
+        static uint64_t generic_cmp_bits(const A* a, const B* b) noexcept
+        {
+            return cmp_bits_generic<Comparison, A, B>(a, b, 64);
+        }
+
+        static std::atomic<cmp_bits_fn> cmp_bits_ptr;
+
+        static uint64_t resolve_cmp_bits(const A* a, const B* b) noexcept
+        {
+            const cmp_bits_fn f = select_cmp_bits();
+            cmp_bits_ptr.store(f, std::memory_order_relaxed);
+            return f(a, b);
+        }
+
+        /// comparison bits of a full word, i.e. 64 pairs
+        static uint64_t cmp_bits(const A* a, const B* b) noexcept
+        {
+            return cmp_bits_ptr.load(std::memory_order_relaxed)(a, b);
+        }
+#elif NUMERIC_CAST_HAS_SSE2
+        static uint64_t cmp_bits(const A* a, const B* b) noexcept
+        {
+            return simd_native::cmp_bits<Comparison, A, B>(a, b);
+        }
+#else
+        static uint64_t cmp_bits(const A* a, const B* b) noexcept
+        {
+            return cmp_bits_generic<Comparison, A, B>(a, b, 64);
+        }
+#endif
+    };
+
+#if NUMERIC_CAST_DISPATCH
+    template <typename Comparison, typename A, typename B>
+    std::atomic<typename bulk_simd_cmp_kernel<Comparison, A, B>::cmp_bits_fn>
+        bulk_simd_cmp_kernel<Comparison, A, B>::cmp_bits_ptr(&bulk_simd_cmp_kernel<Comparison, A, B>::resolve_cmp_bits);
+#endif
+
+    /// other integer types, by the scalar `cmp_less()` and `cmp_equal()`
+    template <typename Comparison, typename A, typename B, typename = void>
+    struct bulk_cmp_kernel
+    {
+        static uint64_t cmp_bits(const A* a, const B* b) noexcept
+        {
+            return cmp_bits_generic<Comparison, A, B>(a, b, 64);
+        }
+    };
+
+    template <typename Comparison, typename A, typename B>
+    struct bulk_cmp_kernel<Comparison, A, B, typename std::enable_if<std::is_integral<A>::value
+        && std::is_integral<B>::value && sizeof(A) == 4 && sizeof(B) == 4>::type>
+        : bulk_simd_cmp_kernel<Comparison, A, B> {};
+
+    /// the bits of `Comparison` of each pair, inverted if Negate, e.g. `cmp_greater_equal_n()`
+    /// is `!cmp_less()`, into `mask` if it is not `nullptr`. Returns the number of set bits
+    template <typename Comparison, bool Negate, typename A, typename B>
+    size_t cmp_n(const A* a, const B* b, size_t n, uint64_t* mask) noexcept
+    {
+        const uint64_t invert = Negate ? ~uint64_t(0) : uint64_t(0);
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64)
+        {
+            const uint64_t bits = bulk_cmp_kernel<Comparison, A, B>::cmp_bits(a + i, b + i) ^ invert;
+            count += popcount64(bits);
+            if (mask)
+                mask[i / 64] = bits;
+        }
+        if (i < n)
+        {
+            const uint64_t valid = ~uint64_t(0) >> (64 - (n - i));
+            const uint64_t bits = (cmp_bits_generic<Comparison, A, B>(a + i, b + i, n - i) ^ invert) & valid;
+            count += popcount64(bits);
+            if (mask)
+                mask[i / 64] = bits;
+        }
+        return count;
+    }
+
+    template <> struct bulk_nan_kernel<double> : bulk_simd_nan_kernel<double> {};
+    template <> struct bulk_nan_kernel<float> : bulk_simd_nan_kernel<float> {};
+
+    template <> struct bulk_kernel<int32_t, double> : bulk_simd_kernel<int32_t, double> {};
+    template <> struct bulk_kernel<int16_t, double> : bulk_simd_kernel<int16_t, double> {};
+    template <> struct bulk_kernel<uint16_t, double> : bulk_simd_kernel<uint16_t, double> {};
+    template <> struct bulk_kernel<int32_t, float> : bulk_simd_kernel<int32_t, float> {};
+    template <> struct bulk_kernel<int16_t, int32_t> : bulk_simd_kernel<int16_t, int32_t> {};
+    template <> struct bulk_kernel<uint16_t, int32_t> : bulk_simd_kernel<uint16_t, int32_t> {};
+}
+
+    /// convert `n` elements from `in` into `out`, usage `numeric_cast_n<int32_t>(in, out, n);`
+    /// it has the same result and exception as `numeric_cast<T>()` on each element,
+    /// if an exception is thrown, elements before the offending one have been converted,
+    /// the rest of `out` is unspecified. Returns `out + n` as `std::copy_n()`
+    template <typename T, typename S,
+        typename std::enable_if<std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value, int>::type = 0>
+    T* numeric_cast_n(const S* in, T* out, size_t n)
+    {
+        for (size_t i = 0; i < n; i += detail::bulk_block_size)
+        {
+            const size_t m = n - i < detail::bulk_block_size ? n - i : detail::bulk_block_size;
+            if (!detail::bulk_kernel<T, S>::cast_n(in + i, out + i, m))
+            {
+                // slow path, only for the block with out-of-range value
+                for (size_t j = i; j < i + m; j++)
+                {
+                    out[j] = detail::numeric_cast<T, S>(in[j]);
+                }
+            }
+        }
+        return out + n;
+    }
+
+    /// convert with a rounding policy, usage `numeric_cast_n<int32_t, round_policy::nearest_even>(in, out, n);`
+    /// each block is rounded by SIMD into a buffer, then converted and range checked as
+    /// `numeric_cast_n<T>()`, so the range is checked on the rounded value
+    template <typename T, typename Round, typename S,
+        typename std::enable_if<(std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value)
+        && is_round_policy<Round>::value && !std::is_integral<S>::value, int>::type = 0>
+    T* numeric_cast_n(const S* in, T* out, size_t n)
+    {
+        S rounded[detail::bulk_block_size];
+        for (size_t i = 0; i < n; i += detail::bulk_block_size)
+        {
+            const size_t m = n - i < detail::bulk_block_size ? n - i : detail::bulk_block_size;
+            detail::bulk_round_kernel<S, Round>::round_n(in + i, rounded, m);
+            if (!detail::bulk_kernel<T, S>::cast_n(rounded, out + i, m))
+            {
+                for (size_t j = 0; j < m; j++)
+                {
+                    out[i + j] = detail::numeric_cast<T, S>(rounded[j]);
+                }
+            }
+        }
+        return out + n;
+    }
+
+    /// integer needs no rounding
+    template <typename T, typename Round, typename S,
+        typename std::enable_if<(std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value)
+        && is_round_policy<Round>::value && std::is_integral<S>::value, int>::type = 0>
+    T* numeric_cast_n(const S* in, T* out, size_t n)
+    {
+        return numeric_cast_n<T>(in, out, n);
+    }
+
+    /// convert with a NaN policy, usage `numeric_cast_n<int32_t, nan_policy::to_zero>(in, out, n);`
+    /// NaN fails the ordered compare of the SIMD range check as an out-of-range value does,
+    /// only the blocks with NaN or out-of-range value are converted again by the scalar policy
+    template <typename T, typename Nan, typename S,
+        typename std::enable_if<(std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value)
+        && is_nan_policy<Nan>::value, int>::type = 0>
+    T* numeric_cast_n(const S* in, T* out, size_t n)
+    {
+        for (size_t i = 0; i < n; i += detail::bulk_block_size)
+        {
+            const size_t m = n - i < detail::bulk_block_size ? n - i : detail::bulk_block_size;
+            if (!detail::bulk_kernel<T, S>::cast_n(in + i, out + i, m))
+            {
+                for (size_t j = i; j < i + m; j++)
+                {
+                    out[j] = detail::policy_cast<T, S, Nan>(in[j]);
+                }
+            }
+        }
+        return out + n;
+    }
+
+    /// bulk version of `to_integer<T>()`, target type must be integer
+    template <typename T, typename S,
+        typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+    T* to_integer_n(const S* in, T* out, size_t n)
+    {
+        return numeric_cast_n<T>(in, out, n);
+    }
+
+    /// bulk version of `to_unsigned<T>()`, target type must be unsigned integer,
+    /// negative values throw `std::underflow_error`
+    template <typename T, typename S,
+        typename std::enable_if<std::is_unsigned<T>::value, int>::type = 0>
+    T* to_unsigned_n(const S* in, T* out, size_t n)
+    {
+        return numeric_cast_n<T>(in, out, n);
+    }
+
+    /// bulk version of `saturate_cast<T>()`, usage `saturate_cast_n<int16_t>(in, out, n);`
+    /// out-of-range elements are clamped to the limits of T, NaN is converted to `nan_value`.
+    /// Never throws for arithmetic types. Returns `out + n` as `std::copy_n()`
+    template <typename T, typename S,
+        typename std::enable_if<std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value, int>::type = 0>
+    T* saturate_cast_n(const S* in, T* out, size_t n, const T nan_value = std::numeric_limits<T>::quiet_NaN())
+    {
+        detail::bulk_kernel<T, S>::saturate_n(in, out, n, nan_value);
+        return out + n;
+    }
+
+    /// test `n` elements at once, usage `is_numeric_convertible_n<int32_t>(in, n, mask);`
+    /// bit `i % 64` of `mask[i / 64]` is set if `in[i]` is convertible to T,
+    /// `mask` must hold `(n + 63) / 64` words, or be `nullptr` if only the count is needed.
+    /// Returns the number of convertible elements
+    template <typename T, typename S,
+        typename std::enable_if<std::is_arithmetic<T>::value
+        || detail::supports_arithmetic_operations<T>::value, int>::type = 0>
+    size_t is_numeric_convertible_n(const S* in, size_t n, uint64_t* mask) noexcept
+    {
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64)
+        {
+            const uint64_t bits = detail::bulk_kernel<T, S>::convertible_bits(in + i);
+            count += detail::popcount64(bits);
+            if (mask)
+                mask[i / 64] = bits;
+        }
+        if (i < n)
+        {
+            const uint64_t bits = detail::convertible_bits_generic<T, S>(in + i, n - i);
+            count += detail::popcount64(bits);
+            if (mask)
+                mask[i / 64] = bits;
+        }
+        return count;
+    }
+
+    /// find NaN in `n` elements at once, usage `is_nan_n(in, n, mask);`, by one unordered
+    /// compare per SIMD vector for `double` and `float`. Bit `i % 64` of `mask[i / 64]`
+    /// is set if `in[i]` is NaN, `mask` may be `nullptr`. Returns the number of NaN
+    template <typename S>
+    size_t is_nan_n(const S* in, size_t n, uint64_t* mask) noexcept
+    {
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + 64 <= n; i += 64)
+        {
+            const uint64_t bits = detail::bulk_nan_kernel<S>::nan_bits(in + i);
+            count += detail::popcount64(bits);
+            if (mask)
+                mask[i / 64] = bits;
+        }
+        if (i < n)
+        {
+            const uint64_t bits = detail::nan_bits_generic<S>(in + i, n - i);
+            count += detail::popcount64(bits);
+            if (mask)
+                mask[i / 64] = bits;
+        }
+        return count;
+    }
+
+    /// compare `n` pairs of integers of any type and sign at once by the mathematical value,
+    /// usage `cmp_less_n(a, b, n, mask);`, bit `i % 64` of `mask[i / 64]` is set if
+    /// `cmp_less(a[i], b[i])`, `mask` must hold `(n + 63) / 64` words, or be `nullptr`.
+    /// Returns the number of pairs for which the comparison is true. Pairs of 32-bit integers
+    /// are compared by SIMD, e.g. `int32_t` and `uint32_t` by pcmpgtd and two logical instructions
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value, int>::type = 0>
+    size_t cmp_less_n(const A* a, const B* b, size_t n, uint64_t* mask) noexcept
+    {
+        return detail::cmp_n<detail::less_comparison, false>(a, b, n, mask);
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value, int>::type = 0>
+    size_t cmp_greater_n(const A* a, const B* b, size_t n, uint64_t* mask) noexcept
+    {
+        return detail::cmp_n<detail::less_comparison, false>(b, a, n, mask);
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value, int>::type = 0>
+    size_t cmp_less_equal_n(const A* a, const B* b, size_t n, uint64_t* mask) noexcept
+    {
+        return detail::cmp_n<detail::less_comparison, true>(b, a, n, mask);
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value, int>::type = 0>
+    size_t cmp_greater_equal_n(const A* a, const B* b, size_t n, uint64_t* mask) noexcept
+    {
+        return detail::cmp_n<detail::less_comparison, true>(a, b, n, mask);
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value, int>::type = 0>
+    size_t cmp_equal_n(const A* a, const B* b, size_t n, uint64_t* mask) noexcept
+    {
+        return detail::cmp_n<detail::equal_comparison, false>(a, b, n, mask);
+    }
+
+    template <typename A, typename B,
+        typename std::enable_if<std::is_integral<A>::value && std::is_integral<B>::value, int>::type = 0>
+    size_t cmp_not_equal_n(const A* a, const B* b, size_t n, uint64_t* mask) noexcept
+    {
+        return detail::cmp_n<detail::equal_comparison, true>(a, b, n, mask);
+    }
+
+#if __cplusplus > 201703L  && __has_include(<span>)  // C++20
+namespace detail{
+
+    /// a span too small for the input, `std::terminate()` with NUMERIC_CAST_NO_EXCEPTIONS
+    [[noreturn]] NUMERIC_CAST_COLD inline void throw_span_size_error(const char* message)
+    {
+#if NUMERIC_CAST_NO_EXCEPTIONS
+        std::fprintf(stderr, "%s\n", message);
+        std::terminate();
+#else
+        throw std::out_of_range(message);
+#endif
+    }
+}
+
+    /// span version, `out` must have at least as many elements as `in`
+    template <typename T, typename S, size_t InExtent, size_t OutExtent>
+    span<T, OutExtent> numeric_cast_n(span<S, InExtent> in, span<T, OutExtent> out)
+    {
+        if (out.size() < in.size())
+            detail::throw_span_size_error("output span is smaller than the input span");
+        numeric_cast_n<T>(in.data(), out.data(), in.size());
+        return out;
+    }
+
+    /// span version, `mask` must hold at least `(in.size() + 63) / 64` words
+    template <typename T, typename S, size_t InExtent, size_t MaskExtent>
+    size_t is_numeric_convertible_n(span<S, InExtent> in, span<uint64_t, MaskExtent> mask)
+    {
+        if (mask.size() < (in.size() + 63) / 64)
+            detail::throw_span_size_error("mask span is too small for the input span");
+        return is_numeric_convertible_n<T>(in.data(), in.size(), mask.data());
+    }
+#endif
+
+}
@@ -0,0 +1,493 @@
+/***********************************************************
+//              copyright Qingfeng Xia, 2020
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          https://www.boost.org/LICENSE_1_0.txt)
+************************************************************/
+
+/**
+* counters of the checked conversions, this is a header-only library
+*
+* Compiled with `-DNUMERIC_CAST_STATS=1`, each checked conversion of numeric_cast.h,
+* i.e. `numeric_cast<T>()`, `try_numeric_cast<T>()`, `to_integer<T>()`, `to_unsigned<T>()`
+* and `to_enum<T>()`, counts the call and the overflow, underflow or NaN error per (S, T) pair.
+* The lossless conversions, which are a bare `static_cast`, the overflow policies
+* other than `throw_on_overflow` and the SIMD kernels of numeric_cast_bulk.h are not counted.
+*
+* Each thread counts into its own shard, aligned to the cache line, without lock or atomic
+* read-modify-write. `numeric_cast_stats::snapshot()` sums the shards of the running threads
+* and the counts of the exited threads.
+* ```
+* auto stats = std::numeric_cast_stats::snapshot();
+* std::fputs(std::numeric_cast_stats::to_prometheus(stats).c_str(), metrics_file);
+* ```
+* Compiled with `-DNUMERIC_CAST_HEADROOM_SAMPLING=N`, 1 in N of the successful checked conversions
+* of each thread records the headroom of the value, `floor(log2(limit / |value|))` with the limit
+* of the target type of the same sign, into a histogram per (S, T) pair. E.g. an `int32_t` counter
+* above `INT32_MAX / 2` is in bucket 0, one doubling from the overflow. The sampling is a countdown
+* in a thread-local variable, the histograms are updated by relaxed atomic add.
+* ```
+* for (const auto& h : std::numeric_cast_stats::headroom_snapshot())
+*     if (h.buckets[0] != 0) warn(h.source, h.target);  // close to overflow
+* ```
+* Without the macros nothing is counted, the conversions are not changed at all,
+* and the snapshots are empty.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "numeric_cast.h"
+
+#if NUMERIC_CAST_INSTRUMENTED
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#if defined(__GXX_RTTI) || defined(_CPPRTTI) || defined(__cpp_rtti)
+#define NUMERIC_CAST_STATS_RTTI 1
+#include <typeinfo>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+#endif
+#endif
+
+/// the max count of (S, T) pairs, the conversions of the pairs above it are not counted
+#ifndef NUMERIC_CAST_STATS_MAX_PAIRS
+#define NUMERIC_CAST_STATS_MAX_PAIRS 256
+#endif
+
+namespace std {
+
+    /// counters of the checked conversions per (S, T) type pair, with NUMERIC_CAST_STATS
+    class numeric_cast_stats
+    {
+    public:
+        /// the counters of one type pair, the names are given by `numeric_type_name<T>::name()`,
+        /// or by `typeid(T).name()` for an enum or a user defined type without a name.
+        /// A pair named as another one gets the suffix `#<index>` on its source name
+        struct entry
+        {
+            const char* source;
+            const char* target;
+            uint64_t calls;
+            uint64_t overflows;
+            uint64_t underflows;
+            uint64_t nans;
+        };
+
+        /// bucket b holds the sampled values of headroom in [b, b + 1) bits, the last one also above
+        static constexpr unsigned headroom_buckets = 64;
+
+        /// the headroom histogram of one type pair
+        struct headroom_entry
+        {
+            const char* source;
+            const char* target;
+            uint64_t buckets[headroom_buckets];
+        };
+
+        /// true if compiled with NUMERIC_CAST_STATS
+        static constexpr bool enabled() noexcept
+        {
+#if NUMERIC_CAST_STATS
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /// N of NUMERIC_CAST_HEADROOM_SAMPLING, 0 if the headroom is not sampled
+        static constexpr unsigned headroom_sampling() noexcept
+        {
+#if NUMERIC_CAST_HEADROOM_SAMPLING
+            return NUMERIC_CAST_HEADROOM_SAMPLING;
+#else
+            return 0;
+#endif
+        }
+
+        /// the counts since the start or the last `reset()`, of the pairs converted at least once
+        static std::vector<entry> snapshot();
+
+        /// the headroom histograms since the start or the last `reset()`, of the pairs sampled at least once
+        static std::vector<headroom_entry> headroom_snapshot();
+
+        /// start counting from zero, the counts of the running threads are not modified
+        static void reset();
+
+        /// `{"numeric_cast_stats": [{"source": "double", "target": "int", "calls": 1, ...}]}`
+        static std::string to_json(const std::vector<entry>& entries);
+
+        /// the Prometheus text exposition format, `numeric_cast_calls_total{source="double",target="int"} 1`
+        /// and `numeric_cast_errors_total{source="double",target="int",error="overflow"} 0`
+        static std::string to_prometheus(const std::vector<entry>& entries);
+
+        /// `{"numeric_cast_headroom": [{"source": "long", "target": "int", "buckets": [0, 2, ...]}]}`
+        static std::string to_json(const std::vector<headroom_entry>& entries);
+
+        /// a Prometheus histogram, `numeric_cast_headroom_bits_bucket{source="long",target="int",le="1"} 0`
+        static std::string to_prometheus(const std::vector<headroom_entry>& entries);
+    };
+
+namespace detail{
+
+    template <typename... Args>
+    void append_format(std::string& text, const char* format, Args... args)
+    {
+        char buffer[256];
+        const int n = std::snprintf(buffer, sizeof(buffer), format, args...);
+        if (n > 0)
+            text.append(buffer, static_cast<size_t>(n) < sizeof(buffer) ? static_cast<size_t>(n) : sizeof(buffer) - 1);
+    }
+
+#if NUMERIC_CAST_INSTRUMENTED
+    /// calls, overflows, underflows, nans
+    enum { stats_counter_count = 4 };
+    typedef uint64_t stats_counters[NUMERIC_CAST_STATS_MAX_PAIRS][stats_counter_count];
+
+#if NUMERIC_CAST_STATS
+    /// the counters of one thread, written by that thread only, read by `snapshot()`
+    struct alignas(64) stats_shard
+    {
+        std::atomic<uint64_t> counters[NUMERIC_CAST_STATS_MAX_PAIRS][stats_counter_count];
+
+        stats_shard() noexcept;
+        ~stats_shard();
+
+        /// plain load and store, there is no other writer
+        void increment(const unsigned pair, const unsigned counter) noexcept
+        {
+            std::atomic<uint64_t>& c = counters[pair][counter];
+            c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    };
+
+#endif
+
+    /// the type pairs, the shards of the running threads and the headroom histograms
+    struct stats_registry
+    {
+        std::mutex mutex;
+        std::atomic<unsigned> pair_count{0};
+        const char* source[NUMERIC_CAST_STATS_MAX_PAIRS];
+        const char* target[NUMERIC_CAST_STATS_MAX_PAIRS];
+        std::string renamed[NUMERIC_CAST_STATS_MAX_PAIRS];  ///< the source name with the suffix
+#if NUMERIC_CAST_STATS
+        std::vector<stats_shard*> shards;
+        stats_counters retired = {};  ///< the counts of the exited threads
+        stats_counters baseline = {};  ///< the counts at the last `reset()`
+#endif
+#if NUMERIC_CAST_HEADROOM_SAMPLING
+        /// zero by the zero-initialization of the static instance
+        std::atomic<uint64_t> headroom[NUMERIC_CAST_STATS_MAX_PAIRS][numeric_cast_stats::headroom_buckets];
+#endif
+
+        static stats_registry& instance()
+        {
+            static stats_registry registry;
+            return registry;
+        }
+
+        /// the index of a new pair, NUMERIC_CAST_STATS_MAX_PAIRS if there is no place
+        unsigned add_pair(const char* source_name, const char* target_name)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const unsigned pair = pair_count.load(std::memory_order_relaxed);
+            if (pair >= NUMERIC_CAST_STATS_MAX_PAIRS)
+                return NUMERIC_CAST_STATS_MAX_PAIRS;
+            source[pair] = source_name;
+            target[pair] = target_name;
+            for (unsigned p = 0; p < pair; p++)
+                if (std::strcmp(source[p], source_name) == 0 && std::strcmp(target[p], target_name) == 0)
+                {
+                    renamed[pair] = std::string(source_name) + "#" + std::to_string(pair);
+                    source[pair] = renamed[pair].c_str();
+                    break;
+                }
+            pair_count.store(pair + 1, std::memory_order_release);
+            return pair;
+        }
+
+#if NUMERIC_CAST_STATS
+        /// the retired counts plus the counts of the running threads
+        void sum(stats_counters& total)
+        {
+            for (unsigned p = 0; p < NUMERIC_CAST_STATS_MAX_PAIRS; p++)
+                for (unsigned c = 0; c < stats_counter_count; c++)
+                    total[p][c] = retired[p][c];
+            for (const stats_shard* shard : shards)
+                for (unsigned p = 0; p < NUMERIC_CAST_STATS_MAX_PAIRS; p++)
+                    for (unsigned c = 0; c < stats_counter_count; c++)
+                        total[p][c] += shard->counters[p][c].load(std::memory_order_relaxed);
+        }
+#endif
+    };
+
+#if NUMERIC_CAST_STATS
+    inline stats_shard::stats_shard() noexcept
+    {
+        for (auto& pair : counters)
+            for (auto& c : pair)
+                c.store(0, std::memory_order_relaxed);
+        stats_registry& registry = stats_registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.shards.push_back(this);
+    }
+
+    /// keep the counts of the exiting thread
+    inline stats_shard::~stats_shard()
+    {
+        stats_registry& registry = stats_registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (unsigned p = 0; p < NUMERIC_CAST_STATS_MAX_PAIRS; p++)
+            for (unsigned c = 0; c < stats_counter_count; c++)
+                registry.retired[p][c] += counters[p][c].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < registry.shards.size(); i++)
+            if (registry.shards[i] == this)
+            {
+                registry.shards.erase(registry.shards.begin() + static_cast<ptrdiff_t>(i));
+                break;
+            }
+    }
+
+    inline stats_shard& thread_stats_shard()
+    {
+        static thread_local stats_shard shard;
+        return shard;
+    }
+#endif
+
+    /// `typeid(T).name()`, demangled by GCC and clang, kept for the life of the program
+    template <typename T>
+    const char* rtti_type_name()
+    {
+#if NUMERIC_CAST_STATS_RTTI
+        const char* name = typeid(T).name();
+#if defined(__GNUG__)
+        int status = 0;
+        const char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        return status == 0 && demangled ? demangled : name;
+#else
+        return name;
+#endif
+#else
+        return numeric_type_name<T>::name();
+#endif
+    }
+
+    /// the name of T in the stats, `rtti_type_name<T>()` if `numeric_type_name<T>` does not tell
+    /// the type, e.g. "enum", otherwise the pairs of two enums would have the same names
+    template <typename T>
+    const char* stats_type_name()
+    {
+        const char* name = numeric_type_name<T>::name();
+        return std::strcmp(name, "enum") == 0 || std::strcmp(name, "non-builtin type") == 0
+            ? rtti_type_name<T>() : name;
+    }
+
+    /// the index of the (S, T) pair, given at its first conversion
+    template <typename T, typename S>
+    unsigned stats_pair()
+    {
+        static const unsigned pair = stats_registry::instance().add_pair(
+            stats_type_name<S>(), stats_type_name<T>());
+        return pair;
+    }
+
+#if NUMERIC_CAST_HEADROOM_SAMPLING
+    /// true for 1 in NUMERIC_CAST_HEADROOM_SAMPLING calls of each thread
+    inline bool sample_headroom() noexcept
+    {
+        static thread_local unsigned countdown = NUMERIC_CAST_HEADROOM_SAMPLING;
+        if (--countdown != 0)
+            return false;
+        countdown = NUMERIC_CAST_HEADROOM_SAMPLING;
+        return true;
+    }
+
+    /// `floor(log2(limit / |value|))` in [0, headroom_buckets), for a value in the range of T
+    template <typename T, typename S>
+    unsigned headroom_bits(const S value) noexcept
+    {
+        const double v = static_cast<double>(value);
+        const double limit = v < 0 ? -static_cast<double>(std::numeric_limits<T>::lowest())
+            : static_cast<double>(std::numeric_limits<T>::max());
+        const unsigned last = numeric_cast_stats::headroom_buckets - 1;
+        if (v == 0)
+            return last;
+        const int bits = std::ilogb(limit / std::fabs(v));  // INT_MIN for zero limit, INT_MAX for infinity
+        return bits < 0 ? 0 : (bits > static_cast<int>(last) ? last : static_cast<unsigned>(bits));
+    }
+#endif
+
+    template <typename T, typename S>
+    void count_numeric_cast(const numeric_cast_errc error, const S value) noexcept
+    {
+        const unsigned pair = stats_pair<T, S>();
+        if (pair >= NUMERIC_CAST_STATS_MAX_PAIRS)
+            return;
+#if NUMERIC_CAST_STATS
+        stats_shard& shard = thread_stats_shard();
+        shard.increment(pair, 0);
+        if (error == numeric_cast_errc::overflow)
+            shard.increment(pair, 1);
+        else if (error == numeric_cast_errc::underflow)
+            shard.increment(pair, 2);
+        else if (error == numeric_cast_errc::nan)
+            shard.increment(pair, 3);
+#endif
+#if NUMERIC_CAST_HEADROOM_SAMPLING
+        if (error == numeric_cast_errc::ok && sample_headroom())
+            stats_registry::instance().headroom[pair][headroom_bits<T, S>(value)].fetch_add(1, std::memory_order_relaxed);
+#else
+        static_cast<void>(value);
+#endif
+    }
+#endif
+}
+
+    inline std::vector<numeric_cast_stats::entry> numeric_cast_stats::snapshot()
+    {
+        std::vector<entry> entries;
+#if NUMERIC_CAST_STATS
+        detail::stats_registry& registry = detail::stats_registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        detail::stats_counters total;
+        registry.sum(total);
+        const unsigned pair_count = registry.pair_count.load(std::memory_order_acquire);
+        for (unsigned p = 0; p < pair_count; p++)
+        {
+            const uint64_t* counts = total[p];
+            const uint64_t* base = registry.baseline[p];
+            const entry e = {registry.source[p], registry.target[p], counts[0] - base[0],
+                             counts[1] - base[1], counts[2] - base[2], counts[3] - base[3]};
+            if (e.calls != 0)
+                entries.push_back(e);
+        }
+#endif
+        return entries;
+    }
+
+    inline std::vector<numeric_cast_stats::headroom_entry> numeric_cast_stats::headroom_snapshot()
+    {
+        std::vector<headroom_entry> entries;
+#if NUMERIC_CAST_HEADROOM_SAMPLING
+        detail::stats_registry& registry = detail::stats_registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        const unsigned pair_count = registry.pair_count.load(std::memory_order_acquire);
+        for (unsigned p = 0; p < pair_count; p++)
+        {
+            headroom_entry e = {registry.source[p], registry.target[p], {}};
+            uint64_t samples = 0;
+            for (unsigned b = 0; b < headroom_buckets; b++)
+            {
+                e.buckets[b] = registry.headroom[p][b].load(std::memory_order_relaxed);
+                samples += e.buckets[b];
+            }
+            if (samples != 0)
+                entries.push_back(e);
+        }
+#endif
+        return entries;
+    }
+
+    inline void numeric_cast_stats::reset()
+    {
+#if NUMERIC_CAST_INSTRUMENTED
+        detail::stats_registry& registry = detail::stats_registry::instance();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+#if NUMERIC_CAST_STATS
+        registry.sum(registry.baseline);
+#endif
+#if NUMERIC_CAST_HEADROOM_SAMPLING
+        for (auto& pair : registry.headroom)
+            for (auto& bucket : pair)
+                bucket.store(0, std::memory_order_relaxed);
+#endif
+#endif
+    }
+
+    inline std::string numeric_cast_stats::to_json(const std::vector<entry>& entries)
+    {
+        std::string text = "{\"numeric_cast_stats\": [";
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            const entry& e = entries[i];
+            detail::append_format(text, "%s\n  {\"source\": \"%s\", \"target\": \"%s\", \"calls\": %llu, "
+                "\"overflows\": %llu, \"underflows\": %llu, \"nans\": %llu}", i ? "," : "", e.source, e.target,
+                static_cast<unsigned long long>(e.calls), static_cast<unsigned long long>(e.overflows),
+                static_cast<unsigned long long>(e.underflows), static_cast<unsigned long long>(e.nans));
+        }
+        text += entries.empty() ? "]}\n" : "\n]}\n";
+        return text;
+    }
+
+    inline std::string numeric_cast_stats::to_prometheus(const std::vector<entry>& entries)
+    {
+        std::string text = "# HELP numeric_cast_calls_total Checked numeric conversions.\n"
+                           "# TYPE numeric_cast_calls_total counter\n";
+        for (const entry& e : entries)
+            detail::append_format(text, "numeric_cast_calls_total{source=\"%s\",target=\"%s\"} %llu\n",
+                e.source, e.target, static_cast<unsigned long long>(e.calls));
+        text += "# HELP numeric_cast_errors_total Checked numeric conversions out of the range of the target type.\n"
+                "# TYPE numeric_cast_errors_total counter\n";
+        for (const entry& e : entries)
+        {
+            const uint64_t counts[] = {e.overflows, e.underflows, e.nans};
+            const char* const errors[] = {"overflow", "underflow", "nan"};
+            for (int i = 0; i < 3; i++)
+                detail::append_format(text, "numeric_cast_errors_total{source=\"%s\",target=\"%s\",error=\"%s\"} %llu\n",
+                    e.source, e.target, errors[i], static_cast<unsigned long long>(counts[i]));
+        }
+        return text;
+    }
+
+    inline std::string numeric_cast_stats::to_json(const std::vector<headroom_entry>& entries)
+    {
+        std::string text = "{\"numeric_cast_headroom\": [";
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            const headroom_entry& e = entries[i];
+            detail::append_format(text, "%s\n  {\"source\": \"%s\", \"target\": \"%s\", \"buckets\": [",
+                i ? "," : "", e.source, e.target);
+            for (unsigned b = 0; b < headroom_buckets; b++)
+                detail::append_format(text, b ? ", %llu" : "%llu", static_cast<unsigned long long>(e.buckets[b]));
+            text += "]}";
+        }
+        text += entries.empty() ? "]}\n" : "\n]}\n";
+        return text;
+    }
+
+    /// the buckets are cumulative by the upper bound `le`, `_sum` is the sum of the lower bounds
+    inline std::string numeric_cast_stats::to_prometheus(const std::vector<headroom_entry>& entries)
+    {
+        std::string text = "# HELP numeric_cast_headroom_bits Sampled log2 headroom to the limit of the target type.\n"
+                           "# TYPE numeric_cast_headroom_bits histogram\n";
+        for (const headroom_entry& e : entries)
+        {
+            unsigned long long count = 0;
+            unsigned long long sum = 0;
+            for (unsigned b = 0; b < headroom_buckets; b++)
+            {
+                count += e.buckets[b];
+                sum += e.buckets[b] * b;
+                if (b + 1 < headroom_buckets)
+                    detail::append_format(text, "numeric_cast_headroom_bits_bucket{source=\"%s\",target=\"%s\",le=\"%u\"} %llu\n",
+                        e.source, e.target, b + 1, count);
+            }
+            detail::append_format(text, "numeric_cast_headroom_bits_bucket{source=\"%s\",target=\"%s\",le=\"+Inf\"} %llu\n",
+                e.source, e.target, count);
+            detail::append_format(text, "numeric_cast_headroom_bits_sum{source=\"%s\",target=\"%s\"} %llu\n",
+                e.source, e.target, sum);
+            detail::append_format(text, "numeric_cast_headroom_bits_count{source=\"%s\",target=\"%s\"} %llu\n",
+                e.source, e.target, count);
+        }
+        return text;
+    }
+}
@@ -0,0 +1,119 @@
+# usage: cmake -DOBJDUMP=<objdump> -DOBJECTS=<object files> [-DNO_EXCEPTIONS=ON] [-DASSUME=ON]
+#     -P check_codegen_disassembly.cmake
+# disassembles each `probe_*` function of codegen_probe.cpp and its `.cold` part,
+# then checks the instructions by the prefix of the function name, see codegen_probe.cpp.
+# With NO_EXCEPTIONS, for the objects compiled by -fno-exceptions, there must be
+# no exception table and no call of the exception machinery at all.
+# With ASSUME, for the objects compiled by NUMERIC_CAST_MODE_ASSUME, the checked
+# conversions must have no compare and no call left, as the lossless ones
+
+# -r shows the relocations, i.e. the names of the called functions in the unlinked object
+execute_process(COMMAND ${OBJDUMP} -d -r --no-show-raw-insn -M att ${OBJECTS}
+    OUTPUT_VARIABLE disassembly
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${OBJDUMP} failed on ${OBJECTS}")
+endif()
+
+# `;` is the list separator of cmake and `[` `]` suppress it, none of them is needed here
+string(REPLACE ";" "," disassembly "${disassembly}")
+string(REPLACE "[" "(" disassembly "${disassembly}")
+string(REPLACE "]" ")" disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+set(probes "")
+set(name "")
+foreach(line IN LISTS lines)
+    # 0000000000000000 <probe_lossless_int32_to_int64>:
+    # any other symbol ends the probe, also a clone such as `<_ZN...failure...isra.0>`
+    if(line MATCHES "^[0-9a-fA-F]+ <([^>]+)>:")
+        set(symbol "${CMAKE_MATCH_1}")
+        set(name "")
+        if(symbol MATCHES "^_?(probe_[A-Za-z0-9_]+)(\\.cold[.0-9]*)?$")
+            set(name "${CMAKE_MATCH_1}")
+            if(NOT DEFINED insn_${name})
+                set(insn_${name} "")
+                list(APPEND probes ${name})
+            endif()
+        endif()
+    # "   4:	movslq %edi,%rax" or "			24: R_X86_64_PLT32	__cxa_throw-0x4"
+    elseif(name AND line MATCHES "^[ \t]*[0-9a-fA-F]+:[ \t]+(.+)$")
+        string(STRIP "${CMAKE_MATCH_1}" instruction)
+        list(APPEND insn_${name} "${instruction}")
+    endif()
+endforeach()
+
+if(NO_EXCEPTIONS)
+    execute_process(COMMAND ${OBJDUMP} -h ${OBJECTS} OUTPUT_VARIABLE sections)
+    if(sections MATCHES "gcc_except_table")
+        message(FATAL_ERROR "${OBJECTS} has an exception table, compiled with -fno-exceptions")
+    endif()
+    if(disassembly MATCHES "__cxa_")
+        message(FATAL_ERROR "${OBJECTS} calls the exception machinery, compiled with -fno-exceptions")
+    endif()
+endif()
+
+if(NOT probes)
+    message(FATAL_ERROR "no probe_* function found in ${OBJECTS}")
+endif()
+
+set(failed FALSE)
+foreach(name IN LISTS probes)
+    set(compares 0)
+    set(calls 0)
+    set(cxa_calls 0)
+    set(vectors 0)
+    set(count 0)
+    foreach(instruction IN LISTS insn_${name})
+        if(NOT instruction MATCHES "^R_")
+            math(EXPR count "${count} + 1")
+        endif()
+        if(instruction MATCHES "^(cmp|test|u?comis|j[a-ln-z])")
+            math(EXPR compares "${compares} + 1")
+        endif()
+        # a direct call or tail jump has a PLT32 relocation, an indirect one is `call *`
+        if(instruction MATCHES "^R_[A-Z0-9_]+_PLT32|^call[a-z]*[ \t]+\\*")
+            math(EXPR calls "${calls} + 1")
+        endif()
+        if(instruction MATCHES "__cxa_|_Unwind_")
+            math(EXPR cxa_calls "${cxa_calls} + 1")
+        endif()
+        # packed instructions only, a scalar `cvttsd2si %xmm0,%eax` loop also uses xmm registers
+        if(instruction MATCHES "^v?(cvtt?p[sd]2dq|p(add|max|min|cmp|ack|mov)[a-z]*|(min|max|cmp[a-z]*)p[sd])[ \t]")
+            math(EXPR vectors "${vectors} + 1")
+        endif()
+    endforeach()
+    message(STATUS "${name}: ${count} instructions, ${compares} compares, ${calls} calls, ${vectors} packed")
+
+    if(name MATCHES "^probe_lossless_")
+        if(compares GREATER 0 OR calls GREATER 0)
+            message(SEND_ERROR "${name} is lossless but has ${compares} compares and ${calls} calls")
+            set(failed TRUE)
+        endif()
+    elseif(name MATCHES "^probe_checked_")
+        if(ASSUME AND (compares GREATER 0 OR calls GREATER 0))
+            message(SEND_ERROR "${name} is assumed in range but has ${compares} compares and ${calls} calls")
+            set(failed TRUE)
+        endif()
+        if(cxa_calls GREATER 0)
+            message(SEND_ERROR "${name} calls the exception machinery inline, not the out-of-line helper")
+            set(failed TRUE)
+        endif()
+    elseif(name MATCHES "^probe_arith_")
+        if(compares GREATER 1 OR cxa_calls GREATER 0)
+            message(SEND_ERROR "${name} has ${compares} compares and branches, not a single jo")
+            set(failed TRUE)
+        endif()
+    elseif(name MATCHES "^probe_bulk_")
+        if(vectors EQUAL 0)
+            message(SEND_ERROR "${name} has no packed vector instruction")
+            set(failed TRUE)
+        endif()
+    endif()
+endforeach()
+if(failed)
+    foreach(name IN LISTS probes)
+        string(REPLACE ";" "\n    " listing "${insn_${name}}")
+        message(STATUS "${name}:\n    ${listing}")
+    endforeach()
+    message(FATAL_ERROR "codegen of the probe functions has regressed")
+endif()
@@ -0,0 +1,42 @@
+# usage: cmake -DNM=<nm> -DOBJECTS=<object files> -DBUDGET=<bytes> -P check_codegen_size.cmake
+# sums the size of each `call_site_*` function and its `.cold` part,
+# fails if any call site is larger than BUDGET bytes
+
+execute_process(COMMAND ${NM} -S --size-sort ${OBJECTS}
+    OUTPUT_VARIABLE symbols
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${OBJECTS}")
+endif()
+
+string(REPLACE "\n" ";" lines "${symbols}")
+set(call_sites "")
+foreach(line IN LISTS lines)
+    # address size type name
+    if(line MATCHES "^[0-9a-fA-F]+ ([0-9a-fA-F]+) [tT] _?(call_site_[A-Za-z0-9_]+)")
+        set(hex_size "${CMAKE_MATCH_1}")
+        set(name "${CMAKE_MATCH_2}")
+        math(EXPR bytes "0x${hex_size}")
+        if(NOT DEFINED size_${name})
+            set(size_${name} 0)
+            list(APPEND call_sites ${name})
+        endif()
+        math(EXPR size_${name} "${size_${name}} + ${bytes}")
+    endif()
+endforeach()
+
+if(NOT call_sites)
+    message(FATAL_ERROR "no call_site_* function found in ${OBJECTS}")
+endif()
+
+set(failed FALSE)
+foreach(name IN LISTS call_sites)
+    message(STATUS "${name}: ${size_${name}} bytes")
+    if(size_${name} GREATER BUDGET)
+        message(SEND_ERROR "${name} is ${size_${name}} bytes, above the budget of ${BUDGET} bytes")
+        set(failed TRUE)
+    endif()
+endforeach()
+if(failed)
+    message(FATAL_ERROR "code size of the call sites is above the budget")
+endif()
@@ -0,0 +1,64 @@
+/*
+Probe functions of the zero-overhead claims, compiled at -O2 but not linked,
+the disassembly of each function is checked by check_codegen_disassembly.cmake,
+by the prefix of its name:
+  probe_lossless_*  no compare, no branch and no call, as a plain static_cast
+  probe_checked_*   the failure is a call of the out-of-line helper, no __cxa_* call inline
+  probe_bulk_*      the range check is vectorized, packed compare/min/max/convert/pack instructions are present
+  probe_arith_*     the overflow check is the flag of the instruction, a single jo/jb
+NUMERIC_CAST_NO_DISPATCH selects the kernel at compile time, so that it is inlined here.
+*/
+
+#define NUMERIC_CAST_NO_DISPATCH 1
+#include "../numeric_cast.h"
+#include "../numeric_cast_bulk.h"
+#include "../checked_arithmetic.h"
+
+extern "C" {
+
+int64_t probe_lossless_int32_to_int64(int32_t v) { return std::numeric_cast<int64_t>(v); }
+uint32_t probe_lossless_uint16_to_uint32(uint16_t v) { return std::to_unsigned<uint32_t>(v); }
+int32_t probe_lossless_uint16_to_int32(uint16_t v) { return std::to_integer<int32_t>(v); }
+double probe_lossless_int32_to_double(int32_t v) { return std::numeric_cast<double>(v); }
+double probe_lossless_float_to_double(float v) { return std::numeric_cast<double>(v); }
+int64_t probe_lossless_int8_to_int64(int8_t v) { return std::numeric_cast<int64_t>(v); }
+int32_t probe_lossless_checked_int16_add(int16_t a, int16_t b)
+{
+    return (std::checked<int16_t>(a) + std::checked<int16_t>(b)).value();
+}
+uint64_t probe_lossless_checked_uint32_mul(uint32_t a, uint32_t b)
+{
+    return (std::checked<uint32_t>(a) * b).value();
+}
+
+int32_t probe_checked_double_to_int32(double v) { return std::numeric_cast<int32_t>(v); }
+int8_t probe_checked_int_to_int8(int v) { return std::numeric_cast<int8_t>(v); }
+uint32_t probe_checked_int64_to_uint32(int64_t v) { return std::to_unsigned<uint32_t>(v); }
+int32_t probe_checked_to_unsigned_int64_to_int32(int64_t v) { return std::to_unsigned<int32_t>(v); }
+int32_t probe_checked_to_unsigned_double_to_int32(double v) { return std::to_unsigned<int32_t>(v); }
+
+int32_t probe_arith_add_int32(int32_t a, int32_t b) { return std::checked_add(a, b); }
+uint32_t probe_arith_add_uint32(uint32_t a, uint32_t b) { return std::checked_add(a, b); }
+int32_t probe_arith_sub_int32(int32_t a, int32_t b) { return std::checked_sub(a, b); }
+uint64_t probe_arith_sub_uint64(uint64_t a, uint64_t b) { return std::checked_sub(a, b); }
+int64_t probe_arith_mul_int64(int64_t a, int64_t b) { return std::checked_mul(a, b); }
+int64_t probe_arith_checked_increment(int64_t v)
+{
+    std::checked<int64_t> c(v);
+    return (++c).value();
+}
+
+void probe_bulk_saturate_double_to_int32(const double* in, int32_t* out, size_t n)
+{
+    std::saturate_cast_n<int32_t>(in, out, n);
+}
+void probe_bulk_saturate_int32_to_int16(const int32_t* in, int16_t* out, size_t n)
+{
+    std::saturate_cast_n<int16_t>(in, out, n);
+}
+void probe_bulk_numeric_cast_float_to_int32(const float* in, int32_t* out, size_t n)
+{
+    std::numeric_cast_n<int32_t>(in, out, n);
+}
+
+}
@@ -0,0 +1,23 @@
+/*
+Call sites of the checked conversions, compiled with optimization but not linked,
+the size of each function is measured by check_codegen_size.cmake.
+The failure path must be a call of the out-of-line throw helper, not inlined
+construction of the exception, so each function stays a few dozen bytes.
+*/
+
+#include "../numeric_cast.h"
+
+enum class codegen_color : int16_t { red, green };
+
+extern "C" {
+
+int32_t call_site_double_to_int32(double v) { return std::numeric_cast<int32_t>(v); }
+int16_t call_site_float_to_int16(float v) { return std::numeric_cast<int16_t>(v); }
+int8_t call_site_int_to_int8(int v) { return std::numeric_cast<int8_t>(v); }
+uint32_t call_site_int64_to_uint32(int64_t v) { return std::numeric_cast<uint32_t>(v); }
+int16_t call_site_to_integer(long v) { return std::to_integer<int16_t>(v); }
+uint16_t call_site_to_unsigned(int v) { return std::to_unsigned<uint16_t>(v); }
+uint8_t call_site_enum_to_unsigned(codegen_color c) { return std::to_unsigned<uint8_t>(c); }
+int32_t call_site_nearest_even(double v) { return std::numeric_cast<int32_t, std::round_policy::nearest_even>(v); }
+
+}
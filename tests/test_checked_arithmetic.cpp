@@ -0,0 +1,338 @@
+/*
+These tests use a the Catch2 header only c++ test framework: https://github.com/catchorg/Catch2
+*/
+
+#include "../third-party/catch.h"
+
+#include "../checked_arithmetic.h"
+
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/// the failure handler of `overflow_policy::report`
+std::string reported_message;
+
+void record_message(const std::numeric_cast_failure_info& failure)
+{
+    reported_message = failure.message();
+}
+
+TEST_CASE("std::checked_add/sub/mul/neg/shl unit test", "[std::checked_add]")
+{
+    SECTION("in range")
+    {
+        CHECK(std::checked_add(1, 2) == 3);
+        CHECK(std::checked_sub(INT_MIN + 1, 1) == INT_MIN);
+        CHECK(std::checked_mul<int64_t>(INT_MAX, 2) == int64_t(INT_MAX) * 2);
+        CHECK(std::checked_neg<int64_t>(INT_MIN) == -int64_t(INT_MIN));
+        CHECK(std::checked_shl(-1, 31) == INT_MIN);
+        CHECK(std::checked_shl(0, 100) == 0);
+    }
+
+    SECTION("mixed types and signs, by the mathematical value")
+    {
+        CHECK(std::checked_add<int>(-1, 1u) == 0);
+        CHECK(std::checked_add<uint8_t>(300, -100) == 200);
+        CHECK(std::checked_sub<int8_t>(0u, 128u) == INT8_MIN);
+        CHECK(std::checked_mul<uint64_t>(-4, -5) == 20u);
+        CHECK(std::checked_neg<uint32_t>(-5) == 5u);
+        REQUIRE_THROWS_AS(std::checked_add<unsigned>(-1, 0u), std::underflow_error);
+        REQUIRE_THROWS_AS(std::checked_sub<uint32_t>(1u, 2u), std::underflow_error);
+    }
+
+    SECTION("throw by default")
+    {
+        REQUIRE_THROWS_AS(std::checked_add(INT_MAX, 1), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_sub(INT_MIN, 1), std::underflow_error);
+        REQUIRE_THROWS_AS(std::checked_mul(INT_MIN, -1), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_mul(INT64_MAX, INT64_MIN), std::underflow_error);
+        REQUIRE_THROWS_AS(std::checked_neg(INT_MIN), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_neg(1u), std::underflow_error);
+        REQUIRE_THROWS_AS(std::checked_shl(1, 31), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_shl(1, 64), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_shl(1, -1), std::range_error);
+        REQUIRE_THROWS_AS(std::checked_add<int8_t>(int8_t(100), int8_t(100)), std::overflow_error);
+    }
+
+    SECTION("the message has the operand types and values")
+    {
+        const auto message = [](const std::function<void()>& operation) -> std::string
+        {
+            try
+            {
+                operation();
+            }
+            catch (const std::numeric_cast_error& e)
+            {
+                return e.message();
+            }
+            return "";
+        };
+        CHECK(message([] { std::checked_add(INT_MAX, 1); }) == "numeric_cast: int 2147483647 + 1 overflows int");
+        CHECK(message([] { std::checked_sub<unsigned>(-1, 0u); })
+              == "numeric_cast: int and unsigned int -1 - 0 underflows unsigned int");
+        CHECK(message([] { std::checked_mul<int8_t>(short(-100), short(2)); })
+              == "numeric_cast: short -100 * 2 underflows signed char");
+        CHECK(message([] { std::checked_neg(INT_MIN); }) == "numeric_cast: int -(-2147483648) overflows int");
+        CHECK(message([] { std::checked_shl(-1, 40); }) == "numeric_cast: int -1 << 40 underflows int");
+        CHECK(message([] { std::checked_shl(1, -1); }) == "numeric_cast: int 1 << -1 has a negative shift count");
+        // the operands are exact, not rounded to the precision of long double
+        const std::string int64_name = std::numeric_type_name<int64_t>::name();
+        CHECK(message([] { std::checked_add(INT64_MAX, int64_t(1)); })
+              == "numeric_cast: " + int64_name + " 9223372036854775807 + 1 overflows " + int64_name);
+        try
+        {
+            std::checked_add(UINT64_MAX, UINT64_MAX);
+        }
+        catch (const std::numeric_cast_error& e)
+        {
+            CHECK(e.kind() == std::numeric_cast_errc::overflow);
+            CHECK(std::string(e.value()) == "18446744073709551615 + 18446744073709551615");
+            CHECK(std::string(e.source_type()) == std::numeric_type_name<uint64_t>::name());
+        }
+
+        const std::numeric_cast_failure_handler previous = std::set_numeric_cast_failure_handler(record_message);
+        CHECK(std::checked_sub<uint8_t, std::overflow_policy::report>(1, 2) == 0);
+        CHECK(reported_message == "numeric_cast: int 1 - 2 underflows unsigned char");
+        CHECK(std::checked_shl<int, std::overflow_policy::report>(1, -1) == 0);
+        CHECK(reported_message == "numeric_cast: int 1 << -1 has a negative shift count");
+        std::set_numeric_cast_failure_handler(previous);
+    }
+
+    SECTION("overflow policies")
+    {
+        using namespace std::overflow_policy;
+        CHECK(std::checked_add<int8_t, saturate>(100, 100) == INT8_MAX);
+        CHECK(std::checked_sub<uint8_t, saturate>(1, 2) == 0);
+        CHECK(std::checked_mul<int64_t, saturate>(INT64_MIN, 2) == INT64_MIN);
+        CHECK(std::checked_mul<int64_t, saturate>(INT64_MIN, -1) == INT64_MAX);
+        CHECK(std::checked_shl<int, saturate>(-1, 40) == INT_MIN);
+        CHECK(std::checked_add<int8_t, wrap>(100, 100) == -56);
+        CHECK(std::checked_mul<uint16_t, wrap>(0x1234u, 0x10000u) == 0);
+        CHECK(std::checked_neg<int, wrap>(INT_MIN) == INT_MIN);
+        CHECK(std::checked_add<int, assume_in_range>(1, 2) == 3);
+    }
+
+    SECTION("portable checks without the builtins")
+    {
+        int8_t r = 0;
+        CHECK_FALSE(std::detail::portable_add_overflow(100, 27, r));
+        CHECK(r == 127);
+        CHECK(std::detail::portable_add_overflow(100, 28, r));
+        CHECK(r == -128);
+        CHECK(std::detail::portable_sub_overflow(-100, 29, r));
+        CHECK_FALSE(std::detail::portable_sub_overflow(-100, 28, r));
+        CHECK(r == -128);
+        CHECK(std::detail::portable_mul_overflow(3, -43, r));
+        CHECK_FALSE(std::detail::portable_mul_overflow(3, -42, r));
+        CHECK(std::detail::portable_mul_overflow(-16, -8, r));
+        CHECK_FALSE(std::detail::portable_mul_overflow(-16, 8, r));
+        CHECK(r == -128);
+        CHECK(std::detail::portable_mul_overflow(-128, -1, r));
+        uint32_t u = 0;
+        CHECK(std::detail::portable_sub_overflow(1u, 2u, u));
+        CHECK(u == UINT32_MAX);
+        CHECK(std::detail::portable_mul_overflow(65536u, 65536u, u));
+        CHECK_FALSE(std::detail::portable_mul_overflow(65535u, 65537u, u));
+        // the result of the operand values is checked, even if an operand is out of the range of R
+        CHECK(std::detail::portable_add_overflow(300, -100, r));
+        uint8_t b = 0;
+        CHECK_FALSE(std::detail::portable_add_overflow(300, -100, b));
+        CHECK(b == 200);
+        CHECK_FALSE(std::detail::portable_sub_overflow(-100, -300, b));
+        CHECK(b == 200);
+        CHECK_FALSE(std::detail::portable_mul_overflow(-4, -5, b));
+        CHECK(b == 20);
+        CHECK_FALSE(std::detail::portable_sub_overflow(0u, 128u, r));
+        CHECK(r == INT8_MIN);
+        CHECK(std::detail::portable_sub_overflow(0u, 129u, r));
+        int64_t w = 0;
+        CHECK_FALSE(std::detail::portable_add_overflow(UINT64_MAX, INT64_MIN, w));
+        CHECK(w == INT64_MAX);
+        CHECK(std::detail::portable_mul_overflow(UINT64_MAX, -1, w));
+    }
+}
+
+TEST_CASE("std::checked<T> integer wrapper", "[std::checked]")
+{
+    using std::checked;
+
+    SECTION("promoted to a type wide enough for every result")
+    {
+        static_assert(std::is_same<decltype(checked<int16_t>() + checked<int16_t>()), checked<int32_t>>::value,
+                      "int16_t + int16_t in int32_t");
+        static_assert(std::is_same<decltype(checked<uint32_t>() * checked<uint32_t>()), checked<uint64_t>>::value,
+                      "uint32_t * uint32_t in uint64_t");
+        static_assert(std::is_same<decltype(checked<uint8_t>() - checked<uint8_t>()), checked<int32_t>>::value,
+                      "the difference is signed");
+        static_assert(std::is_same<decltype(checked<int32_t>() + 1u), checked<int64_t>>::value,
+                      "int32_t + unsigned in int64_t");
+        static_assert(std::is_same<decltype(-checked<int32_t>()), checked<int64_t>>::value,
+                      "-INT32_MIN in int64_t");
+        static_assert(std::is_same<decltype(checked<int64_t>() + checked<int64_t>()), checked<int64_t>>::value,
+                      "checked at runtime");
+        constexpr checked<int32_t> sum = checked<int16_t>(int16_t(30000)) + int16_t(30000);
+        static_assert(sum.value() == 60000, "constexpr without check");
+
+        CHECK((checked<int32_t>(INT32_MIN) * checked<int32_t>(INT32_MIN)).value() == int64_t(1) << 62);
+        CHECK((checked<uint32_t>(0u) - checked<uint32_t>(UINT32_MAX)).value() == -int64_t(UINT32_MAX));
+        CHECK((-checked<int32_t>(INT32_MIN)).value() == int64_t(1) << 31);
+        CHECK((checked<int64_t>(1) + checked<int64_t>(2)).value() == 3);
+        REQUIRE_THROWS_AS(checked<int64_t>(INT64_MAX) + 1, std::overflow_error);
+        REQUIRE_THROWS_AS(checked<uint64_t>(UINT64_MAX) * checked<uint64_t>(2u), std::overflow_error);
+        REQUIRE_THROWS_AS(-checked<int64_t>(INT64_MIN), std::overflow_error);
+    }
+
+    SECTION("checked in the type of the wider operand if no 64-bit type holds every result")
+    {
+        static_assert(std::is_same<decltype(checked<uint64_t>() - 1u), checked<uint64_t>>::value,
+                      "uint64_t - unsigned in uint64_t");
+        static_assert(std::is_same<decltype(checked<uint64_t>() + checked<int64_t>()), checked<uint64_t>>::value,
+                      "uint64_t + int64_t in uint64_t");
+        checked<uint64_t> x(UINT64_MAX);
+        CHECK((x - 1u).value() == UINT64_MAX - 1);
+        CHECK((x - checked<uint64_t>(uint64_t(1))).value() == UINT64_MAX - 1);
+        CHECK((x + checked<int64_t>(-1)).value() == UINT64_MAX - 1);
+        CHECK((x + (-1)).value() == UINT64_MAX - 1);
+        x -= 1u;
+        CHECK(x.value() == UINT64_MAX - 1);
+        REQUIRE_THROWS_AS(checked<uint64_t>(uint64_t(1)) - 2u, std::underflow_error);
+        REQUIRE_THROWS_AS(checked<uint64_t>(UINT64_MAX) + 1u, std::overflow_error);
+    }
+
+    SECTION("compound assignment keeps the type")
+    {
+        checked<int8_t> c(int8_t(120));
+        c += 7;
+        CHECK(c.value() == 127);
+        REQUIRE_THROWS_AS(++c, std::overflow_error);
+        CHECK(c.value() == 127);
+        c -= checked<int32_t>(255);
+        CHECK(c == -128);
+        REQUIRE_THROWS_AS(c--, std::underflow_error);
+        c *= -1 * 0;
+        CHECK(c == 0);
+        checked<uint16_t> n;
+        for (int i = 0; i < 10; i++)
+            n++;
+        CHECK(n == 10);
+        REQUIRE_THROWS_AS(n *= 10000, std::overflow_error);
+    }
+
+    SECTION("conversions in and out by numeric_cast")
+    {
+        checked<int32_t> a = int16_t(-5);  // lossless, implicit
+        checked<int64_t> b = a;
+        CHECK(b == -5);
+        REQUIRE_THROWS_AS(checked<uint8_t>(300), std::overflow_error);
+        REQUIRE_THROWS_AS(checked<uint32_t>(a), std::underflow_error);
+        CHECK(static_cast<int8_t>(a) == -5);
+        REQUIRE_THROWS_AS(static_cast<uint16_t>(a), std::underflow_error);
+        CHECK(std::numeric_cast<double>(a) == -5.0);
+        REQUIRE_THROWS_AS(std::numeric_cast<uint64_t>(a), std::underflow_error);
+        CHECK(std::numeric_cast<uint8_t, std::overflow_policy::saturate>(a) == 0);
+    }
+
+    SECTION("comparisons by the mathematical value")
+    {
+        CHECK(checked<int32_t>(-1) < 0u);
+        CHECK(checked<uint32_t>(UINT32_MAX) > checked<int32_t>(-1));
+        CHECK(checked<int64_t>(-1) != UINT64_MAX);
+        CHECK(checked<uint8_t>(uint8_t(255)) == 255);
+        CHECK(checked<int8_t>() <= checked<uint8_t>());
+        CHECK(3 >= checked<int16_t>(int16_t(3)));
+    }
+}
+
+TEST_CASE("std::overflow_accumulator sticky flag", "[std::overflow_accumulator]")
+{
+    SECTION("in range")
+    {
+        std::overflow_accumulator overflow;
+        CHECK(overflow.add(INT_MAX - 1, 1) == INT_MAX);
+        CHECK(overflow.sub(INT64_MIN + 1, int64_t(1)) == INT64_MIN);
+        CHECK(overflow.sub(5u, 5u) == 0u);
+        CHECK(overflow.mul<int16_t>(int16_t(-128), int16_t(256)) == INT16_MIN);
+        CHECK(overflow.add<int64_t>(INT_MAX, UINT_MAX) == int64_t(INT_MAX) + UINT_MAX);
+        CHECK(overflow.add<uint8_t>(300, -100) == 200);
+        CHECK(overflow.cast<int16_t>(-32768.0) == INT16_MIN);
+        CHECK(overflow.cast<int32_t>(-2.5) == -2);
+        CHECK(overflow.cast<uint8_t>(255) == 255);
+        CHECK(overflow.cast<float>(-1.0) == -1.0f);
+        CHECK(overflow.cast<float>(0.0) == 0.0f);
+        CHECK(overflow.cast<float>(-3.0e38) == -3.0e38f);
+        CHECK_FALSE(overflow.overflowed());
+        CHECK_FALSE(overflow);
+    }
+
+    SECTION("the flag is sticky, the result is wrapped")
+    {
+        std::overflow_accumulator overflow;
+        CHECK(overflow.add(INT_MAX, 1) == INT_MIN);
+        CHECK(overflow.overflowed());
+        CHECK(overflow.add(1, 2) == 3);
+        CHECK(overflow.overflowed());
+        overflow.clear();
+        CHECK_FALSE(overflow);
+        CHECK(overflow.add(INT64_MAX, int64_t(1)) == INT64_MIN);
+        CHECK(overflow);
+    }
+
+    SECTION("each operation, type and method")
+    {
+        auto fails = [](bool (*f)(std::overflow_accumulator&)) {
+            std::overflow_accumulator overflow;
+            return f(overflow) && overflow.overflowed();
+        };
+        CHECK(fails([](std::overflow_accumulator& o) { return o.add<int8_t>(int8_t(-100), int8_t(-29)) == 127; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.add(UINT64_MAX, uint64_t(1)) == 0; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.sub(INT_MIN, 1) == INT_MAX; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.sub(1u, 2u) == UINT_MAX; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.sub<uint8_t>(0, 1) == 255; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.mul(65536, 32768) == INT_MIN; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.mul(INT64_MIN, int64_t(-1)) == INT64_MIN; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.add<unsigned>(-1, 0u) == UINT_MAX; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.cast<int32_t>(3e9) == 0; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.cast<int16_t>(NAN) == 0; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.cast<int16_t>(-32768.5) == 0; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.cast<uint16_t>(-1) == 0; }));
+        CHECK(fails([](std::overflow_accumulator& o) { return o.cast<float>(-1.0e39) == 0.0f; }));
+    }
+
+    SECTION("a loop checked once, then again to find the bad element")
+    {
+        const int32_t a[] = {1, 2, INT32_MAX, 4};
+        const int32_t b[] = {1, 1, 1, 1};
+        int32_t out[4];
+        std::overflow_accumulator overflow;
+        for (size_t i = 0; i < 4; i++)
+            out[i] = overflow.add(a[i], b[i]);
+        REQUIRE(overflow);
+        size_t bad = 4;
+        for (size_t i = 0; i < 4 && bad == 4; i++)
+        {
+            try
+            {
+                out[i] = std::checked_add(a[i], b[i]);
+            }
+            catch (const std::overflow_error&)
+            {
+                bad = i;
+            }
+        }
+        CHECK(bad == 2);
+        // the second loop stops at the bad element, which keeps the wrapped result of the first
+        CHECK(out[0] == 2);
+        CHECK(out[1] == 3);
+        CHECK(out[2] == INT32_MIN);
+        CHECK(out[3] == 5);
+
+        std::overflow_accumulator chunk;
+        chunk |= overflow;
+        CHECK(chunk.overflowed());
+    }
+}
@@ -0,0 +1,279 @@
+/*
+These tests use a the Catch2 header only c++ test framework: https://github.com/catchorg/Catch2
+*/
+
+#include "../third-party/catch.h"
+
+#include "../checked_arithmetic_bulk.h"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/// the exact sum by long double, which has 64 digits on x86, enough for these tests
+template <typename S>
+long double exact_sum(const std::vector<S>& in)
+{
+    long double sum = 0;
+    for (const S x : in)
+        sum += static_cast<long double>(x);
+    return sum;
+}
+
+template <typename S>
+std::vector<S> make_random_input(size_t n, S lo, S hi)
+{
+    std::mt19937_64 random(n);
+    std::uniform_int_distribution<S> uniform(lo, hi);
+    std::vector<S> in(n);
+    for (S& x : in)
+        x = uniform(random);
+    return in;
+}
+
+TEST_CASE("std::checked_reduce_sum bulk unit test", "[std::checked_reduce_sum]")
+{
+    SECTION("exact sum of any length")
+    {
+        for (size_t n : {0, 1, 7, 8, 15, 16, 17, 100, 1000})
+        {
+            const auto in = make_random_input<int32_t>(n, -1000000, 1000000);
+            CHECK(std::checked_reduce_sum(in.data(), n) == exact_sum(in));
+            const auto in64 = make_random_input<int64_t>(n, INT64_MIN / 2048, INT64_MAX / 2048);
+            CHECK(std::checked_reduce_sum(in64.data(), n) == exact_sum(in64));
+            const auto u = make_random_input<uint16_t>(n, 0, 65535);
+            CHECK(std::checked_reduce_sum<uint64_t>(u.data(), n) == exact_sum(u));
+        }
+    }
+
+    SECTION("the partial sums may be out of range, not the result")
+    {
+        std::vector<int32_t> in(1000, INT32_MAX);
+        for (size_t i = 500; i < 1000; i++)
+            in[i] = -INT32_MAX;
+        CHECK(std::checked_reduce_sum(in.data(), in.size()) == 0);
+        CHECK(std::checked_reduce_sum<int64_t>(in.data(), 500) == int64_t(500) * INT32_MAX);
+        REQUIRE_THROWS_AS(std::checked_reduce_sum(in.data(), 500), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_reduce_sum(in.data() + 500, 500), std::underflow_error);
+
+        std::vector<int64_t> in64(100, INT64_MAX);
+        for (size_t i = 50; i < 100; i++)
+            in64[i] = INT64_MIN + 1;
+        CHECK(std::checked_reduce_sum(in64.data(), in64.size()) == 0);
+        REQUIRE_THROWS_AS(std::checked_reduce_sum(in64.data(), 2), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_reduce_sum(in64.data() + 50, 50), std::underflow_error);
+        CHECK(std::checked_reduce_sum<uint64_t>(in64.data(), 2) == uint64_t(INT64_MAX) * 2);
+        CHECK(std::checked_reduce_sum<double>(in64.data(), 50) == 50 * static_cast<double>(INT64_MAX));
+
+        std::vector<uint64_t> u(20, UINT64_MAX);
+        REQUIRE_THROWS_AS(std::checked_reduce_sum(u.data(), u.size()), std::overflow_error);
+        CHECK(std::checked_reduce_sum(u.data(), 1) == UINT64_MAX);
+    }
+
+    SECTION("overflow policies")
+    {
+        std::vector<int32_t> in(64, -40000);
+        CHECK(std::checked_reduce_sum<int16_t, std::overflow_policy::saturate>(in.data(), in.size()) == INT16_MIN);
+        std::vector<int64_t> in64(64, INT64_MAX);
+        CHECK(std::checked_reduce_sum<int64_t, std::overflow_policy::saturate>(in64.data(), in64.size())
+              == INT64_MAX);
+
+        // INT64_MAX - 2^64, which rounds to INT64_MIN if `long double` is double
+        const int64_t below[] = {INT64_MIN, -1};
+        REQUIRE_THROWS_AS(std::checked_reduce_sum(below, 2), std::underflow_error);
+        CHECK(std::checked_reduce_sum<int64_t, std::overflow_policy::saturate>(below, 2) == INT64_MIN);
+        const std::detail::wide_sum<int64_t> total = {INT64_MAX, -1};
+        CHECK(std::detail::wide_value<int64_t>(total) == -std::ldexp(1.0L, 64));
+    }
+}
+
+TEST_CASE("std::checked_dot bulk unit test", "[std::checked_dot]")
+{
+    SECTION("exact dot product")
+    {
+        for (size_t n : {0, 3, 16, 33, 1000})
+        {
+            const auto a = make_random_input<int32_t>(n, -30000, 30000);
+            const auto b = make_random_input<int32_t>(n + 1, -30000, 30000);
+            long double expected = 0;
+            for (size_t i = 0; i < n; i++)
+                expected += static_cast<long double>(a[i]) * b[i];
+            CHECK(std::checked_dot<int64_t>(a.data(), b.data(), n) == expected);
+        }
+        const int8_t x[] = {100, -100, 127};
+        CHECK(std::checked_dot<int32_t>(x, x, 3) == 100 * 100 * 2 + 127 * 127);
+    }
+
+    SECTION("the products of the limits")
+    {
+        std::vector<int32_t> a(40, INT32_MIN);
+        CHECK(std::checked_dot<int64_t>(a.data(), a.data(), 1) == int64_t(1) << 62);
+        REQUIRE_THROWS_AS(std::checked_dot<int64_t>(a.data(), a.data(), 2), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_dot(a.data(), a.data(), a.size()), std::overflow_error);
+        std::vector<int32_t> b(40, INT32_MAX);
+        for (size_t i = 0; i < 40; i += 2)
+            b[i] = INT32_MIN;
+        // INT32_MIN * INT32_MIN + INT32_MIN * INT32_MAX is 2^31, the partial sum is 2^62
+        CHECK(std::checked_dot<int64_t>(a.data(), b.data(), 2) == int64_t(1) << 31);
+        REQUIRE_THROWS_AS(std::checked_dot(a.data(), b.data(), 2), std::overflow_error);
+        CHECK(std::checked_dot<int64_t>(a.data(), b.data(), a.size()) == int64_t(20) << 31);
+        std::vector<int32_t> c(40, INT32_MAX);
+        REQUIRE_THROWS_AS(std::checked_dot<int64_t>(a.data(), c.data(), c.size()), std::underflow_error);
+        CHECK(std::checked_dot<int64_t>(a.data(), c.data(), 1) == int64_t(INT32_MIN) * INT32_MAX);
+    }
+
+#if defined(__SIZEOF_INT128__)
+    SECTION("64-bit elements, the products in 128 bits")
+    {
+        const int64_t a[] = {INT64_MAX, INT64_MAX, 3};
+        const int64_t b[] = {INT64_MAX, -INT64_MAX, -4};
+        CHECK(std::checked_dot(a, b, 3) == -12);
+        REQUIRE_THROWS_AS(std::checked_dot(a, b, 1), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_dot(a + 1, b + 1, 2), std::underflow_error);
+        const uint64_t u[] = {UINT64_MAX, 1};
+        CHECK(std::checked_dot(u + 1, u, 1) == UINT64_MAX);
+        REQUIRE_THROWS_AS(std::checked_dot(u, u, 2), std::overflow_error);
+    }
+#endif
+
+    SECTION("64-bit elements with the saturate policy")
+    {
+        // the high halves of the products overflow int64_t, 2^127 and more
+        const int64_t m[] = {INT64_MIN, INT64_MIN, INT64_MIN, INT64_MIN, INT64_MIN};
+        const int64_t p[] = {INT64_MIN, INT64_MIN, INT64_MAX, INT64_MAX, 2};
+        CHECK(std::checked_dot<int64_t, std::overflow_policy::saturate>(m, m, 2) == INT64_MAX);
+        CHECK(std::checked_dot<int64_t, std::overflow_policy::saturate>(m, p + 2, 2) == INT64_MIN);
+        REQUIRE_THROWS_AS(std::checked_dot(m, m, 2), std::overflow_error);
+        REQUIRE_THROWS_AS(std::checked_dot(m, p + 2, 2), std::underflow_error);
+        // 2^126 + 2^126 - (2^126 - 2^63) - (2^126 - 2^63) - 2^64 is exact
+        CHECK(std::checked_dot(m, p, 5) == 0);
+        REQUIRE_THROWS_AS(std::checked_dot(m, p, 4), std::overflow_error);  // 2^64
+        const uint64_t u[] = {UINT64_MAX, UINT64_MAX, 3};
+        CHECK(std::checked_dot<uint64_t, std::overflow_policy::saturate>(u, u, 3) == UINT64_MAX);
+        CHECK(std::checked_dot<uint32_t, std::overflow_policy::saturate>(u + 2, u + 2, 1) == 9u);
+        CHECK(std::checked_dot<int8_t, std::overflow_policy::saturate>(u, u, 1) == INT8_MAX);
+    }
+}
+
+TEST_CASE("std::checked_inclusive_scan bulk unit test", "[std::checked_inclusive_scan]")
+{
+    SECTION("prefix sums")
+    {
+        const auto in = make_random_input<int32_t>(1000, -1000, 1000);
+        std::vector<int32_t> out(in.size());
+        CHECK(std::checked_inclusive_scan(in.data(), out.data(), in.size()) == out.data() + out.size());
+        int32_t sum = 0;
+        for (size_t i = 0; i < in.size(); i++)
+        {
+            sum += in[i];
+            REQUIRE(out[i] == sum);
+        }
+        std::vector<int64_t> wide(in.size());
+        std::checked_inclusive_scan<int64_t>(in.data(), wide.data(), in.size());
+        CHECK(wide.back() == sum);
+    }
+
+    SECTION("throws at the first prefix out of range")
+    {
+        std::vector<int16_t> in(600, 100);
+        std::vector<int16_t> out(in.size());
+        REQUIRE_THROWS_AS(std::checked_inclusive_scan(in.data(), out.data(), in.size()), std::overflow_error);
+        CHECK(out[326] == 32700);
+
+        std::vector<int32_t> wide(in.size());
+        std::checked_inclusive_scan<int32_t>(in.data(), wide.data(), in.size());
+        CHECK(wide.back() == 60000);
+        std::checked_inclusive_scan<int16_t, std::overflow_policy::saturate>(in.data(), out.data(), in.size());
+        CHECK(out[326] == 32700);
+        CHECK(out[327] == INT16_MAX);
+        CHECK(out.back() == INT16_MAX);
+    }
+
+    SECTION("in place")
+    {
+        std::vector<int32_t> data = {INT32_MAX, 1, -5};
+        REQUIRE_THROWS_AS(std::checked_inclusive_scan(data.data(), data.data(), data.size()), std::overflow_error);
+        CHECK(data[0] == INT32_MAX);
+
+        data = {INT32_MAX, 1, -5, -10};
+        std::checked_inclusive_scan<int32_t, std::overflow_policy::saturate>(data.data(), data.data(), data.size());
+        CHECK(data == std::vector<int32_t>({INT32_MAX, INT32_MAX, INT32_MAX - 5, INT32_MAX - 15}));
+
+        const auto in = make_random_input<int32_t>(1000, -1000, 1000);
+        std::vector<int32_t> scanned(in.size());
+        std::checked_inclusive_scan(in.data(), scanned.data(), in.size());
+        data = in;
+        std::checked_inclusive_scan(data.data(), data.data(), data.size());
+        CHECK(data == scanned);
+    }
+}
+
+#if __cplusplus > 201703L  && __has_include(<span>)  // C++20
+TEST_CASE("std::checked_reduce_sum span version", "[std::checked_reduce_sum]")
+{
+    std::vector<int32_t> in(100, INT32_MAX);
+    std::vector<int64_t> out(in.size());
+    CHECK(std::checked_reduce_sum<int64_t>(std::span<const int32_t>(in)) == int64_t(100) * INT32_MAX);
+    std::vector<int32_t> small(100, -3);
+    CHECK(std::checked_dot(std::span<int32_t>(small), std::span<int32_t>(small)) == 900);
+    REQUIRE_THROWS_AS(std::checked_dot(std::span<int32_t>(in), std::span<int32_t>(in).first(10)), std::out_of_range);
+    std::checked_inclusive_scan(std::span<const int32_t>(in), std::span<int64_t>(out));
+    CHECK(out.back() == int64_t(100) * INT32_MAX);
+}
+#endif
+
+#if NUMERIC_CAST_DISPATCH
+/// every kernel this CPU can run must agree with the portable one
+template <typename S>
+void check_simd_reduce_kernels(const std::vector<S>& a, const std::vector<S>& b)
+{
+    using namespace std::detail;
+    typedef typename bulk_simd_sum_kernel<S>::sum_fn sum_fn;
+    const sum_fn sum_fns[] = {simd_avx2::reduce_sum, simd_avx512::reduce_sum};
+    const simd_level levels[] = {simd_level::avx2, simd_level::avx512};
+    const wide_sum<int64_t> expected = reduce_sum_generic<S>(a.data(), a.size());
+    for (int l = 0; l < 2 && levels[l] <= cpu_simd_level(); l++)
+    {
+        const wide_sum<int64_t> total = sum_fns[l](a.data(), a.size());
+        REQUIRE(total.sum == expected.sum);
+        REQUIRE(total.wraps == expected.wraps);
+    }
+    (void)b;
+}
+
+template <>
+void check_simd_reduce_kernels<int32_t>(const std::vector<int32_t>& a, const std::vector<int32_t>& b)
+{
+    using namespace std::detail;
+    typedef bulk_simd_dot_kernel<int32_t>::dot_fn dot_fn;
+    typedef bulk_simd_sum_kernel<int32_t>::sum_fn sum_fn;
+    const sum_fn sum_fns[] = {simd_avx2::reduce_sum, simd_avx512::reduce_sum};
+    const dot_fn dot_fns[] = {simd_avx2::reduce_dot, simd_avx512::reduce_dot};
+    const simd_level levels[] = {simd_level::avx2, simd_level::avx512};
+    const wide_sum<int64_t> expected_sum = reduce_sum_generic<int32_t>(a.data(), a.size());
+    const wide_sum<int64_t> expected_dot = reduce_dot_generic<int32_t>(a.data(), b.data(), a.size());
+    for (int l = 0; l < 2 && levels[l] <= cpu_simd_level(); l++)
+    {
+        const wide_sum<int64_t> sum = sum_fns[l](a.data(), a.size());
+        REQUIRE(sum.sum == expected_sum.sum);
+        REQUIRE(sum.wraps == expected_sum.wraps);
+        // the lanes overflow in a different order, only the exact value is the same
+        const wide_sum<int64_t> dot = dot_fns[l](a.data(), b.data(), a.size());
+        REQUIRE(dot.sum == expected_dot.sum);
+        REQUIRE(dot.wraps == expected_dot.wraps);
+    }
+}
+
+TEST_CASE("SIMD reduction kernels of all instruction sets", "[std::checked_reduce_sum]")
+{
+    for (size_t n : {5, 64, 1001})
+    {
+        check_simd_reduce_kernels<int32_t>(make_random_input<int32_t>(n, INT32_MIN, INT32_MAX),
+                                           make_random_input<int32_t>(n + 1, INT32_MIN, INT32_MAX));
+        check_simd_reduce_kernels<int64_t>(make_random_input<int64_t>(n, INT64_MIN, INT64_MAX), {});
+        check_simd_reduce_kernels<int64_t>(std::vector<int64_t>(n, INT64_MIN), {});
+        check_simd_reduce_kernels<int64_t>(std::vector<int64_t>(n, INT64_MAX), {});
+    }
+}
+#endif
@@ -12,7 +12,10 @@ These tests use a the Catch2 header only c++ test framework: https://github.com/
 #endif
 
 #include <cfloat>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 
 TEST_CASE("std::numeric_cast unit test", "[std::numeric_cast]")
@@ -32,4 +35,649 @@ TEST_CASE("std::numeric_cast unit test", "[std::numeric_cast]")
             std::overflow_error);
     }
 
-}
\ No newline at end of file
+}
+
+TEST_CASE("std::numeric_cast floating point to integral boundary", "[std::numeric_cast]")
+{
+    using namespace std;
+    STATIC_REQUIRE(detail::float_int_bounds<int64_t, double>::upper() == 9223372036854774784.0);
+    STATIC_REQUIRE(detail::float_int_bounds<int64_t, double>::limit() == 9223372036854775808.0);
+    STATIC_REQUIRE(detail::float_int_bounds<uint64_t, double>::upper() == 18446744073709549568.0);
+    STATIC_REQUIRE(detail::float_int_bounds<int32_t, float>::upper() == 2147483520.0f);
+    STATIC_REQUIRE(detail::float_int_bounds<int32_t, double>::upper() == 2147483647.0);
+    STATIC_REQUIRE(detail::float_int_bounds<int64_t, float>::lower() == -9223372036854775808.0f);
+    STATIC_REQUIRE(detail::float_int_bounds<uint8_t, float>::lower() == 0.0f);
+
+    SECTION("2^63 to int64_t")
+    {
+        REQUIRE(numeric_cast<int64_t>(9223372036854774784.0) == 9223372036854774784);
+        REQUIRE_THROWS_AS(numeric_cast<int64_t>(9223372036854775808.0), overflow_error);
+        REQUIRE(numeric_cast<int64_t>(-9223372036854775808.0) == INT64_MIN);
+        REQUIRE_THROWS_AS(numeric_cast<int64_t>(-9223372036854777856.0), underflow_error);
+        REQUIRE_THROWS_AS(numeric_cast<uint64_t>(18446744073709551616.0), overflow_error);
+        REQUIRE_FALSE(is_numeric_convertible<int64_t>(9223372036854775808.0));
+        REQUIRE(try_numeric_cast<int64_t>(9223372036854775808.0).error() == numeric_cast_errc::overflow);
+    }
+
+    SECTION("2^31 to int32_t")
+    {
+        REQUIRE(numeric_cast<int32_t>(2147483520.0f) == 2147483520);
+        REQUIRE_THROWS_AS(numeric_cast<int32_t>(2147483648.0f), overflow_error);
+        REQUIRE(numeric_cast<int32_t>(-2147483648.0f) == INT32_MIN);
+        REQUIRE_FALSE(is_numeric_convertible<int32_t>(2147483648.0f));
+    }
+
+    SECTION("double to float, down to lowest()")
+    {
+        REQUIRE(is_numeric_convertible<float>(-1.0));
+        REQUIRE(is_numeric_convertible<float>(0.0));
+        REQUIRE(is_numeric_convertible<float>(-3.0e38));
+        REQUIRE_FALSE(is_numeric_convertible<float>(-1.0e39));
+        REQUIRE_FALSE(is_numeric_convertible<float>(1.0e39));
+        REQUIRE(is_numeric_convertible<float>(-std::numeric_limits<double>::infinity()));
+        REQUIRE(is_numeric_convertible<float>(std::numeric_limits<double>::quiet_NaN()));
+        REQUIRE(numeric_cast<float>(-1.0) == -1.0f);
+    }
+}
+
+TEST_CASE("std::saturate_cast unit test", "[std::saturate_cast]")
+{
+    using namespace std;
+
+    SECTION("integral types")
+    {
+        REQUIRE(saturate_cast<int8_t>(1000) == 127);
+        REQUIRE(saturate_cast<int8_t>(-1000) == -128);
+        REQUIRE(saturate_cast<int8_t>(-5) == -5);
+        REQUIRE(saturate_cast<uint8_t>(-1) == 0);
+        REQUIRE(saturate_cast<uint8_t>(300) == 255);
+        REQUIRE(saturate_cast<uint32_t>(INT64_MIN) == 0u);
+        REQUIRE(saturate_cast<int32_t>(UINT64_MAX) == INT32_MAX);
+        REQUIRE(saturate_cast<int64_t>(UINT64_MAX) == INT64_MAX);
+        REQUIRE(saturate_cast<uint64_t>(INT64_MAX) == uint64_t(INT64_MAX));
+    }
+
+    SECTION("floating point to integral")
+    {
+        REQUIRE(saturate_cast<int32_t>(1e10) == INT32_MAX);
+        REQUIRE(saturate_cast<int32_t>(-1e10) == INT32_MIN);
+        REQUIRE(saturate_cast<int32_t>(2147483647.0) == INT32_MAX);
+        REQUIRE(saturate_cast<int32_t>(-2147483648.0) == INT32_MIN);
+        REQUIRE(saturate_cast<int32_t>(-2.7) == -2);
+        REQUIRE(saturate_cast<int32_t>(2147483648.0f) == INT32_MAX);
+        REQUIRE(saturate_cast<int32_t>(2147483520.0f) == 2147483520);
+        REQUIRE(saturate_cast<int64_t>(9.3e18) == INT64_MAX);
+        REQUIRE(saturate_cast<int64_t>(9223372036854774784.0) == 9223372036854774784);
+        REQUIRE(saturate_cast<int64_t>(-1e19) == INT64_MIN);
+        REQUIRE(saturate_cast<uint8_t>(-0.5f) == 0);
+        REQUIRE(saturate_cast<uint8_t>(255.9) == 255);
+        REQUIRE(saturate_cast<uint64_t>(1e20) == UINT64_MAX);
+        REQUIRE(saturate_cast<uint64_t>(-1.0) == 0u);
+        REQUIRE(saturate_cast<int16_t>(numeric_limits<double>::infinity()) == INT16_MAX);
+        REQUIRE(saturate_cast<int16_t>(-numeric_limits<float>::infinity()) == INT16_MIN);
+    }
+
+    SECTION("NaN")
+    {
+        const double nan = numeric_limits<double>::quiet_NaN();
+        REQUIRE(saturate_cast<int32_t>(nan) == 0);
+        REQUIRE(saturate_cast<int32_t>(nan, -1) == -1);
+        REQUIRE(saturate_cast<int64_t>(nan, INT64_MIN) == INT64_MIN);
+        REQUIRE(saturate_cast<uint64_t>(nan, uint64_t(7)) == 7u);
+        REQUIRE(std::isnan(saturate_cast<float>(nan)));
+        REQUIRE(saturate_cast<float>(nan, 0.0f) == 0.0f);
+    }
+
+    SECTION("floating point to floating point")
+    {
+        REQUIRE(saturate_cast<float>(1e300) == FLT_MAX);
+        REQUIRE(saturate_cast<float>(-1e300) == -FLT_MAX);
+        REQUIRE(saturate_cast<float>(0.5) == 0.5f);
+        REQUIRE(saturate_cast<double>(INT64_MAX) == 9223372036854775807.0);
+        REQUIRE(saturate_cast<float>(numeric_limits<double>::infinity()) == numeric_limits<float>::infinity());
+        REQUIRE(saturate_cast<float>(-numeric_limits<double>::infinity()) == -numeric_limits<float>::infinity());
+        REQUIRE((numeric_cast<float, overflow_policy::saturate>(numeric_limits<double>::infinity()))
+                == numeric_limits<float>::infinity());
+    }
+}
+
+/// half opts in to the value text of the message
+namespace std {
+    template <>
+    struct numeric_value_formattable<half_float::half> : std::true_type {};
+}
+
+TEST_CASE("std::numeric_cast_error exceptions", "[std::numeric_cast_error]")
+{
+    using namespace std;
+    STATIC_REQUIRE(is_base_of<overflow_error, numeric_overflow_error>::value);
+    STATIC_REQUIRE(is_base_of<underflow_error, numeric_underflow_error>::value);
+    STATIC_REQUIRE(is_base_of<range_error, numeric_range_error>::value);
+    STATIC_REQUIRE(is_base_of<numeric_cast_error, numeric_overflow_error>::value);
+
+    SECTION("details of the failure")
+    {
+        try
+        {
+            numeric_cast<int32_t>(1e10);
+            FAIL("no exception");
+        }
+        catch (const numeric_overflow_error& e)
+        {
+            REQUIRE(e.kind() == numeric_cast_errc::overflow);
+            REQUIRE(string(e.source_type()) == "double");
+            REQUIRE(string(e.target_type()) == "int");
+            REQUIRE(string(e.value()) == "10000000000");
+            REQUIRE(string(e.what()) == "numeric_cast: double 10000000000 overflows int");
+        }
+
+        try
+        {
+            to_unsigned<uint16_t>(int64_t(-7));
+            FAIL("no exception");
+        }
+        catch (const numeric_cast_error& e)
+        {
+            REQUIRE(e.kind() == numeric_cast_errc::underflow);
+            REQUIRE(string(e.message())
+                    == string("numeric_cast: ") + numeric_type_name<int64_t>::name() + " -7 underflows unsigned short");
+        }
+
+        REQUIRE_THROWS_WITH(numeric_cast<uint8_t>(numeric_limits<float>::quiet_NaN()),
+                            "numeric_cast: float nan can not be converted to unsigned char");
+        REQUIRE_THROWS_WITH((numeric_cast<int, round_policy::exact>(2.5)),
+                            "numeric_cast: double 2.5 is not an integer");
+        REQUIRE_THROWS_WITH(to_integer<int8_t>(UINT64_MAX), string("numeric_cast: ")
+                            + numeric_type_name<uint64_t>::name() + " 18446744073709551615 overflows signed char");
+        REQUIRE_THROWS_WITH(try_numeric_cast<int8_t>(1000).value(),
+                            "numeric_cast: input value overflows signed char");
+        REQUIRE_THROWS_AS(numeric_cast<int8_t>(half_float::half{1000}), numeric_overflow_error);
+        REQUIRE_THROWS_WITH(numeric_cast<int8_t>(half_float::half{1000}),
+                            "numeric_cast: non-builtin type 1000 overflows signed char");
+        STATIC_REQUIRE(!numeric_value_formattable<std::string>::value);
+    }
+
+    SECTION("compile time type names")
+    {
+        STATIC_REQUIRE(numeric_type_name<int16_t>::name()[0] == 's');
+        STATIC_REQUIRE(numeric_type_name<half_float::half>::name()[0] == 'n');
+    }
+}
+
+/// records the last out-of-range value and gives a sentinel
+struct record_overflow
+{
+    static double last;
+
+    template <typename T, typename S>
+    static T on_overflow(const S value)
+    {
+        last = static_cast<double>(value);
+        return T(42);
+    }
+
+    template <typename T, typename S>
+    static T on_underflow(const S value)
+    {
+        last = static_cast<double>(value);
+        return T(-42);
+    }
+};
+double record_overflow::last = 0;
+
+/// the failure handler of `overflow_policy::report`
+std::numeric_cast_errc reported_kind = std::numeric_cast_errc::ok;
+void record_failure(const std::numeric_cast_failure_info& failure)
+{
+    reported_kind = failure.kind();
+}
+
+TEST_CASE("std::numeric_cast overflow policies", "[std::overflow_policy]")
+{
+    using namespace std;
+
+    SECTION("throw_on_overflow is the default")
+    {
+        REQUIRE_THROWS_AS((numeric_cast<int8_t, overflow_policy::throw_on_overflow>(1000)), overflow_error);
+        REQUIRE_THROWS_AS((numeric_cast<int8_t, overflow_policy::throw_on_overflow>(-1000)), underflow_error);
+        REQUIRE((numeric_cast<int8_t, overflow_policy::throw_on_overflow>(100)) == 100);
+        REQUIRE_THROWS_AS((to_unsigned<uint8_t, overflow_policy::throw_on_overflow>(1000)), overflow_error);
+    }
+
+    SECTION("saturate")
+    {
+        REQUIRE((numeric_cast<int8_t, overflow_policy::saturate>(1000)) == 127);
+        REQUIRE((numeric_cast<int8_t, overflow_policy::saturate>(-1000.0)) == -128);
+        REQUIRE((to_unsigned<uint32_t, overflow_policy::saturate>(-1)) == 0u);
+        REQUIRE((to_integer<int16_t, overflow_policy::saturate>(numeric_limits<double>::quiet_NaN())) == 0);
+    }
+
+    SECTION("wrap")
+    {
+        REQUIRE((numeric_cast<uint8_t, overflow_policy::wrap>(257)) == 1);
+        REQUIRE((numeric_cast<int8_t, overflow_policy::wrap>(128)) == -128);
+        REQUIRE((to_unsigned<uint32_t, overflow_policy::wrap>(-1)) == UINT32_MAX);
+        REQUIRE((to_integer<uint8_t, overflow_policy::wrap>(258.9)) == 2);
+        REQUIRE((to_integer<uint32_t, overflow_policy::wrap>(-1.0)) == UINT32_MAX);
+        REQUIRE((to_integer<uint64_t, overflow_policy::wrap>(1e19)) == 10000000000000000000ull);
+        REQUIRE((to_integer<uint64_t, overflow_policy::wrap>(-1.0)) == UINT64_MAX);
+        REQUIRE((to_integer<uint64_t, overflow_policy::wrap>(-2.5)) == UINT64_MAX - 1);
+        REQUIRE((to_integer<uint64_t, overflow_policy::wrap>(-1e19)) == 8446744073709551616ull);
+        REQUIRE((to_integer<uint64_t, overflow_policy::wrap>(-0.0)) == 0);
+        REQUIRE((numeric_cast<float, overflow_policy::wrap>(0.5)) == 0.5f);
+    }
+
+    SECTION("terminate and assume_in_range in range")
+    {
+        REQUIRE((numeric_cast<int8_t, overflow_policy::terminate>(-128)) == -128);
+        REQUIRE((to_unsigned<uint16_t, overflow_policy::terminate>(65535.0)) == 65535);
+        REQUIRE((numeric_cast<int16_t, overflow_policy::assume_in_range>(-300)) == -300);
+        REQUIRE((to_unsigned<size_t, overflow_policy::assume_in_range>(7)) == 7u);
+    }
+
+    SECTION("user_callback")
+    {
+        typedef overflow_policy::user_callback<record_overflow> policy;
+        REQUIRE((numeric_cast<int8_t, policy>(1000)) == 42);
+        REQUIRE(record_overflow::last == 1000);
+        REQUIRE((numeric_cast<int8_t, policy>(-1000.5)) == -42);
+        REQUIRE(record_overflow::last == -1000.5);
+        REQUIRE((numeric_cast<int8_t, policy>(5)) == 5);
+        REQUIRE((numeric_cast<int8_t, policy>(numeric_limits<double>::quiet_NaN())) == 42);
+        // mixed sign is compared by value, not by the usual arithmetic conversion
+        REQUIRE((to_unsigned<uint32_t, policy>(-1)) == uint32_t(-42));
+        REQUIRE((numeric_cast<int32_t, policy>(UINT32_MAX)) == 42);
+        REQUIRE((numeric_cast<uint64_t, policy>(INT64_MAX)) == uint64_t(INT64_MAX));
+    }
+
+    SECTION("report to the failure handler")
+    {
+        const numeric_cast_failure_handler previous = set_numeric_cast_failure_handler(record_failure);
+        REQUIRE((numeric_cast<int8_t, overflow_policy::report>(1000)) == 127);
+        REQUIRE(reported_kind == numeric_cast_errc::overflow);
+        REQUIRE((to_unsigned<uint16_t, overflow_policy::report>(-1.5)) == 0);
+        REQUIRE(reported_kind == numeric_cast_errc::underflow);
+        REQUIRE((numeric_cast<int16_t, overflow_policy::report>(numeric_limits<float>::quiet_NaN())) == 0);
+        REQUIRE(reported_kind == numeric_cast_errc::nan);
+        // the default numeric_cast<T>() still throws
+        REQUIRE_THROWS_AS(numeric_cast<int8_t>(1000), overflow_error);
+        REQUIRE(set_numeric_cast_failure_handler(previous) == &record_failure);
+    }
+}
+
+TEST_CASE("std::numeric_cast rounding policies", "[std::round_policy]")
+{
+    using namespace std;
+
+    SECTION("rounding before conversion")
+    {
+        REQUIRE((numeric_cast<int, round_policy::truncate>(-2.7)) == -2);
+        REQUIRE((numeric_cast<int, round_policy::floor>(-2.3)) == -3);
+        REQUIRE((numeric_cast<int, round_policy::ceil>(-2.7)) == -2);
+        REQUIRE((numeric_cast<int, round_policy::ceil>(2.1f)) == 3);
+        REQUIRE((numeric_cast<int, round_policy::nearest_even>(2.5)) == 2);
+        REQUIRE((numeric_cast<int, round_policy::nearest_even>(3.5)) == 4);
+        REQUIRE((numeric_cast<int, round_policy::nearest_even>(-2.5)) == -2);
+        REQUIRE((numeric_cast<int, round_policy::nearest_away>(2.5)) == 3);
+        REQUIRE((numeric_cast<int, round_policy::nearest_away>(-2.5)) == -3);
+        REQUIRE((numeric_cast<int, round_policy::nearest_away>(0.49999999999999994)) == 0);
+        REQUIRE((numeric_cast<int64_t, round_policy::nearest_away>(4503599627370495.5)) == 4503599627370496);
+    }
+
+    SECTION("the range is checked on the rounded value")
+    {
+        REQUIRE((numeric_cast<int32_t, round_policy::truncate>(2147483647.9)) == INT32_MAX);
+        REQUIRE((numeric_cast<int32_t, round_policy::floor>(-2147483648.0)) == INT32_MIN);
+        REQUIRE((numeric_cast<int32_t, round_policy::ceil>(-2147483648.9)) == INT32_MIN);
+        REQUIRE_THROWS_AS((numeric_cast<int32_t, round_policy::nearest_even>(2147483647.5)), overflow_error);
+        REQUIRE((numeric_cast<int32_t, round_policy::nearest_even>(-2147483648.5)) == INT32_MIN);
+        REQUIRE_THROWS_AS((numeric_cast<int32_t, round_policy::floor>(-2147483648.1)), underflow_error);
+        REQUIRE((to_unsigned<uint8_t, round_policy::nearest_away>(-0.4)) == 0);
+        REQUIRE((to_integer<uint8_t, round_policy::ceil>(254.5)) == 255);
+    }
+
+    SECTION("combined with an overflow policy, in any order")
+    {
+        REQUIRE((numeric_cast<int8_t, round_policy::nearest_even, overflow_policy::saturate>(127.5)) == 127);
+        REQUIRE((numeric_cast<int8_t, overflow_policy::wrap, round_policy::ceil>(127.5)) == -128);
+        REQUIRE((to_integer<int16_t, round_policy::floor, overflow_policy::saturate>(-1e9)) == INT16_MIN);
+        REQUIRE((numeric_cast<int8_t, round_policy::floor>(100)) == 100);
+    }
+
+    SECTION("a value which is not an integer is handled by the overflow policy")
+    {
+        REQUIRE((numeric_cast<int, round_policy::exact, overflow_policy::saturate>(1.5)) == 1);
+        REQUIRE((numeric_cast<int8_t, round_policy::exact, overflow_policy::saturate>(-1000.5)) == INT8_MIN);
+        REQUIRE((numeric_cast<int, overflow_policy::wrap, round_policy::exact>(-1.5)) == -1);
+        REQUIRE((numeric_cast<int, round_policy::exact, overflow_policy::assume_in_range>(2.5)) == 2);
+        REQUIRE((numeric_cast<int, round_policy::exact, overflow_policy::saturate>(3.0)) == 3);
+        REQUIRE_THROWS_AS((numeric_cast<int, round_policy::exact, overflow_policy::throw_on_overflow>(1.5)), range_error);
+        REQUIRE((to_integer<int16_t, round_policy::exact, overflow_policy::user_callback<record_overflow>>(1.5)) == 42);
+        REQUIRE(record_overflow::last == 1.5);
+
+        const numeric_cast_failure_handler previous = set_numeric_cast_failure_handler(record_failure);
+        REQUIRE((numeric_cast<int8_t, round_policy::exact, overflow_policy::report>(-2.5)) == -2);
+        REQUIRE(reported_kind == numeric_cast_errc::inexact);
+        set_numeric_cast_failure_handler(previous);
+    }
+
+    SECTION("user-defined type, half_float::half")
+    {
+        using namespace half_float;
+        REQUIRE((numeric_cast<int8_t, round_policy::nearest_away>(half{2.5f})) == 3);
+        REQUIRE((numeric_cast<int8_t, round_policy::floor>(half{-2.5f})) == -3);
+    }
+}
+
+enum class color : int16_t { red = 1, green = 2 };
+
+TEST_CASE("std::numeric_cast NaN policies", "[std::nan_policy]")
+{
+    using namespace std;
+    const double nan = numeric_limits<double>::quiet_NaN();
+    const double inf = numeric_limits<double>::infinity();
+
+    SECTION("as_overflow is the default")
+    {
+        REQUIRE_THROWS_AS(numeric_cast<int32_t>(nan), range_error);
+        REQUIRE_THROWS_AS((numeric_cast<int32_t, nan_policy::as_overflow>(nan)), range_error);
+        REQUIRE((numeric_cast<int32_t, overflow_policy::saturate>(nan)) == 0);
+        REQUIRE(try_numeric_cast<int32_t>(nan).error() == numeric_cast_errc::nan);
+        REQUIRE(std::isnan(numeric_cast<float>(nan)));
+    }
+
+    SECTION("infinity is out of range")
+    {
+        REQUIRE_THROWS_AS(numeric_cast<int32_t>(inf), overflow_error);
+        REQUIRE_THROWS_AS(numeric_cast<int32_t>(-inf), underflow_error);
+        REQUIRE(try_numeric_cast<int64_t>(-inf).error() == numeric_cast_errc::underflow);
+        REQUIRE_THROWS_AS((numeric_cast<int32_t, nan_policy::to_zero>(inf)), overflow_error);
+        REQUIRE((numeric_cast<int32_t, nan_policy::to_zero, overflow_policy::saturate>(-inf)) == INT32_MIN);
+        REQUIRE(numeric_cast<float>(inf) == numeric_limits<float>::infinity());
+    }
+
+    SECTION("mapped NaN")
+    {
+        REQUIRE((numeric_cast<int32_t, nan_policy::to_zero>(nan)) == 0);
+        REQUIRE((numeric_cast<int32_t, nan_policy::to_lowest>(nan)) == INT32_MIN);
+        REQUIRE((numeric_cast<uint8_t, nan_policy::to_max>(nanf(""))) == 255);
+        REQUIRE((numeric_cast<int16_t, overflow_policy::saturate, nan_policy::to_max>(nan)) == INT16_MAX);
+        REQUIRE((to_integer<int32_t, round_policy::nearest_even, nan_policy::to_zero>(nan)) == 0);
+        REQUIRE((to_integer<int32_t, round_policy::nearest_even, nan_policy::to_zero>(2.5)) == 2);
+        REQUIRE((to_unsigned<uint16_t, nan_policy::to_lowest>(-nan)) == 0);
+        REQUIRE((numeric_cast<int8_t, nan_policy::to_zero>(100)) == 100);
+        REQUIRE_THROWS_AS((numeric_cast<int8_t, nan_policy::to_zero>(1000)), overflow_error);
+    }
+}
+
+TEST_CASE("std::try_numeric_cast unit test", "[std::try_numeric_cast]")
+{
+    using namespace std;
+
+    SECTION("value or error")
+    {
+        const auto ok = try_numeric_cast<int8_t>(100);
+        REQUIRE(ok);
+        REQUIRE(ok.has_value());
+        REQUIRE(*ok == 100);
+        REQUIRE(ok.value() == 100);
+        REQUIRE(ok.error() == numeric_cast_errc::ok);
+
+        const auto over = try_numeric_cast<int8_t>(1000);
+        REQUIRE(!over);
+        REQUIRE(over.error() == numeric_cast_errc::overflow);
+        REQUIRE(over.value_or(-1) == -1);
+        REQUIRE_THROWS_AS(over.value(), overflow_error);
+
+        REQUIRE(try_numeric_cast<int8_t>(-1000.0).error() == numeric_cast_errc::underflow);
+        REQUIRE(try_numeric_cast<int32_t>(numeric_limits<double>::quiet_NaN()).error() == numeric_cast_errc::nan);
+        REQUIRE(isnan(*try_numeric_cast<float>(numeric_limits<double>::quiet_NaN())));
+        REQUIRE(try_numeric_cast<float>(-1.0).value() == -1.0f);
+        REQUIRE(try_numeric_cast<float>(-1e300).error() == numeric_cast_errc::underflow);
+    }
+
+    SECTION("mixed sign")
+    {
+        REQUIRE(try_numeric_cast<uint32_t>(-1).error() == numeric_cast_errc::underflow);
+        REQUIRE(try_numeric_cast<int32_t>(UINT32_MAX).error() == numeric_cast_errc::overflow);
+        REQUIRE(try_numeric_cast<uint64_t>(INT64_MAX).value() == uint64_t(INT64_MAX));
+        REQUIRE(try_to_unsigned<uint8_t>(-0.5).error() == numeric_cast_errc::underflow);  // checked before truncation
+        REQUIRE(try_to_unsigned<uint8_t>(-1).error() == numeric_cast_errc::underflow);
+    }
+
+    SECTION("exact rounding policy")
+    {
+        REQUIRE((try_numeric_cast<int, round_policy::exact>(2.5)).error() == numeric_cast_errc::inexact);
+        REQUIRE((try_numeric_cast<int, round_policy::exact>(-3.0)).value() == -3);
+        REQUIRE((try_numeric_cast<int, round_policy::exact>(1e10)).error() == numeric_cast_errc::overflow);
+        REQUIRE((try_to_integer<int8_t, round_policy::nearest_even>(126.5)).value() == 126);
+        REQUIRE((try_to_unsigned<uint8_t, round_policy::floor>(-0.5)).error() == numeric_cast_errc::underflow);
+        REQUIRE_THROWS_AS((numeric_cast<int, round_policy::exact>(0.1)), range_error);
+        REQUIRE((numeric_cast<int, round_policy::exact>(7.0f)) == 7);
+    }
+
+    SECTION("enum")
+    {
+        REQUIRE(try_to_enum<color>(2).value() == color::green);
+        REQUIRE(try_to_enum<color>(70000).error() == numeric_cast_errc::overflow);
+        REQUIRE(try_to_integer<int8_t>(color::red).value() == 1);
+        REQUIRE(try_to_unsigned<uint8_t>(color::green).value() == 2);
+        REQUIRE(to_integer<int8_t>(color::green) == 2);
+        REQUIRE_THROWS_AS(to_enum<color>(-40000), underflow_error);
+    }
+
+    SECTION("the throwing API reports NaN")
+    {
+        REQUIRE_THROWS_AS(numeric_cast<int>(numeric_limits<double>::quiet_NaN()), range_error);
+        REQUIRE_THROWS_AS(to_unsigned<unsigned>(-1), underflow_error);
+        // a signed target type still rejects a negative value, the source type differs from
+        // the target type, `to_unsigned<int>(int)` is ambiguous with `std::byte to_unsigned<S>()` since C++17
+        REQUIRE_THROWS_AS(to_unsigned<int>(-1L), underflow_error);
+        REQUIRE_THROWS_AS(to_unsigned<int64_t>(-0.5), underflow_error);
+        REQUIRE_THROWS_AS(to_unsigned<int8_t>(1000), overflow_error);
+        REQUIRE(to_unsigned<int>(7L) == 7);
+        REQUIRE(to_unsigned<int16_t>(color::green) == 2);
+        REQUIRE_THROWS_AS(to_unsigned<int>(static_cast<color>(-3)), underflow_error);
+    }
+
+    SECTION("try_to_unsigned and the policies to a signed target type")
+    {
+        REQUIRE(try_to_unsigned<int64_t>(-1).error() == numeric_cast_errc::underflow);
+        REQUIRE(try_to_unsigned<int64_t>(-0.5).error() == numeric_cast_errc::underflow);
+        REQUIRE(try_to_unsigned<int8_t>(1000).error() == numeric_cast_errc::overflow);
+        REQUIRE(try_to_unsigned<int64_t>(7).value() == 7);
+        REQUIRE(try_to_unsigned<int16_t>(static_cast<color>(-3)).error() == numeric_cast_errc::underflow);
+        REQUIRE((try_to_unsigned<int32_t, round_policy::floor>(-0.5)).error() == numeric_cast_errc::underflow);
+        REQUIRE((try_to_unsigned<int32_t, round_policy::nearest_away>(-0.4)).value() == 0);
+        REQUIRE((to_unsigned<int64_t, overflow_policy::saturate>(-1)) == 0);
+        REQUIRE((to_unsigned<int8_t, overflow_policy::saturate>(1000)) == INT8_MAX);
+        REQUIRE((to_unsigned<int32_t, overflow_policy::saturate>(-2.5)) == 0);
+        REQUIRE((to_unsigned<int32_t, overflow_policy::wrap>(-1L)) == -1);
+        REQUIRE_THROWS_AS((to_unsigned<int64_t, overflow_policy::throw_on_overflow>(-1)), underflow_error);
+        REQUIRE((to_unsigned<int64_t, overflow_policy::saturate>(INT64_MAX)) == INT64_MAX);
+    }
+}
+
+TEST_CASE("std::conversion_kind classification", "[std::conversion_kind]")
+{
+    using namespace std;
+    STATIC_REQUIRE(conversion_kind<int64_t, int32_t>::value == conversion_category::lossless);
+    STATIC_REQUIRE(conversion_kind<double, uint8_t>::value == conversion_category::lossless);
+    STATIC_REQUIRE(conversion_kind<double, float>::value == conversion_category::lossless);
+    STATIC_REQUIRE(conversion_kind<int64_t, uint32_t>::value == conversion_category::lossless);
+    STATIC_REQUIRE(conversion_kind<int32_t, uint32_t>::value == conversion_category::upper_check);
+    STATIC_REQUIRE(conversion_kind<uint16_t, uint32_t>::value == conversion_category::upper_check);
+    STATIC_REQUIRE(conversion_kind<uint32_t, int32_t>::value == conversion_category::lower_check);
+    STATIC_REQUIRE(conversion_kind<uint64_t, int8_t>::value == conversion_category::lower_check);
+    STATIC_REQUIRE(conversion_kind<uint16_t, int32_t>::value == conversion_category::sign_change);
+    STATIC_REQUIRE(conversion_kind<int16_t, int32_t>::value == conversion_category::both_checks);
+    STATIC_REQUIRE(conversion_kind<int32_t, double>::value == conversion_category::both_checks);
+    STATIC_REQUIRE(conversion_kind<float, double>::value == conversion_category::both_checks);
+    STATIC_REQUIRE(conversion_kind<double, int64_t>::value == conversion_category::precision_loss);
+    STATIC_REQUIRE(conversion_kind<float, int32_t>::value == conversion_category::precision_loss);
+    STATIC_REQUIRE(conversion_kind<int8_t, half_float::half>::value == conversion_category::both_checks);
+    STATIC_REQUIRE(conversion_kind<half_float::half, int8_t>::value == conversion_category::lossless);
+#if defined(__SIZEOF_INT128__)
+    // 2^128 - 1 rounds to 2^128, above the max of float
+    STATIC_REQUIRE(conversion_kind<float, unsigned __int128>::value == conversion_category::both_checks);
+    STATIC_REQUIRE(conversion_kind<float, __int128>::value == conversion_category::precision_loss);
+    REQUIRE_THROWS_AS(numeric_cast<float>(~(unsigned __int128)0), overflow_error);
+    REQUIRE(numeric_cast<float>(((unsigned __int128)0xFFFFFF) << 104) == FLT_MAX);
+#endif
+
+    // the result of each category
+    REQUIRE(numeric_cast<int64_t>(INT32_MIN) == INT32_MIN);
+    REQUIRE(numeric_cast<double>(INT64_MAX) == 9223372036854775807.0);
+    REQUIRE_THROWS_AS(numeric_cast<uint16_t>(UINT32_MAX), overflow_error);
+    REQUIRE_THROWS_AS(numeric_cast<uint64_t>(int8_t(-1)), underflow_error);
+    REQUIRE_THROWS_AS(numeric_cast<uint16_t>(-1), underflow_error);
+    REQUIRE_THROWS_AS(numeric_cast<uint16_t>(65536), overflow_error);
+    REQUIRE(numeric_cast<uint16_t>(65535) == 65535);
+    REQUIRE(is_numeric_convertible<int64_t>(INT32_MAX));
+}
+
+/// boundary values of S around the limits of T and zero
+template <typename T, typename S>
+std::vector<S> integral_boundaries()
+{
+    std::vector<S> values = {std::numeric_limits<S>::min(), std::numeric_limits<S>::max(), S(0), S(1)};
+    if (std::is_signed<S>::value)
+        values.push_back(static_cast<S>(-1));
+    const S t_min = std::detail::cmp_less(std::numeric_limits<T>::min(), std::numeric_limits<S>::min())
+        ? std::numeric_limits<S>::min() : static_cast<S>(std::numeric_limits<T>::min());
+    const S t_max = std::detail::cmp_greater(std::numeric_limits<T>::max(), std::numeric_limits<S>::max())
+        ? std::numeric_limits<S>::max() : static_cast<S>(std::numeric_limits<T>::max());
+    for (S v : {t_min, t_max})
+    {
+        values.push_back(v);
+        if (v != std::numeric_limits<S>::min())
+            values.push_back(static_cast<S>(v - 1));
+        if (v != std::numeric_limits<S>::max())
+            values.push_back(static_cast<S>(v + 1));
+    }
+    return values;
+}
+
+/// the single compare of the integral engine agrees with cmp_less/cmp_greater
+template <typename T, typename S>
+void check_integral_engine()
+{
+    using namespace std;
+    for (S v : integral_boundaries<T, S>())
+    {
+        INFO("value " << static_cast<long long>(v) << " " << static_cast<unsigned long long>(v));
+        const bool below = detail::cmp_less(v, numeric_limits<T>::min());
+        const bool above = detail::cmp_greater(v, numeric_limits<T>::max());
+        REQUIRE(detail::in_integral_range<T>(v) == (!below && !above));
+        REQUIRE(is_numeric_convertible<T>(v) == (!below && !above));
+        const numeric_cast_result<T> r = try_numeric_cast<T>(v);
+        REQUIRE(r.error() == (below ? numeric_cast_errc::underflow
+                              : above ? numeric_cast_errc::overflow : numeric_cast_errc::ok));
+        if (r)
+            REQUIRE((!detail::cmp_less(*r, v) && !detail::cmp_greater(*r, v)));
+    }
+}
+
+template <typename S>
+void check_integral_engine_from()
+{
+    check_integral_engine<int8_t, S>();
+    check_integral_engine<uint8_t, S>();
+    check_integral_engine<int16_t, S>();
+    check_integral_engine<uint16_t, S>();
+    check_integral_engine<int32_t, S>();
+    check_integral_engine<uint32_t, S>();
+    check_integral_engine<int64_t, S>();
+    check_integral_engine<uint64_t, S>();
+}
+
+TEST_CASE("sign-correct integral conversion", "[std::numeric_cast]")
+{
+    using namespace std;
+    STATIC_REQUIRE(detail::cmp_less(-1, 0u));
+    STATIC_REQUIRE(!detail::cmp_greater(-1, 0u));
+    STATIC_REQUIRE(detail::cmp_greater(UINT64_MAX, INT64_MAX));
+    STATIC_REQUIRE(detail::cmp_less(INT64_MIN, uint8_t(0)));
+    STATIC_REQUIRE(!detail::in_integral_range<uint32_t>(int64_t(-1)));
+    STATIC_REQUIRE(detail::in_integral_range<uint32_t>(int64_t(UINT32_MAX)));
+    STATIC_REQUIRE(!detail::in_integral_range<int8_t>(short(128)));
+    STATIC_REQUIRE(detail::in_integral_range<int8_t>(short(-128)));
+
+    REQUIRE_FALSE(is_numeric_convertible<uint64_t>(-1));
+    REQUIRE_FALSE(is_numeric_convertible<uint32_t>(int64_t(-1)));
+    REQUIRE_THROWS_AS(numeric_cast<uint32_t>(-1), underflow_error);
+    REQUIRE_THROWS_AS(numeric_cast<uint32_t>(int64_t(-1)), underflow_error);
+    REQUIRE_THROWS_AS(numeric_cast<uint32_t>(int64_t(UINT32_MAX) + 1), overflow_error);
+
+    check_integral_engine_from<int8_t>();
+    check_integral_engine_from<uint8_t>();
+    check_integral_engine_from<int16_t>();
+    check_integral_engine_from<uint16_t>();
+    check_integral_engine_from<int32_t>();
+    check_integral_engine_from<uint32_t>();
+    check_integral_engine_from<int64_t>();
+    check_integral_engine_from<uint64_t>();
+}
+
+TEST_CASE("C++11 cmp_less, cmp_equal and in_range", "[std::cmp_less]")
+{
+    using namespace std;
+    STATIC_REQUIRE(cmp_less(-1, 0u));
+    STATIC_REQUIRE(!cmp_greater(-1, 0u));
+    STATIC_REQUIRE(cmp_less_equal(INT64_MIN, uint8_t(0)));
+    STATIC_REQUIRE(cmp_greater_equal(UINT64_MAX, INT64_MAX));
+    STATIC_REQUIRE(!cmp_equal(-1, UINT32_MAX));
+    STATIC_REQUIRE(cmp_not_equal(-1, UINT32_MAX));
+    STATIC_REQUIRE(cmp_equal(int8_t(5), 5ull));
+    STATIC_REQUIRE(cmp_equal(4000000000u, int64_t(4000000000)));
+    STATIC_REQUIRE(cmp_less_equal(7, 7u));
+    STATIC_REQUIRE(!cmp_less(7u, 7));
+
+    STATIC_REQUIRE(in_range<uint8_t>(255));
+    STATIC_REQUIRE(!in_range<uint8_t>(256));
+    STATIC_REQUIRE(!in_range<uint64_t>(-1));
+    STATIC_REQUIRE(in_range<int32_t>(uint64_t(INT32_MAX)));
+    STATIC_REQUIRE(!in_range<int32_t>(uint64_t(INT32_MAX) + 1));
+    STATIC_REQUIRE(in_range<int16_t>(int64_t(INT16_MIN)));
+
+    const int64_t values[] = {INT64_MIN, INT32_MIN, -129, -1, 0, 1, 127, 255, 65535, INT32_MAX, UINT32_MAX, INT64_MAX};
+    for (int64_t a : values)
+    {
+        for (int64_t b : values)
+        {
+            REQUIRE(cmp_less(a, b) == (a < b));
+            REQUIRE(cmp_equal(a, b) == (a == b));
+            if (b >= 0)
+            {
+                REQUIRE(cmp_less(a, uint64_t(b)) == (a < b));
+                REQUIRE(cmp_greater(uint64_t(b), a) == (a < b));
+                REQUIRE(cmp_equal(uint64_t(b), a) == (a == b));
+            }
+        }
+        REQUIRE(in_range<int8_t>(a) == (a >= INT8_MIN && a <= INT8_MAX));
+        REQUIRE(in_range<uint32_t>(a) == (a >= 0 && a <= int64_t(UINT32_MAX)));
+    }
+}
+
+/// a table generated at compile time, a range violation would be a compile error
+constexpr int16_t constexpr_table[] = {std::numeric_cast<int16_t>(1000), std::to_integer<int16_t>(-32768L),
+                                       std::numeric_cast<int16_t>(12.75), std::to_unsigned<uint8_t>(255)};
+
+TEST_CASE("constexpr numeric_cast in C++11", "[std::numeric_cast]")
+{
+    using namespace std;
+    STATIC_REQUIRE(constexpr_table[0] == 1000);
+    STATIC_REQUIRE(constexpr_table[1] == INT16_MIN);
+    STATIC_REQUIRE(constexpr_table[2] == 12);
+    STATIC_REQUIRE(constexpr_table[3] == 255);
+    STATIC_REQUIRE(numeric_cast<double>(INT64_MAX) == 9223372036854775807.0);
+    STATIC_REQUIRE(numeric_cast<uint32_t>(int64_t(4000000000)) == 4000000000u);
+    STATIC_REQUIRE(to_integer<int8_t>(color::red) == 1);
+    STATIC_REQUIRE(to_unsigned<uint16_t>(color::green) == 2);
+    STATIC_REQUIRE(to_enum<color>(2) == color::green);
+    STATIC_REQUIRE(try_to_enum<color>(100000).error() == numeric_cast_errc::overflow);
+    STATIC_REQUIRE(is_numeric_convertible<int8_t>(127));
+    STATIC_REQUIRE(!is_numeric_convertible<int8_t>(128.0));
+    STATIC_REQUIRE(is_numeric_convertible<uint8_t>(color::red));
+    REQUIRE_THROWS_AS(to_enum<color>(100000), overflow_error);
+}
@@ -0,0 +1,59 @@
+/*
+These tests use a the Catch2 header only c++ test framework: https://github.com/catchorg/Catch2
+The global operator new is replaced to count the allocations, so this is a separate test executable
+*/
+
+#define CATCH_CONFIG_MAIN
+#include "../third-party/catch.h"
+
+#include "../numeric_cast.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+/// count of operator new calls, to test that throwing numeric_cast_error does not allocate
+static std::atomic<size_t> allocation_count(0);
+
+void* operator new(size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+/// not inlined, GCC takes `free()` of the pointer from a new-expression as a mismatch
+#if defined(__GNUC__)
+#define TEST_NOINLINE __attribute__((noinline))
+#else
+#define TEST_NOINLINE
+#endif
+
+TEST_NOINLINE void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+TEST_NOINLINE void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+TEST_CASE("throwing numeric_cast_error does not allocate", "[std::numeric_cast_error]")
+{
+    using namespace std;
+    const size_t before = allocation_count.load(std::memory_order_relaxed);
+    bool caught = false;
+    try
+    {
+        numeric_cast<int8_t>(300);
+    }
+    catch (const overflow_error&)
+    {
+        caught = true;
+    }
+    REQUIRE(caught);
+    REQUIRE(allocation_count.load(std::memory_order_relaxed) == before);
+}
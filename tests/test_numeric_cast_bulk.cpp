@@ -0,0 +1,592 @@
+/*
+These tests use a the Catch2 header only c++ test framework: https://github.com/catchorg/Catch2
+*/
+
+#include "../third-party/catch.h"
+
+#include "../numeric_cast_bulk.h"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/// the largest S value not above `limit`, INT32_MAX rounds up to 2^31 as float
+template <typename S>
+S largest_not_above(double limit)
+{
+    S v = static_cast<S>(limit);
+    return static_cast<double>(v) > limit ? static_cast<S>(std::nextafter(v, S(0))) : v;
+}
+
+/// fill the input with in-range values, covering both limits of the target type
+template <typename T, typename S>
+std::vector<S> make_in_range_input(size_t n)
+{
+    std::vector<S> in(n);
+    const double lo = static_cast<double>(std::numeric_limits<T>::min());
+    const double hi = static_cast<double>(std::numeric_limits<T>::max());
+    for (size_t i = 0; i < n; i++)
+    {
+        in[i] = largest_not_above<S>(lo + (hi - lo) * static_cast<double>(i % 97) / 96.0);
+    }
+    in[0] = static_cast<S>(std::numeric_limits<T>::min());
+    in[n - 1] = largest_not_above<S>(hi);
+    return in;
+}
+
+template <typename T, typename S>
+void check_bulk_cast(size_t n)
+{
+    std::vector<S> in = make_in_range_input<T, S>(n);
+    std::vector<T> out(n);
+    REQUIRE(std::numeric_cast_n<T>(in.data(), out.data(), n) == out.data() + n);
+    for (size_t i = 0; i < n; i++)
+    {
+        REQUIRE(out[i] == std::numeric_cast<T>(in[i]));
+    }
+
+    // the offending element may be in the SIMD body or in the scalar tail
+    const size_t bad_index[] = {n / 2, n - 1};
+    for (size_t b : bad_index)
+    {
+        std::vector<S> bad = in;
+        bad[b] = static_cast<S>(static_cast<double>(std::numeric_limits<T>::max()) * 2.0 + 2.0);
+        std::fill(out.begin(), out.end(), T(0));
+        REQUIRE_THROWS_AS(std::numeric_cast_n<T>(bad.data(), out.data(), n), std::overflow_error);
+        for (size_t i = 0; i < b; i++)
+        {
+            REQUIRE(out[i] == std::numeric_cast<T>(in[i]));
+        }
+
+        bad[b] = static_cast<S>(static_cast<double>(std::numeric_limits<T>::min()) * 2.0 - 2.0);
+        REQUIRE_THROWS_AS(std::numeric_cast_n<T>(bad.data(), out.data(), n), std::underflow_error);
+    }
+}
+
+TEST_CASE("std::numeric_cast_n bulk unit test", "[std::numeric_cast_n]")
+{
+    SECTION("type pairs with SIMD kernels")
+    {
+        // sizes are not multiple of the vector width, to test the scalar tail
+        for (size_t n : {1, 7, 17, 1000, 1003})
+        {
+            check_bulk_cast<int32_t, double>(n);
+            check_bulk_cast<int16_t, double>(n);
+            check_bulk_cast<int32_t, float>(n);
+            check_bulk_cast<int16_t, int32_t>(n);
+            check_bulk_cast<uint16_t, double>(n);
+            check_bulk_cast<uint16_t, int32_t>(n);
+        }
+    }
+
+    SECTION("type pairs without SIMD kernels")
+    {
+        check_bulk_cast<int8_t, int64_t>(1003);
+        check_bulk_cast<uint16_t, double>(1003);
+    }
+
+    SECTION("float boundary")
+    {
+        // 2^31 is the first float above INT32_MAX
+        std::vector<float> in(64, 2147483520.0f);
+        std::vector<int32_t> out(64);
+        std::numeric_cast_n<int32_t>(in.data(), out.data(), in.size());
+        REQUIRE(out[0] == 2147483520);
+        in[33] = 2147483648.0f;
+        REQUIRE_THROWS_AS(std::numeric_cast_n<int32_t>(in.data(), out.data(), in.size()), std::overflow_error);
+        REQUIRE(std::is_numeric_convertible_n<int32_t>(in.data(), in.size(), nullptr) == in.size() - 1);
+    }
+}
+
+template <typename T, typename S>
+void check_bulk_convertible(size_t n)
+{
+    std::vector<S> in = make_in_range_input<T, S>(n);
+    // every 5th element is out of range, on both sides
+    for (size_t i = 0; i < n; i += 5)
+    {
+        const double limit = i % 2 ? static_cast<double>(std::numeric_limits<T>::max())
+                                   : static_cast<double>(std::numeric_limits<T>::min());
+        in[i] = static_cast<S>(limit * 2.0 + (i % 2 ? 2.0 : -2.0));
+    }
+    std::vector<uint64_t> mask((n + 63) / 64, ~uint64_t(0));
+    const size_t count = std::is_numeric_convertible_n<T>(in.data(), n, mask.data());
+
+    size_t expected = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const bool bit = (mask[i / 64] >> (i % 64)) & 1;
+        REQUIRE(bit == std::is_numeric_convertible<T>(in[i]));
+        expected += bit;
+    }
+    REQUIRE(count == expected);
+    REQUIRE(std::is_numeric_convertible_n<T>(in.data(), n, nullptr) == count);
+}
+
+TEST_CASE("std::is_numeric_convertible_n bulk unit test", "[std::is_numeric_convertible_n]")
+{
+    for (size_t n : {1, 63, 64, 65, 1000})
+    {
+        check_bulk_convertible<int32_t, double>(n);
+        check_bulk_convertible<int16_t, double>(n);
+        check_bulk_convertible<int32_t, float>(n);
+        check_bulk_convertible<int16_t, int32_t>(n);
+        check_bulk_convertible<uint16_t, int32_t>(n);
+        check_bulk_convertible<uint8_t, int64_t>(n);
+    }
+
+    SECTION("NaN is not convertible")
+    {
+        std::vector<double> in(128, std::numeric_limits<double>::quiet_NaN());
+        uint64_t mask[2];
+        REQUIRE(std::is_numeric_convertible_n<int32_t>(in.data(), in.size(), mask) == 0);
+        REQUIRE(mask[0] == 0);
+        REQUIRE(mask[1] == 0);
+    }
+
+    SECTION("zero and negative values to float")
+    {
+        std::vector<double> in(100, -1.0);
+        in[0] = 0.0;
+        in[1] = -1.0e39;
+        in[2] = std::numeric_limits<double>::quiet_NaN();
+        in[3] = -std::numeric_limits<double>::infinity();
+        uint64_t mask[2];
+        REQUIRE(std::is_numeric_convertible_n<float>(in.data(), in.size(), mask) == in.size() - 1);
+        REQUIRE(mask[0] == ~uint64_t(2));
+        for (size_t i = 0; i < in.size(); i++)
+            REQUIRE(((mask[i / 64] >> (i % 64)) & 1) == std::is_numeric_convertible<float>(in[i]));
+    }
+}
+
+TEST_CASE("std::to_integer_n and std::to_unsigned_n", "[std::to_unsigned_n]")
+{
+    std::vector<double> in(100, 65535.0);
+    std::vector<uint16_t> out(in.size());
+    std::to_unsigned_n<uint16_t>(in.data(), out.data(), in.size());
+    REQUIRE(out[99] == 65535);
+    in[50] = -1.0;
+    REQUIRE_THROWS_AS(std::to_unsigned_n<uint16_t>(in.data(), out.data(), in.size()), std::underflow_error);
+
+    std::vector<int16_t> out16(in.size());
+    REQUIRE_THROWS_AS(std::to_integer_n<int16_t>(in.data(), out16.data(), in.size()), std::overflow_error);
+}
+
+/// in-range values with out-of-range values and NaN mixed in, in the SIMD body and in the tail
+template <typename T, typename S>
+std::vector<S> make_saturate_input(size_t n)
+{
+    std::vector<S> in = make_in_range_input<T, S>(n);
+    for (size_t i = 0; i < n; i += 3)
+    {
+        const double limit = i % 2 ? static_cast<double>(std::numeric_limits<T>::max())
+                                   : static_cast<double>(std::numeric_limits<T>::min());
+        in[i] = static_cast<S>(limit * 2.0 + (i % 2 ? 2.0 : -2.0));
+    }
+    if (std::numeric_limits<S>::has_quiet_NaN)
+    {
+        for (size_t i = 1; i < n; i += 7)
+            in[i] = std::numeric_limits<S>::quiet_NaN();
+    }
+    return in;
+}
+
+template <typename T, typename S>
+void check_bulk_saturate(size_t n)
+{
+    const std::vector<S> in = make_saturate_input<T, S>(n);
+    std::vector<T> out(n);
+    REQUIRE(std::saturate_cast_n<T>(in.data(), out.data(), n) == out.data() + n);
+    for (size_t i = 0; i < n; i++)
+    {
+        REQUIRE(out[i] == std::saturate_cast<T>(in[i]));
+    }
+    std::saturate_cast_n<T>(in.data(), out.data(), n, std::numeric_limits<T>::max());
+    for (size_t i = 0; i < n; i++)
+    {
+        REQUIRE(out[i] == std::saturate_cast<T>(in[i], std::numeric_limits<T>::max()));
+    }
+}
+
+TEST_CASE("std::saturate_cast_n bulk unit test", "[std::saturate_cast_n]")
+{
+    for (size_t n : {1, 7, 17, 1000, 1003})
+    {
+        check_bulk_saturate<int32_t, double>(n);
+        check_bulk_saturate<int16_t, double>(n);
+        check_bulk_saturate<uint16_t, double>(n);
+        check_bulk_saturate<int32_t, float>(n);
+        check_bulk_saturate<int16_t, int32_t>(n);
+        check_bulk_saturate<uint16_t, int32_t>(n);
+        check_bulk_saturate<int8_t, int64_t>(n);
+    }
+
+    SECTION("float boundary")
+    {
+        std::vector<float> in(64, 2147483648.0f);
+        in[1] = 2147483520.0f;
+        in[2] = -2147483648.0f;
+        in[3] = std::numeric_limits<float>::infinity();
+        std::vector<int32_t> out(64);
+        std::saturate_cast_n<int32_t>(in.data(), out.data(), in.size());
+        REQUIRE(out[0] == INT32_MAX);
+        REQUIRE(out[1] == 2147483520);
+        REQUIRE(out[2] == INT32_MIN);
+        REQUIRE(out[3] == INT32_MAX);
+    }
+}
+
+/// in-range values with fractions and ties, after any rounding
+template <typename T, typename S>
+std::vector<S> make_fraction_input(size_t n)
+{
+    const double fractions[] = {0.0, 0.5, -0.5, 0.25, -0.75, 0.7, 1.5, -1.5};
+    const double lo = static_cast<double>(std::numeric_limits<T>::min()) + 2.0;
+    const double hi = static_cast<double>(std::numeric_limits<T>::max()) - 2.0;
+    std::vector<S> in(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        const double v = lo + (hi - lo) * static_cast<double>(i % 97) / 96.0;
+        in[i] = largest_not_above<S>(std::floor(v) + fractions[i % 8]);
+    }
+    return in;
+}
+
+template <typename T, typename Round, typename S>
+void check_bulk_round(size_t n)
+{
+    std::vector<S> in = make_fraction_input<T, S>(n);
+    std::vector<T> out(n);
+    REQUIRE((std::numeric_cast_n<T, Round>(in.data(), out.data(), n)) == out.data() + n);
+    for (size_t i = 0; i < n; i++)
+    {
+        REQUIRE(out[i] == (std::numeric_cast<T, Round>(in[i])));
+    }
+
+    // out of range after rounding, for float to int32_t max() is rounded up to 2^31 already
+    in[n / 2] = static_cast<S>(std::numeric_limits<T>::max()) + S(0.75);
+    REQUIRE_THROWS_AS((std::numeric_cast_n<T, std::round_policy::ceil>(in.data(), out.data(), n)), std::overflow_error);
+}
+
+template <typename T, typename S>
+void check_bulk_round(size_t n)
+{
+    check_bulk_round<T, std::round_policy::truncate, S>(n);
+    check_bulk_round<T, std::round_policy::nearest_even, S>(n);
+    check_bulk_round<T, std::round_policy::floor, S>(n);
+    check_bulk_round<T, std::round_policy::ceil, S>(n);
+    check_bulk_round<T, std::round_policy::nearest_away, S>(n);
+}
+
+template <typename T, typename S>
+void check_bulk_nan(size_t n)
+{
+    std::vector<S> in = make_in_range_input<T, S>(n);
+    std::vector<T> out(n);
+    for (size_t i = 3; i < n; i += 11)
+        in[i] = std::numeric_limits<S>::quiet_NaN();
+    std::vector<uint64_t> mask((n + 63) / 64);
+    REQUIRE(std::is_nan_n(in.data(), n, mask.data()) == (n + 7) / 11);
+    for (size_t i = 0; i < n; i++)
+    {
+        REQUIRE(((mask[i / 64] >> (i % 64)) & 1) == (i % 11 == 3 ? 1u : 0u));
+    }
+
+    REQUIRE_THROWS_AS(std::numeric_cast_n<T>(in.data(), out.data(), n), std::range_error);
+    REQUIRE((std::numeric_cast_n<T, std::nan_policy::to_zero>(in.data(), out.data(), n)) == out.data() + n);
+    for (size_t i = 0; i < n; i++)
+    {
+        REQUIRE(out[i] == (i % 11 == 3 ? T(0) : std::numeric_cast<T>(in[i])));
+    }
+    REQUIRE((std::numeric_cast_n<T, std::nan_policy::to_lowest>(in.data(), out.data(), n)) == out.data() + n);
+    REQUIRE(out[3] == std::numeric_limits<T>::lowest());
+
+    // NaN is mapped, out-of-range value still throws
+    in[n - 1] = std::numeric_limits<S>::infinity();
+    REQUIRE_THROWS_AS((std::numeric_cast_n<T, std::nan_policy::to_zero>(in.data(), out.data(), n)), std::overflow_error);
+}
+
+TEST_CASE("std::is_nan_n and std::numeric_cast_n with NaN policy", "[std::numeric_cast_n]")
+{
+    for (size_t n : {17, 64, 1000, 1003})
+    {
+        check_bulk_nan<int32_t, double>(n);
+        check_bulk_nan<int16_t, double>(n);
+        check_bulk_nan<int32_t, float>(n);
+        check_bulk_nan<int8_t, double>(n);
+    }
+
+    std::vector<int32_t> ints(100, 7);
+    REQUIRE(std::is_nan_n(ints.data(), ints.size(), nullptr) == 0);
+}
+
+TEST_CASE("std::numeric_cast_n with rounding policy", "[std::numeric_cast_n]")
+{
+    using namespace std;
+    for (size_t n : {1, 7, 17, 1000, 1003})
+    {
+        check_bulk_round<int32_t, double>(n);
+        check_bulk_round<int16_t, double>(n);
+        check_bulk_round<uint16_t, double>(n);
+        check_bulk_round<int32_t, float>(n);
+        check_bulk_round<int8_t, float>(n);
+    }
+
+    std::vector<int32_t> in(100, -7), out(100);
+    std::numeric_cast_n<int32_t, round_policy::floor>(in.data(), out.data(), in.size());
+    REQUIRE(out == in);
+}
+
+/// values around the limits of both 32-bit types, where a mixed-sign compare is wrong
+template <typename T>
+std::vector<T> make_cmp_input(size_t n, unsigned seed)
+{
+    const int64_t edges[] = {INT32_MIN, INT32_MIN + 1, -2, -1, 0, 1, 2, INT32_MAX - 1, INT32_MAX,
+                             int64_t(INT32_MAX) + 1, int64_t(UINT32_MAX) - 1, UINT32_MAX};
+    std::vector<T> v(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        v[i] = static_cast<T>(edges[(i * seed + i / 12) % 12]);
+    }
+    return v;
+}
+
+template <typename A, typename B>
+void check_bulk_cmp(size_t n)
+{
+    const std::vector<A> a = make_cmp_input<A>(n, 5);
+    const std::vector<B> b = make_cmp_input<B>(n, 7);
+    std::vector<uint64_t> mask((n + 63) / 64, ~uint64_t(0));
+
+    size_t count = std::cmp_less_n(a.data(), b.data(), n, mask.data());
+    size_t expected = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const bool less = std::detail::cmp_less(a[i], b[i]);
+        REQUIRE(((mask[i / 64] >> (i % 64)) & 1) == less);
+        expected += less;
+    }
+    REQUIRE(count == expected);
+    REQUIRE(std::cmp_greater_equal_n(a.data(), b.data(), n, mask.data()) == n - expected);
+    for (size_t i = 0; i < n; i++)
+    {
+        REQUIRE(((mask[i / 64] >> (i % 64)) & 1) == !std::detail::cmp_less(a[i], b[i]));
+    }
+    // the bits past n are clear
+    if (n % 64)
+    {
+        REQUIRE((mask.back() >> (n % 64)) == 0);
+    }
+
+    count = std::cmp_equal_n(a.data(), b.data(), n, mask.data());
+    expected = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const bool equal = std::detail::cmp_equal(a[i], b[i]);
+        REQUIRE(((mask[i / 64] >> (i % 64)) & 1) == equal);
+        expected += equal;
+    }
+    REQUIRE(count == expected);
+    REQUIRE(std::cmp_not_equal_n(a.data(), b.data(), n, nullptr) == n - expected);
+    REQUIRE(std::cmp_greater_n(a.data(), b.data(), n, nullptr) == std::cmp_less_n(b.data(), a.data(), n, nullptr));
+    REQUIRE(std::cmp_less_equal_n(a.data(), b.data(), n, nullptr) == n - std::cmp_greater_n(a.data(), b.data(), n, nullptr));
+}
+
+TEST_CASE("std::cmp_less_n of mixed-sign arrays", "[std::cmp_less_n]")
+{
+    for (size_t n : {1, 17, 64, 1000, 1003})
+    {
+        check_bulk_cmp<int32_t, int32_t>(n);
+        check_bulk_cmp<uint32_t, uint32_t>(n);
+        check_bulk_cmp<int32_t, uint32_t>(n);
+        check_bulk_cmp<uint32_t, int32_t>(n);
+        check_bulk_cmp<int64_t, uint32_t>(n);
+        check_bulk_cmp<uint16_t, int64_t>(n);
+    }
+}
+
+#if NUMERIC_CAST_DISPATCH
+/// every kernel this CPU can run must agree with the portable one
+template <typename T, typename S>
+void check_simd_kernels(const std::vector<S>& in)
+{
+    using namespace std::detail;
+    typedef bulk_simd_kernel<T, S> kernel;
+    typename kernel::cast_fn cast_fns[] = {simd_sse2::cast_n, simd_avx2::cast_n, simd_avx512::cast_n};
+    typename kernel::bits_fn bits_fns[] = {simd_sse2::in_range_bits, simd_avx2::in_range_bits,
+                                           simd_avx512::in_range_bits};
+    const simd_level levels[] = {simd_level::sse2, simd_level::avx2, simd_level::avx512};
+
+    const size_t n = in.size();
+    std::vector<T> expected(n), out(n);
+    const bool expected_ok = bulk_cast_generic<T, S>(in.data(), expected.data(), n);
+    for (int l = 0; l < 3 && levels[l] <= cpu_simd_level(); l++)
+    {
+        REQUIRE(cast_fns[l](in.data(), out.data(), n) == expected_ok);
+        for (size_t i = 0; i < n; i++)
+        {
+            if (convertible<T, S>(in[i]))
+                REQUIRE(out[i] == expected[i]);
+        }
+        for (size_t i = 0; i + 64 <= n; i += 64)
+        {
+            REQUIRE(bits_fns[l](in.data() + i, bulk_bounds<T, S>::lo(), bulk_bounds<T, S>::hi())
+                == convertible_bits_generic<T, S>(in.data() + i, 64));
+        }
+    }
+}
+
+template <typename T, typename S>
+void check_simd_saturate_kernels()
+{
+    using namespace std::detail;
+    typedef bulk_simd_kernel<T, S> kernel;
+    typename kernel::saturate_fn saturate_fns[] = {simd_sse2::saturate_n, simd_avx2::saturate_n,
+                                                   simd_avx512::saturate_n};
+    const simd_level levels[] = {simd_level::sse2, simd_level::avx2, simd_level::avx512};
+
+    const std::vector<S> in = make_saturate_input<T, S>(1000);
+    std::vector<T> expected(in.size()), out(in.size());
+    saturate_generic<T, S>(in.data(), expected.data(), in.size(), T(3));
+    for (int l = 0; l < 3 && levels[l] <= cpu_simd_level(); l++)
+    {
+        saturate_fns[l](in.data(), out.data(), in.size(), T(3));
+        REQUIRE(out == expected);
+    }
+}
+
+template <typename T, typename S>
+void check_simd_kernels()
+{
+    std::vector<S> in = make_in_range_input<T, S>(1000);
+    check_simd_kernels<T, S>(in);
+    in[333] = static_cast<S>(static_cast<double>(std::numeric_limits<T>::max()) * 2.0 + 2.0);
+    in[555] = static_cast<S>(static_cast<double>(std::numeric_limits<T>::min()) * 2.0 - 2.0);
+    check_simd_kernels<T, S>(in);
+}
+
+/// special values of the rounding, the SIMD kernels must agree with the scalar policy
+template <typename S>
+std::vector<S> make_round_input()
+{
+    const S big = S(1) / std::numeric_limits<S>::epsilon();  // 2^52 for double
+    std::vector<S> in = {S(0.5), S(-0.5), S(1.5), S(-1.5), S(2.5), S(-2.5), S(0.49999997f), S(-0.0),
+                         S(0.0), S(-0.3), S(0.3), big - S(0.5), -(big - S(0.5)), big, big + S(1), -big - S(1),
+                         S(1e30f), S(-1e30f), std::numeric_limits<S>::infinity(),
+                         -std::numeric_limits<S>::infinity(), std::numeric_limits<S>::quiet_NaN(),
+                         std::nextafter(S(0.5), S(0)), -std::nextafter(S(0.5), S(0)), S(123456.5), S(-7.75)};
+    const size_t m = in.size();
+    for (size_t i = 0; i < 3 * m; i++)
+        in.push_back(in[i % m] * S(3) + S(0.5));
+    return in;
+}
+
+template <typename S, typename Round>
+void check_simd_round_kernels()
+{
+    using namespace std::detail;
+    typedef typename bulk_simd_round_kernel<S, Round>::round_fn round_fn;
+    const round_fn round_fns[] = {simd_sse2::round_n<Round>, simd_avx2::round_n<Round>,
+                                  simd_avx512::round_n<Round>};
+    const simd_level levels[] = {simd_level::sse2, simd_level::avx2, simd_level::avx512};
+
+    const std::vector<S> in = make_round_input<S>();
+    std::vector<S> expected(in.size()), out(in.size());
+    round_generic<Round, S>(in.data(), expected.data(), in.size());
+    for (int l = 0; l < 3 && levels[l] <= cpu_simd_level(); l++)
+    {
+        round_fns[l](in.data(), out.data(), in.size());
+        for (size_t i = 0; i < in.size(); i++)
+        {
+            INFO("input " << in[i] << " level " << l);
+            REQUIRE(((out[i] == expected[i]) || (std::isnan(out[i]) && std::isnan(expected[i]))));
+        }
+    }
+}
+
+template <typename S>
+void check_simd_round_kernels()
+{
+    check_simd_round_kernels<S, std::round_policy::truncate>();
+    check_simd_round_kernels<S, std::round_policy::nearest_even>();
+    check_simd_round_kernels<S, std::round_policy::floor>();
+    check_simd_round_kernels<S, std::round_policy::ceil>();
+    check_simd_round_kernels<S, std::round_policy::nearest_away>();
+}
+
+template <typename S>
+void check_simd_nan_kernels()
+{
+    using namespace std::detail;
+    typedef typename bulk_simd_nan_kernel<S>::nan_bits_fn nan_bits_fn;
+    const nan_bits_fn nan_fns[] = {simd_sse2::nan_bits, simd_avx2::nan_bits, simd_avx512::nan_bits};
+    const simd_level levels[] = {simd_level::sse2, simd_level::avx2, simd_level::avx512};
+
+    std::vector<S> in = make_round_input<S>();
+    in.resize(64 * (in.size() / 64));
+    for (size_t i = 0; i < in.size(); i += 7)
+        in[i] = -std::numeric_limits<S>::quiet_NaN();
+    for (int l = 0; l < 3 && levels[l] <= cpu_simd_level(); l++)
+    {
+        for (size_t i = 0; i < in.size(); i += 64)
+        {
+            REQUIRE(nan_fns[l](in.data() + i) == nan_bits_generic<S>(in.data() + i, 64));
+        }
+    }
+}
+
+template <typename Comparison, typename A, typename B>
+void check_simd_cmp_kernels()
+{
+    using namespace std::detail;
+    typedef uint64_t (*cmp_bits_fn)(const A*, const B*);
+    const cmp_bits_fn cmp_fns[] = {simd_sse2::cmp_bits<Comparison, A, B>, simd_avx2::cmp_bits<Comparison, A, B>,
+                                   simd_avx512::cmp_bits<Comparison, A, B>};
+    const simd_level levels[] = {simd_level::sse2, simd_level::avx2, simd_level::avx512};
+
+    const std::vector<A> a = make_cmp_input<A>(64 * 12, 5);
+    const std::vector<B> b = make_cmp_input<B>(64 * 12, 7);
+    for (int l = 0; l < 3 && levels[l] <= cpu_simd_level(); l++)
+    {
+        for (size_t i = 0; i < a.size(); i += 64)
+        {
+            REQUIRE(cmp_fns[l](a.data() + i, b.data() + i) == cmp_bits_generic<Comparison>(a.data() + i, b.data() + i, 64));
+        }
+    }
+}
+
+template <typename A, typename B>
+void check_simd_cmp_kernels()
+{
+    check_simd_cmp_kernels<std::detail::less_comparison, A, B>();
+    check_simd_cmp_kernels<std::detail::equal_comparison, A, B>();
+}
+
+TEST_CASE("SIMD kernels of all instruction sets", "[std::numeric_cast_n]")
+{
+    check_simd_cmp_kernels<int32_t, int32_t>();
+    check_simd_cmp_kernels<uint32_t, uint32_t>();
+    check_simd_cmp_kernels<int32_t, uint32_t>();
+    check_simd_cmp_kernels<uint32_t, int32_t>();
+
+    check_simd_nan_kernels<double>();
+    check_simd_nan_kernels<float>();
+
+    check_simd_round_kernels<double>();
+    check_simd_round_kernels<float>();
+
+    check_simd_kernels<int32_t, double>();
+    check_simd_kernels<int16_t, double>();
+    check_simd_kernels<uint16_t, double>();
+    check_simd_kernels<int32_t, float>();
+    check_simd_kernels<int16_t, int32_t>();
+    check_simd_kernels<uint16_t, int32_t>();
+
+    check_simd_saturate_kernels<int32_t, double>();
+    check_simd_saturate_kernels<int16_t, double>();
+    check_simd_saturate_kernels<uint16_t, double>();
+    check_simd_saturate_kernels<int32_t, float>();
+    check_simd_saturate_kernels<int16_t, int32_t>();
+    check_simd_saturate_kernels<uint16_t, int32_t>();
+}
+#endif
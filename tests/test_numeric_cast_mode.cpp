@@ -0,0 +1,89 @@
+/*
+These tests use a the Catch2 header only c++ test framework: https://github.com/catchorg/Catch2
+NUMERIC_CAST_MODE must be the same for the whole program, so this is a separate test executable,
+compiled with NUMERIC_CAST_MODE_SAMPLED and NUMERIC_CAST_MODE_SAMPLING=4.
+Only the sampled calls are given an out-of-range value, the others would be undefined behaviour
+*/
+
+#define CATCH_CONFIG_MAIN
+#include "../third-party/catch.h"
+
+#include "../numeric_cast.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+enum class level : uint8_t { low = 1, high = 200 };
+
+/// run in a new thread, whose countdown starts again, the first call is sampled
+template <typename F>
+static void in_new_thread(F f)
+{
+    std::thread t(f);
+    t.join();
+}
+
+static bool throws_overflow(int (*f)())
+{
+    try
+    {
+        f();
+    }
+    catch (const std::overflow_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+TEST_CASE("NUMERIC_CAST_MODE_SAMPLED checks 1 in N calls", "[numeric_cast_mode]")
+{
+    REQUIRE(NUMERIC_CAST_MODE == NUMERIC_CAST_MODE_SAMPLED);
+
+    SECTION("constant expression is always checked")
+    {
+        constexpr int8_t a = std::numeric_cast<int8_t>(100);
+        constexpr uint8_t b = std::to_unsigned<uint8_t>(200);
+        static_assert(a == 100 && b == 200, "constexpr conversion");
+    }
+
+    SECTION("numeric_cast")
+    {
+        bool first = false;
+        bool fifth = false;
+        int sum = 0;
+        in_new_thread([&] {
+            first = throws_overflow([] { return int(std::numeric_cast<int8_t>(1000)); });
+            for (int i = 0; i < 3; ++i)
+                sum += std::numeric_cast<int8_t>(10 * i);
+            fifth = throws_overflow([] { return int(std::numeric_cast<int8_t>(1000.0)); });
+        });
+        CHECK(first);
+        CHECK(sum == 30);
+        CHECK(fifth);
+    }
+
+    SECTION("to_integer and to_unsigned")
+    {
+        bool first = false;
+        bool fifth = false;
+        unsigned sum = 0;
+        in_new_thread([&] {
+            first = throws_overflow([] { return int(std::to_unsigned<uint8_t>(300)); });
+            sum += std::to_unsigned<uint8_t>(1);
+            sum += std::to_integer<int16_t>(2.0);
+            sum += std::to_integer<int>(level::high);
+            fifth = throws_overflow([] { return int(std::to_integer<int8_t>(level::high)); });
+        });
+        CHECK(first);
+        CHECK(sum == 203);
+        CHECK(fifth);
+    }
+
+    SECTION("try_numeric_cast is not sampled")
+    {
+        for (int i = 0; i < 8; ++i)
+            CHECK(std::try_numeric_cast<int8_t>(1000 + i).error() == std::numeric_cast_errc::overflow);
+    }
+}
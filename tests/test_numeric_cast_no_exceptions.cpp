@@ -0,0 +1,127 @@
+/*
+These tests use a the Catch2 header only c++ test framework: https://github.com/catchorg/Catch2
+compiled with -fno-exceptions, a failure is passed to the failure handler instead of throwing
+*/
+
+#define CATCH_CONFIG_MAIN
+#include "../third-party/catch.h"
+
+#include "../numeric_cast_bulk.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+static_assert(NUMERIC_CAST_NO_EXCEPTIONS, "this test must be compiled without exception support");
+
+namespace {
+
+    struct recorded_failure
+    {
+        std::numeric_cast_errc kind;
+        std::string source_type;
+        std::string target_type;
+        std::string value;
+        std::string message;
+        unsigned line;
+    };
+
+    std::vector<recorded_failure> failures;
+
+    void record(const std::numeric_cast_failure_info& f)
+    {
+        failures.push_back(recorded_failure{f.kind(), f.source_type(), f.target_type(), f.value(),
+                                            f.message(), f.line()});
+    }
+
+    /// install `record` for the scope of a test
+    struct recording
+    {
+        std::numeric_cast_failure_handler previous;
+
+        recording()
+            : previous(std::set_numeric_cast_failure_handler(record))
+        {
+            failures.clear();
+        }
+
+        ~recording()
+        {
+            std::set_numeric_cast_failure_handler(previous);
+        }
+    };
+}
+
+TEST_CASE("failure handler without exceptions", "[std::numeric_cast]")
+{
+    recording scope;
+    REQUIRE(std::get_numeric_cast_failure_handler() == &record);
+
+    SECTION("the fallback is the nearest limit")
+    {
+        CHECK(std::numeric_cast<int8_t>(1000) == INT8_MAX);
+        CHECK(std::numeric_cast<int16_t>(-1e10) == INT16_MIN);
+        CHECK(std::to_unsigned<uint32_t>(-1) == 0u);
+        CHECK(std::to_integer<int32_t>(std::nan("")) == 0);
+        REQUIRE(failures.size() == 4);
+        CHECK(failures[0].kind == std::numeric_cast_errc::overflow);
+        CHECK(failures[0].source_type == "int");
+        CHECK(failures[0].target_type == "signed char");
+        CHECK(failures[0].value == "1000");
+        CHECK(failures[0].message == "numeric_cast: int 1000 overflows signed char");
+        CHECK(failures[1].kind == std::numeric_cast_errc::underflow);
+        CHECK(failures[2].kind == std::numeric_cast_errc::underflow);
+        CHECK(failures[3].kind == std::numeric_cast_errc::nan);
+    }
+
+    SECTION("in range value does not call the handler")
+    {
+        CHECK(std::numeric_cast<int8_t>(100) == 100);
+        CHECK(std::try_numeric_cast<int8_t>(1000).error() == std::numeric_cast_errc::overflow);
+        CHECK(failures.empty());
+    }
+
+    SECTION("result value and enum")
+    {
+        enum class small : int8_t { a };
+        CHECK(std::try_numeric_cast<uint8_t>(300).value() == UINT8_MAX);
+        CHECK(static_cast<int>(std::to_enum<small>(-300)) == INT8_MIN);
+        REQUIRE(failures.size() == 2);
+        CHECK(failures[0].source_type.empty());
+        CHECK(failures[1].kind == std::numeric_cast_errc::underflow);
+    }
+
+    SECTION("bulk conversion reports the first failure of the block")
+    {
+        const double in[] = {1.0, 1e10, -1.0};
+        int32_t out[3] = {};
+        std::numeric_cast_n<int32_t>(in, out, 3);
+        CHECK(out[1] == INT32_MAX);
+        REQUIRE(failures.size() == 1);
+        CHECK(failures[0].value == "10000000000");
+    }
+
+#if NUMERIC_CAST_HAS_SOURCE_LOCATION
+    SECTION("the location of the call")
+    {
+        const unsigned line = __LINE__ + 1;
+        CHECK(std::numeric_cast<uint8_t>(-1) == 0);
+        REQUIRE(failures.size() == 1);
+        CHECK(failures[0].line == line);
+    }
+#endif
+}
+
+TEST_CASE("overflow_policy::report", "[std::numeric_cast]")
+{
+    recording scope;
+    CHECK(std::numeric_cast<int8_t, std::overflow_policy::report>(1000.0) == INT8_MAX);
+    CHECK(std::to_unsigned<uint8_t, std::overflow_policy::report>(-5) == 0);
+    CHECK(std::numeric_cast<int8_t, std::overflow_policy::report>(std::nan("")) == 0);
+    REQUIRE(failures.size() == 3);
+    CHECK(failures[0].kind == std::numeric_cast_errc::overflow);
+    CHECK(failures[1].kind == std::numeric_cast_errc::underflow);
+    CHECK(failures[2].kind == std::numeric_cast_errc::nan);
+}
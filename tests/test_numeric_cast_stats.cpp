@@ -0,0 +1,196 @@
+/*
+These tests use a the Catch2 header only c++ test framework: https://github.com/catchorg/Catch2
+NUMERIC_CAST_STATS must be defined for the whole program, so this is a separate test executable,
+compiled with NUMERIC_CAST_HEADROOM_SAMPLING=4
+*/
+
+#define CATCH_CONFIG_MAIN
+#include "../third-party/catch.h"
+
+#include "../numeric_cast_stats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::numeric_cast_stats::entry find_stats(const char* source, const char* target)
+{
+    for (const auto& e : std::numeric_cast_stats::snapshot())
+        if (std::string(e.source) == source && std::string(e.target) == target)
+            return e;
+    return std::numeric_cast_stats::entry{source, target, 0, 0, 0, 0};
+}
+
+enum stats_first_enum { first_value = 1 };
+enum stats_second_enum { second_value = 200 };
+
+TEST_CASE("numeric_cast_stats counts per type pair", "[numeric_cast_stats]")
+{
+    REQUIRE(std::numeric_cast_stats::enabled());
+    std::numeric_cast_stats::reset();
+
+    SECTION("calls and errors")
+    {
+        REQUIRE(std::numeric_cast<int8_t>(100) == 100);
+        REQUIRE_THROWS_AS(std::numeric_cast<int8_t>(1000), std::overflow_error);
+        REQUIRE_FALSE(std::try_numeric_cast<int8_t>(-1000));
+        REQUIRE_FALSE(std::try_numeric_cast<int16_t>(std::nan("")));
+        REQUIRE(std::to_unsigned<uint16_t>(1) == 1u);
+
+        const auto to_int8 = find_stats("int", "signed char");
+        CHECK(to_int8.calls == 3);
+        CHECK(to_int8.overflows == 1);
+        CHECK(to_int8.underflows == 1);
+        CHECK(to_int8.nans == 0);
+        CHECK(find_stats("double", "short").nans == 1);
+        CHECK(find_stats("int", "unsigned short").calls == 1);
+        // lossless, a bare static_cast
+        REQUIRE(std::numeric_cast<int64_t>(1) == 1);
+        CHECK(find_stats("int", std::numeric_type_name<int64_t>::name()).calls == 0);
+    }
+
+    SECTION("constant expression is not counted")
+    {
+        constexpr int16_t c = std::numeric_cast<int16_t>(1000);
+        REQUIRE(c == 1000);
+        CHECK(find_stats("int", "short").calls == 0);
+    }
+
+    SECTION("the counts of exited threads are kept")
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++)
+            threads.emplace_back([] {
+                for (int i = 0; i < 1000; i++)
+                    static_cast<void>(std::try_numeric_cast<uint8_t>(i));
+            });
+        for (auto& t : threads)
+            t.join();
+        const auto to_uint8 = find_stats("int", "unsigned char");
+        CHECK(to_uint8.calls == 4000);
+        CHECK(to_uint8.overflows == 4 * (1000 - 256));
+    }
+
+    SECTION("pairs of two enums have different names")
+    {
+        static_cast<void>(std::try_numeric_cast<int8_t>(first_value));
+        static_cast<void>(std::try_numeric_cast<int8_t>(second_value));
+        static_cast<void>(std::try_numeric_cast<int8_t>(second_value));
+        std::vector<std::string> names;
+        for (const auto& e : std::numeric_cast_stats::snapshot())
+        {
+            const std::string name = std::string(e.source) + "->" + e.target;
+            CHECK(std::find(names.begin(), names.end(), name) == names.end());
+            names.push_back(name);
+        }
+        CHECK(find_stats("stats_first_enum", "signed char").calls == 1);
+        CHECK(find_stats("stats_second_enum", "signed char").overflows == 2);
+        const std::string text = std::numeric_cast_stats::to_prometheus(std::numeric_cast_stats::snapshot());
+        CHECK(text.find("numeric_cast_calls_total{source=\"stats_second_enum\",target=\"signed char\"} 2\n")
+              != std::string::npos);
+    }
+
+    SECTION("reset")
+    {
+        static_cast<void>(std::try_numeric_cast<int8_t>(1));
+        std::numeric_cast_stats::reset();
+        CHECK(find_stats("int", "signed char").calls == 0);
+        static_cast<void>(std::try_numeric_cast<int8_t>(1));
+        CHECK(find_stats("int", "signed char").calls == 1);
+    }
+}
+
+static std::numeric_cast_stats::headroom_entry find_headroom(const char* source, const char* target)
+{
+    for (const auto& e : std::numeric_cast_stats::headroom_snapshot())
+        if (std::string(e.source) == source && std::string(e.target) == target)
+            return e;
+    return std::numeric_cast_stats::headroom_entry{source, target, {}};
+}
+
+TEST_CASE("numeric_cast_stats headroom histogram", "[numeric_cast_stats]")
+{
+    REQUIRE(std::numeric_cast_stats::headroom_sampling() == 4);
+    std::numeric_cast_stats::reset();
+
+    SECTION("1 in N conversions of each thread is sampled")
+    {
+        // a new thread, its countdown starts from N
+        std::thread([] {
+            const int64_t values[] = {INT32_MAX / 10 * 9, -(int64_t(1) << 29), int64_t(1) << 20, 0};
+            for (const int64_t v : values)
+                for (int i = 0; i < 4 * 10; i++)
+                    static_cast<void>(std::numeric_cast<int32_t>(v));
+            // out of range is not sampled
+            for (int i = 0; i < 4 * 10; i++)
+                static_cast<void>(std::try_numeric_cast<int32_t>(int64_t(1) << 40));
+        }).join();
+        const auto h = find_headroom(std::numeric_type_name<int64_t>::name(), "int");
+        CHECK(h.buckets[0] == 10);   // 90% of INT32_MAX
+        CHECK(h.buckets[2] == 10);   // 2^31 / 2^29, a quarter of INT32_MIN
+        CHECK(h.buckets[10] == 10);  // (2^31 - 1) / 2^20 is below 2^11
+        CHECK(h.buckets[63] == 10);  // zero
+        uint64_t samples = 0;
+        for (const uint64_t b : h.buckets)
+            samples += b;
+        CHECK(samples == 40);
+    }
+
+    SECTION("headroom of floating point value and unsigned target")
+    {
+        std::thread([] {
+            for (int i = 0; i < 4; i++)
+                static_cast<void>(std::numeric_cast<uint8_t>(200.0));
+            for (int i = 0; i < 4; i++)
+                static_cast<void>(std::numeric_cast<uint8_t>(1.0));
+        }).join();
+        const auto h = find_headroom("double", "unsigned char");
+        CHECK(h.buckets[0] == 1);
+        CHECK(h.buckets[7] == 1);  // 255 / 1
+    }
+
+    SECTION("reset clears the histograms")
+    {
+        std::thread([] {
+            for (int i = 0; i < 4; i++)
+                static_cast<void>(std::numeric_cast<int16_t>(1000));
+        }).join();
+        CHECK(find_headroom("int", "short").buckets[5] == 1);
+        std::numeric_cast_stats::reset();
+        CHECK(std::numeric_cast_stats::headroom_snapshot().empty());
+    }
+}
+
+TEST_CASE("numeric_cast_stats output formats", "[numeric_cast_stats]")
+{
+    const std::vector<std::numeric_cast_stats::entry> entries = {{"double", "int", 5, 1, 2, 0}};
+    const std::string json = std::numeric_cast_stats::to_json(entries);
+    CHECK(json == "{\"numeric_cast_stats\": [\n  {\"source\": \"double\", \"target\": \"int\", \"calls\": 5, "
+                  "\"overflows\": 1, \"underflows\": 2, \"nans\": 0}\n]}\n");
+    CHECK(std::numeric_cast_stats::to_json(std::vector<std::numeric_cast_stats::entry>()) == "{\"numeric_cast_stats\": []}\n");
+
+    const std::string text = std::numeric_cast_stats::to_prometheus(entries);
+    CHECK(text.find("# TYPE numeric_cast_calls_total counter\n") != std::string::npos);
+    CHECK(text.find("numeric_cast_calls_total{source=\"double\",target=\"int\"} 5\n") != std::string::npos);
+    CHECK(text.find("numeric_cast_errors_total{source=\"double\",target=\"int\",error=\"underflow\"} 2\n")
+          != std::string::npos);
+
+    const std::string int64_name = std::numeric_type_name<int64_t>::name();
+    std::numeric_cast_stats::headroom_entry h = {int64_name.c_str(), "int", {}};
+    h.buckets[0] = 3;
+    h.buckets[2] = 1;
+    const std::vector<std::numeric_cast_stats::headroom_entry> histograms = {h};
+    const std::string headroom_json = std::numeric_cast_stats::to_json(histograms);
+    CHECK(headroom_json.find("{\"source\": \"" + int64_name + "\", \"target\": \"int\", \"buckets\": [3, 0, 1, 0,")
+          != std::string::npos);
+    const std::string histogram = std::numeric_cast_stats::to_prometheus(histograms);
+    const std::string labels = "{source=\"" + int64_name + "\",target=\"int\"";
+    CHECK(histogram.find("# TYPE numeric_cast_headroom_bits histogram\n") != std::string::npos);
+    CHECK(histogram.find("numeric_cast_headroom_bits_bucket" + labels + ",le=\"1\"} 3\n") != std::string::npos);
+    CHECK(histogram.find("numeric_cast_headroom_bits_bucket" + labels + ",le=\"3\"} 4\n") != std::string::npos);
+    CHECK(histogram.find("numeric_cast_headroom_bits_sum" + labels + "} 2\n") != std::string::npos);
+    CHECK(histogram.find("numeric_cast_headroom_bits_count" + labels + "} 4\n") != std::string::npos);
+}